@@ -0,0 +1,108 @@
+#pragma once
+#include <onpair/analytics/row_hash.h>
+#include <onpair/column/column_view.h>
+#include <onpair/core/row_filter.h>
+#include <onpair/core/validity.h>
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace onpair::analytics {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// group_rows — hash aggregation over compressed rows (GROUP BY / DISTINCT)
+// ─────────────────────────────────────────────────────────────────────────────
+// Groups rows by string value without decompressing them:
+//
+//   1. hash_rows() computes one 64-bit token-sequence hash per row.
+//   2. A hash table maps each hash to the first group seen with it; groups
+//      sharing a hash are chained through `next`.
+//   3. A row joins a group only after a token-by-token comparison confirms its
+//      sequence, so hash collisions never merge distinct values.
+//
+// Group ids are dense and assigned in order of first appearance.  NULL and
+// deleted rows join no group (group_of = NO_GROUP); SQL's single NULL group
+// is `null_count` rows, for the caller to emit, and deleted rows count
+// nowhere.  Only the representatives need decoding to materialise the group
+// keys:
+//
+//   auto g = analytics::group_rows(view);
+//   for (size_t k = 0; k < g.num_groups(); ++k)
+//       len = view.decompress(g.representative[k], buf);
+
+inline constexpr uint32_t NO_GROUP = UINT32_MAX;
+
+struct Groups {
+    std::vector<uint32_t> group_of;        // per row: dense group id or NO_GROUP
+    std::vector<size_t>   representative;  // per group: first row
+    std::vector<uint64_t> count;           // per group: number of rows
+    std::vector<uint64_t> hash;            // per group: token-sequence hash
+    uint64_t              null_count = 0;  // NULL rows not deleted, in no group
+
+    size_t num_groups() const noexcept { return representative.size(); }
+};
+
+inline Groups group_rows(const OnPairColumnView& view) {
+    const size_t n = view.num_strings();
+    Groups g;
+    g.group_of.assign(n, NO_GROUP);
+
+    std::vector<uint64_t> hashes(n);
+    hash_rows(view, hashes.data());
+
+    const RowFilter filter = detail::row_filter(view);
+    if (const uint64_t* valid = view.validity()) {
+        const RowFilter live{nullptr, view.deletions()};
+        for (size_t w = 0; w < validity_words(n); ++w)
+            g.null_count += uint64_t(std::popcount(live.word(w, n) & ~valid[w]));
+    }
+
+    boost::unordered_flat_map<uint64_t, uint32_t> first;   // hash → group
+    std::vector<uint32_t> next;                            // collision chain
+
+    const auto sv = view.store();
+    dispatch_bits(sv.bits(), [&](auto bits) {
+        const auto* packed = sv.packed_data();
+        auto same = [&](size_t a, size_t b) {
+            return detail::spans_equal<bits.value>(
+                packed, sv.string_span(a), sv.string_span(b));
+        };
+
+        for_each_passing(filter, n, [&](size_t i) {
+            const uint64_t h = hashes[i];
+            auto [it, inserted] = first.try_emplace(h, uint32_t(g.num_groups()));
+
+            uint32_t id = NO_GROUP;
+            if (!inserted) {
+                uint32_t k = it->second;
+                for (;;) {
+                    if (same(g.representative[k], i)) { id = k; break; }
+                    if (next[k] == NO_GROUP) break;
+                    k = next[k];
+                }
+                if (id == NO_GROUP) next[k] = uint32_t(g.num_groups());
+            }
+
+            if (id == NO_GROUP) {
+                id = uint32_t(g.num_groups());
+                g.representative.push_back(i);
+                g.count.push_back(0);
+                g.hash.push_back(h);
+                next.push_back(NO_GROUP);
+            }
+            g.group_of[i] = id;
+            ++g.count[id];
+        });
+    });
+    return g;
+}
+
+// Rows holding the first occurrence of each distinct non-NULL value
+// (SELECT DISTINCT; add a NULL when group_rows() reports null_count > 0).
+inline std::vector<size_t> distinct_rows(const OnPairColumnView& view) {
+    return group_rows(view).representative;
+}
+
+} // namespace onpair::analytics
@@ -0,0 +1,84 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace onpair::analytics {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// HyperLogLog — mergeable distinct-count sketch over 64-bit hashes
+// ─────────────────────────────────────────────────────────────────────────────
+// Approximate distinct count with 2^precision one-byte registers; standard
+// error ≈ 1.04 / sqrt(2^precision) (0.8 % at the default precision 14, for
+// 16 KiB).  Small cardinalities fall back to linear counting.
+
+class HyperLogLog {
+public:
+    static constexpr uint8_t MIN_PRECISION = 4;
+    static constexpr uint8_t MAX_PRECISION = 18;
+
+    explicit HyperLogLog(uint8_t precision = 14)
+        : p_(precision)
+    {
+        if (p_ < MIN_PRECISION || p_ > MAX_PRECISION)
+            throw std::invalid_argument("OnPair: HyperLogLog precision out of range");
+        regs_.assign(size_t(1) << p_, 0);
+    }
+
+    // Rebuild from persisted registers (see registers()).
+    static HyperLogLog from_registers(uint8_t precision,
+                                      std::span<const uint8_t> regs) {
+        HyperLogLog h(precision);
+        if (regs.size() != h.regs_.size())
+            throw std::invalid_argument("OnPair: HyperLogLog register count mismatch");
+        h.regs_.assign(regs.begin(), regs.end());
+        return h;
+    }
+
+    void add(uint64_t hash) noexcept {
+        const size_t   idx  = size_t(hash >> (64 - p_));
+        const uint64_t w    = hash << p_;
+        const uint8_t  rank = w ? uint8_t(std::countl_zero(w) + 1)
+                                : uint8_t(64 - p_ + 1);
+        if (rank > regs_[idx]) regs_[idx] = rank;
+    }
+
+    void merge(const HyperLogLog& other) {
+        if (other.p_ != p_)
+            throw std::invalid_argument("OnPair: HyperLogLog precision mismatch");
+        for (size_t i = 0; i < regs_.size(); ++i)
+            regs_[i] = std::max(regs_[i], other.regs_[i]);
+    }
+
+    double estimate() const noexcept {
+        const double m = double(regs_.size());
+        double sum   = 0.0;
+        size_t zeros = 0;
+        for (uint8_t r : regs_) {
+            sum   += std::ldexp(1.0, -int(r));
+            zeros += (r == 0);
+        }
+        const double alpha = m == 16 ? 0.673
+                           : m == 32 ? 0.697
+                           : m == 64 ? 0.709
+                           : 0.7213 / (1.0 + 1.079 / m);
+        const double raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && zeros)
+            return m * std::log(m / double(zeros));     // linear counting
+        return raw;
+    }
+
+    uint8_t                  precision() const noexcept { return p_; }
+    std::span<const uint8_t> registers() const noexcept { return regs_; }
+
+private:
+    uint8_t              p_;
+    std::vector<uint8_t> regs_;
+};
+
+} // namespace onpair::analytics
@@ -0,0 +1,153 @@
+#pragma once
+#include <onpair/analytics/token_hasher.h>
+#include <onpair/column/column_view.h>
+#include <onpair/core/row_filter.h>
+#include <onpair/core/types.h>
+#include <onpair/decoding/token_cursor.h>
+#include <onpair/decoding/detail/unpack.h>
+#include <onpair/search/automata/scan.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace onpair::analytics {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Compressed-domain row hashing
+// ─────────────────────────────────────────────────────────────────────────────
+// parse() tokenizes equal strings into identical token sequences, so within
+// one dictionary a hash of a row's token ids is a valid equality key: equal
+// strings always hash equal, and rows never need to be decompressed.  The
+// converse holds only up to collisions — consumers that need exact equality
+// (group_rows, joins) confirm candidates token by token, e.g. rows_equal().
+//
+// Hashes are comparable across columns only if they share a dictionary.
+// TokenHasher (token_hasher.h) computes them.
+//
+// NULL rows are stored as empty token sequences, which would hash, group and
+// count like a real "", and deleted rows keep their tokens until compact().
+// Every kernel in analytics/ therefore walks only the rows that pass
+// detail::row_filter(): hash_rows() writes SKIPPED_ROW_HASH for the others,
+// and the aggregations leave them out.
+
+inline constexpr uint64_t SKIPPED_ROW_HASH = 0;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// hash_rows_impl — block-unpacked row hashing, monomorphised on Bits
+// ─────────────────────────────────────────────────────────────────────────────
+// Rows [begin, end) are grouped into SCAN_BLOCK_TOKENS blocks exactly as in
+// scan_blocked_impl, bulk-unpacked, and hashed with add_span().  A row longer
+// than one block is hashed straight from the packed stream.
+
+namespace detail {
+
+// Rows the analytics kernels consider.
+inline RowFilter row_filter(const OnPairColumnView& view) noexcept {
+    return RowFilter{view.validity(), view.deletions()};
+}
+
+template<BitWidth Bits>
+void hash_rows_impl(const uint64_t* ONPAIR_RESTRICT packed,
+                    const uint32_t* ONPAIR_RESTRICT bounds,
+                    size_t begin, size_t end,
+                    uint64_t* ONPAIR_RESTRICT out)
+{
+    constexpr uint32_t BLOCK = search::detail::SCAN_BLOCK_TOKENS;
+    Token buf[BLOCK];
+    decoding::TokenCursor<Bits> cursor(packed);
+
+    size_t i = begin;
+    while (i < end) {
+        const uint32_t base = bounds[i];
+        const uint32_t* last = std::upper_bound(
+            bounds + i + 1, bounds + end + 1, base + BLOCK);
+        const size_t j = size_t(last - bounds) - 1;
+
+        if (j == i) {
+            TokenHasher h;
+            cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+            while (cursor.has_more()) h.add(cursor.next());
+            out[i - begin] = h.finish();
+            ++i;
+            continue;
+        }
+
+        decoding::detail::unpack_tokens<Bits>(packed, base, bounds[j] - base, buf);
+        for (; i < j; ++i) {
+            TokenHasher h;
+            h.add_span(buf + (bounds[i] - base), bounds[i + 1] - bounds[i]);
+            out[i - begin] = h.finish();
+        }
+    }
+}
+
+// Token-by-token equality of two spans of one packed stream.
+template<BitWidth Bits>
+bool spans_equal(const uint64_t* ONPAIR_RESTRICT packed,
+                 StreamSpan a, StreamSpan b) noexcept
+{
+    if (a.end - a.begin != b.end - b.begin) return false;
+    decoding::TokenCursor<Bits> ca(packed, a);
+    decoding::TokenCursor<Bits> cb(packed, b);
+    while (ca.has_more())
+        if (ca.next() != cb.next()) return false;
+    return true;
+}
+
+} // namespace detail
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Public entry points
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Hash rows [begin, end) into out[0, end - begin); rows that fail
+// detail::row_filter() get SKIPPED_ROW_HASH.  Disjoint ranges may be hashed
+// concurrently.
+inline void hash_rows(const OnPairColumnView& view, size_t begin, size_t end,
+                      uint64_t* out)
+{
+    const auto sv = view.store();
+    const auto* packed = sv.packed_data();
+    const auto* bounds = sv.boundaries();
+    dispatch_bits(sv.bits(), [&](auto bits) {
+        detail::hash_rows_impl<bits.value>(packed, bounds, begin, end, out);
+    });
+    if (const RowFilter f = detail::row_filter(view)) {
+        for (size_t i = begin; i < end; ++i)
+            if (!f.passes(i)) out[i - begin] = SKIPPED_ROW_HASH;
+    }
+}
+
+// Hash every row into out[0, view.num_strings()).
+inline void hash_rows(const OnPairColumnView& view, uint64_t* out) {
+    hash_rows(view, 0, view.num_strings(), out);
+}
+
+// Exact equality of two rows, compared token by token without decoding.
+// Both views must share one dictionary for the result to mean string
+// equality.  A NULL or deleted row equals nothing, not even itself, as in
+// SQL equality.
+inline bool rows_equal(const OnPairColumnView& a, size_t i,
+                       const OnPairColumnView& b, size_t j) noexcept
+{
+    if (!detail::row_filter(a).passes(i) || !detail::row_filter(b).passes(j))
+        return false;
+
+    const auto sa = a.store().string_span(i);
+    const auto sb = b.store().string_span(j);
+    if (sa.end - sa.begin != sb.end - sb.begin) return false;
+
+    bool equal = true;
+    dispatch_bits(a.bits(), [&](auto ba) {
+        dispatch_bits(b.bits(), [&](auto bb) {
+            decoding::TokenCursor<ba.value> ca(a.store().packed_data(), sa);
+            decoding::TokenCursor<bb.value> cb(b.store().packed_data(), sb);
+            while (ca.has_more())
+                if (ca.next() != cb.next()) { equal = false; return; }
+        });
+    });
+    return equal;
+}
+
+} // namespace onpair::analytics
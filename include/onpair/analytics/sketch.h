@@ -0,0 +1,246 @@
+#pragma once
+#include <onpair/analytics/hyperloglog.h>
+#include <onpair/analytics/row_hash.h>
+#include <onpair/column/column_view.h>
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace onpair::analytics {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Compressed-domain sketches
+// ─────────────────────────────────────────────────────────────────────────────
+// Both sketches consume the 64-bit token-sequence hashes of hash_rows(), so
+// they are built straight from the packed store.  Each builder takes a row
+// range; to parallelise, build one sketch per disjoint range (on any
+// threads) and merge() the results.  Merging is order-independent for
+// HyperLogLog and follows the mergeable-summaries rule for SpaceSaving.
+//
+// Sketches describe one dictionary: hashes, and therefore sketches, from
+// columns with different dictionaries must not be merged.
+//
+// HyperLogLog lives in hyperloglog.h, free of column dependencies, so the
+// encoder can fill one during parse() (see ColumnStatistics).
+
+// ─── SpaceSaving ─────────────────────────────────────────────────────────────
+// Top-N frequent values with `capacity` counters (Metwally et al.).  Every
+// value whose true frequency exceeds rows / capacity is guaranteed to be
+// tracked; each counter over-estimates its value by at most `error`.
+// Counters keep one representative row, so only the winners are decoded.
+//
+// Counters sit in stable slots; a min-heap of slot ids orders them by
+// count.  A hit is one hash lookup plus a sift-down that only moves slot
+// ids; a miss on a full summary recycles the minimum's slot.
+
+class SpaceSaving {
+public:
+    struct Counter {
+        uint64_t hash;
+        uint64_t count;
+        uint64_t error;     // upper bound on the over-estimate
+        size_t   row;       // a row holding this value
+    };
+
+    explicit SpaceSaving(size_t capacity) : capacity_(capacity) {
+        if (capacity_ == 0)
+            throw std::invalid_argument("OnPair: SpaceSaving capacity must be positive");
+        slots_.reserve(capacity_);
+        heap_.reserve(capacity_);
+        where_.reserve(capacity_);
+        index_.reserve(capacity_);
+    }
+
+    void add(uint64_t hash, size_t row) {
+        if (auto it = index_.find(hash); it != index_.end()) {
+            ++slots_[it->second].count;
+            sift_down(where_[it->second]);
+            return;
+        }
+        if (!full()) {
+            const auto slot = static_cast<uint32_t>(slots_.size());
+            slots_.push_back({hash, 1, 0, row});
+            heap_.push_back(slot);
+            where_.push_back(slot);
+            index_.emplace(hash, slot);
+            sift_up(slot);
+            return;
+        }
+        const uint32_t slot = heap_[0];
+        Counter& c = slots_[slot];
+        index_.erase(c.hash);
+        c = {hash, c.count + 1, c.count, row};
+        index_.emplace(hash, slot);
+        sift_down(0);
+    }
+
+    // Combine with a summary of a disjoint row range.  A value missing from
+    // a full summary may have occurred up to that summary's minimum count
+    // times, so the minimum is added to both its count and its error.
+    void merge(const SpaceSaving& other) {
+        const uint64_t min_this  = full() ? min_count() : 0;
+        const uint64_t min_other = other.full() ? other.min_count() : 0;
+
+        std::vector<Counter> all;
+        all.reserve(slots_.size() + other.slots_.size());
+        for (const Counter& c : slots_) {
+            Counter m = c;
+            if (auto it = other.index_.find(c.hash); it != other.index_.end()) {
+                m.count += other.slots_[it->second].count;
+                m.error += other.slots_[it->second].error;
+            } else {
+                m.count += min_other;
+                m.error += min_other;
+            }
+            all.push_back(m);
+        }
+        for (const Counter& c : other.slots_) {
+            if (index_.contains(c.hash)) continue;
+            all.push_back({c.hash, c.count + min_this, c.error + min_this, c.row});
+        }
+
+        capacity_ = std::max(capacity_, other.capacity_);
+        if (all.size() > capacity_) {
+            std::nth_element(all.begin(), all.begin() + capacity_, all.end(),
+                [](const Counter& a, const Counter& b) { return a.count > b.count; });
+            all.resize(capacity_);
+        }
+        rebuild(std::move(all));
+    }
+
+    // The k largest counters, by descending count (ties: smaller error first).
+    std::vector<Counter> top(size_t k) const {
+        std::vector<Counter> out = slots_;
+        std::sort(out.begin(), out.end(), [](const Counter& a, const Counter& b) {
+            return a.count != b.count ? a.count > b.count : a.error < b.error;
+        });
+        if (out.size() > k) out.resize(k);
+        return out;
+    }
+
+    // Rebuild from persisted counters (see counters()).
+    static SpaceSaving from_counters(size_t capacity, std::vector<Counter> counters) {
+        SpaceSaving s(capacity);
+        if (counters.size() > capacity)
+            throw std::invalid_argument("OnPair: SpaceSaving counter count exceeds capacity");
+        s.rebuild(std::move(counters));
+        return s;
+    }
+
+    size_t                   capacity() const noexcept { return capacity_; }
+    size_t                   size()     const noexcept { return slots_.size(); }
+    bool                     full()     const noexcept { return slots_.size() == capacity_; }
+    std::span<const Counter> counters() const noexcept { return slots_; }   // unordered
+
+private:
+    uint64_t count_at(size_t i) const noexcept { return slots_[heap_[i]].count; }
+    uint64_t min_count()        const noexcept { return count_at(0); }
+
+    void swap_nodes(size_t a, size_t b) noexcept {
+        std::swap(heap_[a], heap_[b]);
+        where_[heap_[a]] = uint32_t(a);
+        where_[heap_[b]] = uint32_t(b);
+    }
+
+    void sift_up(size_t i) noexcept {
+        while (i > 0) {
+            const size_t parent = (i - 1) / 2;
+            if (count_at(parent) <= count_at(i)) break;
+            swap_nodes(i, parent);
+            i = parent;
+        }
+    }
+
+    void sift_down(size_t i) noexcept {
+        const size_t n = heap_.size();
+        for (;;) {
+            const size_t l = 2 * i + 1, r = l + 1;
+            size_t m = i;
+            if (l < n && count_at(l) < count_at(m)) m = l;
+            if (r < n && count_at(r) < count_at(m)) m = r;
+            if (m == i) return;
+            swap_nodes(i, m);
+            i = m;
+        }
+    }
+
+    void rebuild(std::vector<Counter> counters) {
+        slots_ = std::move(counters);
+        heap_.resize(slots_.size());
+        where_.resize(slots_.size());
+        index_.clear();
+        for (uint32_t i = 0; i < slots_.size(); ++i) {
+            heap_[i] = where_[i] = i;
+            index_.emplace(slots_[i].hash, i);
+        }
+        for (size_t i = heap_.size() / 2; i-- > 0; ) sift_down(i);
+    }
+
+    size_t                                        capacity_;
+    std::vector<Counter>                          slots_;
+    std::vector<uint32_t>                         heap_;    // slot ids, min-heap on count
+    std::vector<uint32_t>                         where_;   // slot → heap position
+    boost::unordered_flat_map<uint64_t, uint32_t> index_;   // hash → slot
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Builders
+// ─────────────────────────────────────────────────────────────────────────────
+// Hash rows [begin, end) in fixed-size chunks (bounded scratch memory) and
+// feed the rows that pass detail::row_filter() to the sketch, so NULL and
+// deleted rows are neither a distinct value nor a heavy hitter.  Row ids recorded by
+// SpaceSaving are absolute.
+
+namespace detail {
+
+inline constexpr size_t SKETCH_CHUNK_ROWS = 4096;
+
+template<typename Fn>
+void for_each_row_hash(const OnPairColumnView& view, size_t begin, size_t end,
+                       Fn&& fn)
+{
+    const RowFilter filter = row_filter(view);
+    uint64_t buf[SKETCH_CHUNK_ROWS];
+    for (size_t lo = begin; lo < end; lo += SKETCH_CHUNK_ROWS) {
+        const size_t hi = std::min(end, lo + SKETCH_CHUNK_ROWS);
+        hash_rows(view, lo, hi, buf);
+        for_each_passing(filter, lo, hi, [&](size_t i) { fn(buf[i - lo], i); });
+    }
+}
+
+} // namespace detail
+
+inline HyperLogLog build_hll(const OnPairColumnView& view,
+                             size_t begin, size_t end,
+                             uint8_t precision = 14)
+{
+    HyperLogLog h(precision);
+    detail::for_each_row_hash(view, begin, end,
+        [&](uint64_t hash, size_t) { h.add(hash); });
+    return h;
+}
+
+inline HyperLogLog build_hll(const OnPairColumnView& view, uint8_t precision = 14) {
+    return build_hll(view, 0, view.num_strings(), precision);
+}
+
+inline SpaceSaving build_space_saving(const OnPairColumnView& view,
+                                      size_t begin, size_t end,
+                                      size_t capacity)
+{
+    SpaceSaving s(capacity);
+    detail::for_each_row_hash(view, begin, end,
+        [&](uint64_t hash, size_t row) { s.add(hash, row); });
+    return s;
+}
+
+inline SpaceSaving build_space_saving(const OnPairColumnView& view, size_t capacity) {
+    return build_space_saving(view, 0, view.num_strings(), capacity);
+}
+
+} // namespace onpair::analytics
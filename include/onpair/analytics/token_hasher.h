@@ -0,0 +1,63 @@
+#pragma once
+#include <onpair/core/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace onpair::analytics {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TokenHasher — 64-bit hash of a token-id sequence
+// ─────────────────────────────────────────────────────────────────────────────
+// TokenHasher folds four 16-bit token ids into one 64-bit word per mixing
+// round and finishes with the token count and a murmur3 avalanche, so the
+// full 64 bits are usable by sketches (HyperLogLog) as well as hash tables.
+
+class TokenHasher {
+public:
+    void add(Token t) noexcept {
+        acc_ |= uint64_t(t) << (16 * (n_ & 3));
+        if ((++n_ & 3) == 0) { h_ = mix(h_ ^ acc_); acc_ = 0; }
+    }
+
+    // Hash tokens[0, count) in one go; equivalent to count add() calls on a
+    // fresh hasher.
+    void add_span(const Token* tokens, size_t count) noexcept {
+        size_t i = 0;
+        if ((n_ & 3) == 0) {
+            for (; i + 4 <= count; i += 4) {
+                uint64_t w;
+                std::memcpy(&w, tokens + i, sizeof(w));   // 4 × 16-bit, LE
+                h_ = mix(h_ ^ w);
+            }
+            n_ += uint32_t(i);
+        }
+        for (; i < count; ++i) add(tokens[i]);
+    }
+
+    uint64_t finish() const noexcept {
+        return fmix64(mix(h_ ^ acc_) ^ uint64_t(n_));
+    }
+
+private:
+    static constexpr uint64_t SEED = 0x243F6A8885A308D3ull;
+
+    static uint64_t mix(uint64_t x) noexcept {
+        x *= 0x9E3779B97F4A7C15ull;
+        return x ^ (x >> 29);
+    }
+
+    static uint64_t fmix64(uint64_t x) noexcept {
+        x ^= x >> 33; x *= 0xFF51AFD7ED558CCDull;
+        x ^= x >> 33; x *= 0xC4CEB9FE1A85EC53ull;
+        return x ^ (x >> 33);
+    }
+
+    uint64_t h_   = SEED;
+    uint64_t acc_ = 0;
+    uint32_t n_   = 0;
+};
+
+static_assert(sizeof(Token) == 2, "TokenHasher packs four 16-bit tokens per word");
+
+} // namespace onpair::analytics
@@ -27,7 +27,10 @@
 // ─────────────────────────────────────────────────────────────────────────────
 
 // Column types
+#include <onpair/column/builder.h>
 #include <onpair/column/column.h>
+#include <onpair/column/front_coded.h>
+#include <onpair/column/template_column.h>
 
 // Compression configuration
 #include <onpair/encoding/training/config.h>
@@ -36,4 +39,13 @@
 #include <onpair/search/automata/aho_corasick_automaton.h>
 #include <onpair/search/automata/eq_automaton.h>
 #include <onpair/search/automata/kmp_automaton.h>
-#include <onpair/search/automata/prefix_automaton.h>
\ No newline at end of file
+#include <onpair/search/automata/multi_prefix_automaton.h>
+#include <onpair/search/automata/prefix_automaton.h>
+#include <onpair/search/automata/token_set_automaton.h>
+#include <onpair/search/conjunction.h>
+#include <onpair/search/scan_batches.h>
+
+// Compressed-domain analytics (hashing, grouping, sketches)
+#include <onpair/analytics/group.h>
+#include <onpair/analytics/row_hash.h>
+#include <onpair/analytics/sketch.h>
@@ -0,0 +1,98 @@
+#pragma once
+#include <onpair/column/column.h>
+#include <onpair/core/store.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace onpair {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// ColumnBuilder — concurrent multi-producer ingest into one column
+// ─────────────────────────────────────────────────────────────────────────────
+// Many writer threads build one column without a shared lock.  Each thread
+// takes its own Producer.  A producer stages rows and encodes them against
+// the reference column's frozen dictionary every STAGE_BYTES, on the
+// producer's own thread, into a private token stream.  seal() stitches the
+// streams into a single Store.  Packed tokens are bit-copied, runs of
+// consecutive rows at a time, and never decoded or re-parsed.
+//
+// Row order:
+//   Order::Preserve  every row carries a sequence number, and the sealed
+//                    column holds rows in ascending sequence order.  Gaps
+//                    are allowed; a repeated number makes seal() throw.
+//   Order::Relaxed   no sequence numbers.  Each producer's rows stay in the
+//                    order it added them, and producers follow one another
+//                    in the order they were created.
+//
+//   ColumnBuilder b(reference, ColumnBuilder::Order::Relaxed);
+//   // on each writer thread:
+//   auto p = b.producer();
+//   p.add("row");
+//   // once every writer has stopped:
+//   OnPairColumn col = b.seal();
+//
+// producer() is thread-safe.  A Producer is not: use each one from one
+// thread at a time.  seal() must not overlap any add(); it encodes whatever
+// the producers still have staged.  The sealed column shares the reference's
+// dictionary.
+
+class ColumnBuilder {
+    struct Stage;
+
+public:
+    enum class Order : uint8_t { Preserve, Relaxed };
+
+    // Raw bytes a producer stages before it encodes them.
+    static constexpr size_t STAGE_BYTES = size_t(1) << 16;
+
+    // Throws std::logic_error when `reference` has no dictionary.
+    explicit ColumnBuilder(const OnPairColumn& reference, Order order = Order::Preserve);
+    ~ColumnBuilder();
+
+    ColumnBuilder(const ColumnBuilder&)            = delete;
+    ColumnBuilder& operator=(const ColumnBuilder&) = delete;
+
+    class Producer {
+    public:
+        // Order::Relaxed.  Throws std::logic_error under Order::Preserve.
+        void add(std::string_view row);
+        void add_null();
+
+        // Order::Preserve.  Throws std::logic_error under Order::Relaxed.
+        void add(uint64_t seq, std::string_view row);
+        void add_null(uint64_t seq);
+
+        // Encode the staged rows now rather than at the next STAGE_BYTES.
+        void flush();
+
+    private:
+        friend class ColumnBuilder;
+        explicit Producer(Stage& s) noexcept : s_(&s) {}
+        Stage* s_;
+    };
+
+    Producer producer();
+
+    Order order() const noexcept { return order_; }
+
+    // Build the column and reset the builder to empty; earlier producers
+    // must not be used afterwards.  Throws std::invalid_argument on a
+    // repeated sequence number under Order::Preserve (the staged rows are
+    // dropped).
+    OnPairColumn seal();
+
+private:
+    std::shared_ptr<const Dictionary>                     dict_;
+    std::shared_ptr<const encoding::LongestPrefixMatcher> lpm_;
+    BitWidth                                              bits_;
+    Order                                                 order_;
+
+    std::mutex                          mutex_;
+    std::vector<std::unique_ptr<Stage>> stages_;
+};
+
+} // namespace onpair
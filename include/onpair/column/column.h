@@ -1,17 +1,28 @@
 #pragma once
 #include <onpair/column/column_view.h>
+#include <onpair/column/estimate.h>
+#include <onpair/column/table.h>
+#include <onpair/core/compact_dictionary.h>
 #include <onpair/core/dictionary.h>
+#include <onpair/core/drift.h>
+#include <onpair/core/statistics.h>
 #include <onpair/core/store.h>
 #include <onpair/encoding/training/config.h>
 #include <concepts>
 #include <cstddef>
+#include <future>
 #include <iosfwd>
+#include <memory>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <string_view>
 #include <vector>
 
 namespace onpair {
 
+namespace encoding { class LongestPrefixMatcher; }
+
 // ─────────────────────────────────────────────────────────────────────────────
 // OnPairColumn
 // ─────────────────────────────────────────────────────────────────────────────
@@ -33,18 +44,205 @@ public:
     static OnPairColumn compress(const char* data, const uint32_t* offsets,
                                  size_t n, const Config& cfg = {});
 
+    // Arrow-style with a validity bitmap: bit i (LSB-first) of `validity`
+    // clear marks row i as NULL; nullptr means no nulls.  Bytes Arrow leaves
+    // in null slots are ignored, and a bitmap with no clear bit is dropped.
+    static OnPairColumn compress(const char* data, const uint32_t* offsets,
+                                 size_t n, const uint8_t* validity,
+                                 const Config& cfg = {});
+
+    // Controlled (see run_control.h): stops before training, or before any
+    // block of rows is parsed, once ctl.stop is requested, and reports parse
+    // progress.  `result` receives the status; on cancellation the column
+    // holds rows [0, result.rows), and append() can add the rest.  A column
+    // cancelled before training has finished is a default column.
+    static OnPairColumn compress(const char* data, const uint32_t* offsets,
+                                 size_t n, const uint8_t* validity,
+                                 const Config& cfg, const RunControl& ctl,
+                                 RunResult& result);
+
+    // ── Tables ────────────────────────────────────────────────────────────────
+    // Compress every column of `columns` concurrently and return them in
+    // input order (see table.h for scheduling, memory and shared groups).
+    // `cfgs` holds one Config per column, or a single Config for all.  The
+    // first overload runs on its own threads; the second submits its
+    // workers to `executor`.  The first exception thrown by any column is
+    // rethrown once the jobs already running have finished.  Throws
+    // std::invalid_argument when cfgs has the wrong size.
+    static std::vector<OnPairColumn>
+    compress_table(std::span<const TableColumn> columns, std::span<const Config> cfgs,
+                   const TableOptions& opts = {});
+    static std::vector<OnPairColumn>
+    compress_table(std::span<const TableColumn> columns, std::span<const Config> cfgs,
+                   const TableExecutor& executor, const TableOptions& opts = {});
+
+    // ── Estimation ────────────────────────────────────────────────────────────
+    // Predict compress(data, offsets, n, cfg) from two samples of about
+    // `sample_bytes` each, one trained on and one parsed (see estimate.h).
+    // Throws std::invalid_argument when sample_bytes is 0.
+    static CompressionEstimate estimate(const char* data, const uint32_t* offsets,
+                                        size_t n, const Config& cfg = {},
+                                        size_t sample_bytes = ESTIMATE_SAMPLE_BYTES);
+
+    // ── Shared dictionaries ───────────────────────────────────────────────────
+    // Train one dictionary over the rows of every column in `columns`, then
+    // compress each column with it.  The returned columns, in input order,
+    // reference a single Dictionary object, so token ids mean the same bytes
+    // in all of them: row hashes, rows_equal() and equality joins compare
+    // token sequences across the columns directly.  Each column's
+    // bytes_used() still counts the dictionary.
+    template<std::ranges::input_range Columns>
+        requires std::ranges::input_range<std::ranges::range_reference_t<Columns>> &&
+                 std::convertible_to<
+                     std::ranges::range_value_t<std::ranges::range_reference_t<Columns>>,
+                     std::string_view>
+    static std::vector<OnPairColumn> compress_shared(Columns&& columns,
+                                                     const Config& cfg = {});
+
+    // Compress `strings` with `reference`'s dictionary, without training; the
+    // new column shares it.  Use this to add a related column later.
+    template<std::ranges::input_range Range>
+        requires std::convertible_to<std::ranges::range_value_t<Range>, std::string_view>
+    static OnPairColumn compress_with(const OnPairColumn& reference, Range&& strings);
+
+    static OnPairColumn compress_with(const OnPairColumn& reference,
+                                      const char* data, const uint32_t* offsets,
+                                      size_t n);
+
+    // The dictionary, shared with every column built from or sharing it.
+    // Expands a compact dictionary, so it may throw std::bad_alloc.
+    const std::shared_ptr<const Dictionary>& shared_dictionary() const {
+        return dict_ || !lazy_ ? dict_ : lazy_->get();
+    }
+    bool shares_dictionary_with(const OnPairColumn& other) const noexcept {
+        return (dict_ && dict_ == other.dict_) || (lazy_ && lazy_ == other.lazy_);
+    }
+
+    // ── Compact dictionary ────────────────────────────────────────────────────
+    // Keep the dictionary front-coded (compact_dictionary.h), several times
+    // smaller, and expand it only when the column is next viewed, searched,
+    // appended to or shared.  Metadata and write_to() leave it compact, and
+    // files written from a compact column load compact.  Called again on an
+    // expanded column, drops the expansion.  The column stops sharing its
+    // dictionary with other columns.  Invalidates views.  No-op on a
+    // default-constructed column.
+    void compact_dictionary();
+    bool has_compact_dictionary() const noexcept { return lazy_ != nullptr; }
+    bool dictionary_expanded()    const noexcept { return !lazy_ || lazy_->expanded(); }
+
+    // ── Merging ───────────────────────────────────────────────────────────────
+    // Concatenate `sources`, in order, into one column without retraining.
+    // The target dictionary is the union of the source dictionaries (trimmed
+    // to the most useful 2^bits tokens if it overflows, bits being the widest
+    // source's).  Token streams are remapped token-to-token, and only the
+    // rows where the target dictionary would tokenize differently are
+    // decoded and re-parsed.  Validity is carried over, deleted rows are
+    // dropped, and statistics are not kept.
+    // Throws std::invalid_argument when `sources` is empty.
+    static OnPairColumn merge(std::span<const OnPairColumnView> sources);
+
+    // ── Appending ─────────────────────────────────────────────────────────────
+    // Encode more rows with the column's frozen dictionary; row ids continue
+    // from num_strings().  Each batch is reported to drift().  Statistics are
+    // dropped, since they describe the earlier rows only.  Invalidates views.
+    // Throws std::logic_error on a default-constructed column.
+    template<std::ranges::input_range Range>
+        requires std::convertible_to<std::ranges::range_value_t<Range>, std::string_view>
+    void append(Range&& strings);
+
+    void append(const char* data, const uint32_t* offsets, size_t n);
+    void append(const char* data, const uint32_t* offsets, size_t n,
+                const uint8_t* validity);
+
+    // ── Drift and retraining ──────────────────────────────────────────────────
+    // How well the dictionary fits the rows appended since training.  The
+    // baseline comes from the training input for columns built by compress()
+    // or retrain(), and from the column's contents at the first append
+    // otherwise (merged columns, and files written before any append).
+    const DriftMonitor& drift() const noexcept { return drift_; }
+    void set_drift_policy(const DriftPolicy& policy) noexcept {
+        drift_.set_policy(policy);
+    }
+
+    // A new column holding the same rows, with a dictionary trained on the
+    // current contents.  Row ids, nulls and deletions are kept; deleted rows
+    // are neither trained on nor stored.  The result owns its dictionary,
+    // even if this column shares one.  The drift policy carries over and
+    // the baseline restarts from the new training input.
+    OnPairColumn retrain(const Config& cfg = {}) const;
+
+    // retrain() on a background thread.  The task shares ownership of
+    // `snapshot`, so readers keep using it, and views of it, until they are
+    // switched to the result; nothing may modify the snapshot meanwhile.
+    // The result holds the snapshot's rows only: a caller that keeps
+    // appending to a live column meanwhile must append the rows added after
+    // the snapshot to the result before swapping it in.
+    // Throws std::invalid_argument when `snapshot` is null.
+    static std::future<OnPairColumn>
+    retrain_async(std::shared_ptr<const OnPairColumn> snapshot, Config cfg = {});
+
     // ── Access ────────────────────────────────────────────────────────────────
-    OnPairColumnView view() const noexcept { return OnPairColumnView(*this); }
+    // Expands a compact dictionary, so it may throw std::bad_alloc.
+    OnPairColumnView view() const { return OnPairColumnView(*this); }
 
     // ── Metadata ──────────────────────────────────────────────────────────────
-    size_t num_strings() const noexcept { return view().num_strings(); }
-    size_t bytes_used()  const noexcept { return view().bytes_used();  }
-    BitWidth bits()      const noexcept { return view().bits();        }
+    // None of these expand a compact dictionary; bytes_used() counts it in
+    // its compact size.
+    size_t num_strings() const noexcept { return store_.num_strings(); }
+    size_t bytes_used()  const noexcept {
+        return store_.bytes_used()
+             + (lazy_ ? lazy_->compact()->bytes_used() : dict_ ? dict_->bytes_used() : 0);
+    }
+    BitWidth bits()      const noexcept { return store_.bit_width; }
+
+    size_t null_count()  const noexcept {
+        return count_nulls(validity_.empty() ? nullptr : validity_.data(), num_strings());
+    }
+    bool   has_nulls()   const noexcept { return !validity_.empty();    }
+
+    // ── Deletes ───────────────────────────────────────────────────────────────
+    // erase() marks rows deleted in the column's deletion vector
+    // (row_filter.h).  Scans and decoders skip them immediately, and row ids
+    // stay stable; the tokens remain in the store until compact().
+    // Throws std::out_of_range for a row >= num_strings().
+    void erase(size_t row);
+    void erase(std::span<const size_t> rows);
+
+    size_t deleted_count() const noexcept {
+        return count_deleted(deleted_.empty() ? nullptr : deleted_.data(), num_strings());
+    }
+    bool   has_deletions() const noexcept { return !deleted_.empty();      }
+
+    // Rewrite the store without the deleted rows and drop the deletion
+    // vector.  Surviving token runs are bit-copied — never decoded, retrained
+    // or re-tokenized — and the dictionary is kept.  Surviving rows are
+    // renumbered densely.  Statistics are dropped, since they may describe
+    // erased values.
+    void compact();
+
+    // Statistics gathered at compress time, or nullptr when the column was
+    // built without TrainingConfig::collect_statistics.
+    const ColumnStatistics* statistics() const noexcept {
+        return stats_ ? &*stats_ : nullptr;
+    }
 
     // ── Serialisation ─────────────────────────────────────────────────────────
     void write_to(std::ostream& out) const;
     static OnPairColumn read_from(std::istream& in);
 
+    // Archival copy: write_to() with the token stream entropy-coded
+    // (cold_store.h) and the row boundaries as varints.  read_from() reads
+    // it back, transcoding the store to the fixed-width layout on
+    // std::thread::hardware_concurrency() threads; the column in memory is
+    // the same either way.
+    void write_cold(std::ostream& out) const;
+
+    // Files always carry their dictionary.  This overload shares `shared`
+    // instead of loading a copy when the file's dictionary equals it, so
+    // columns written from a shared dictionary share it again once loaded.
+    static OnPairColumn read_from(std::istream& in,
+                                  const std::shared_ptr<const Dictionary>& shared);
+
     // ── Lifecycle ─────────────────────────────────────────────────────────────
     OnPairColumn()                               = default;
     OnPairColumn(OnPairColumn&&)                 = default;
@@ -53,15 +251,59 @@ public:
     OnPairColumn& operator=(const OnPairColumn&) = delete;
 
 private:
-    Dictionary dict_;
+    std::shared_ptr<const Dictionary> dict_;   // null until compressed, or if compact
+    std::shared_ptr<const LazyDictionary> lazy_;   // set by compact_dictionary()
     Store      store_;
+    std::optional<ColumnStatistics> stats_;
+    std::vector<uint64_t> validity_;   // empty when no row is null
+    std::vector<uint64_t> deleted_;    // empty when no row is deleted
+    DriftMonitor          drift_;
+    // Matcher over dict_, built by the first append() and kept for the next.
+    std::shared_ptr<const encoding::LongestPrefixMatcher> encoder_;
+
+    static OnPairColumn compress_raw(const uint8_t*    data,
+                                     const uint32_t*   offsets,
+                                     size_t            n,
+                                     const Config&     cfg,
+                                     const uint8_t*    validity = nullptr,
+                                     const RunControl* ctl      = nullptr,
+                                     RunResult*        result   = nullptr);
+
+    static OnPairColumn encode_raw(std::shared_ptr<const Dictionary> dict,
+                                   const encoding::LongestPrefixMatcher& lpm,
+                                   BitWidth bits, const uint8_t* data,
+                                   const uint32_t* offsets, size_t n,
+                                   bool collect_statistics,
+                                   const RunControl* ctl = nullptr);
+
+    // encode_raw() for input that may hold nulls: `validity` is an Arrow
+    // bitmap or nullptr, handled as compress() handles it.
+    static OnPairColumn encode_nullable(std::shared_ptr<const Dictionary> dict,
+                                        const encoding::LongestPrefixMatcher& lpm,
+                                        BitWidth bits, const uint8_t* data,
+                                        const uint32_t* offsets, size_t n,
+                                        const uint8_t* validity,
+                                        bool collect_statistics);
+
+    static std::vector<OnPairColumn>
+    compress_shared_raw(const uint8_t* data, const uint32_t* offsets,
+                        std::span<const size_t> rows, const Config& cfg);
 
-    static OnPairColumn compress_raw(const uint8_t*  data,
-                                     const uint32_t* offsets,
-                                     size_t          n,
-                                     const Config&   cfg);
+    static OnPairColumn compress_with_raw(const OnPairColumn& reference,
+                                          const uint8_t* data,
+                                          const uint32_t* offsets, size_t n);
+
+    // The dictionary, expanded if compact, or an empty one for a
+    // default-constructed column.
+    const Dictionary& dict() const;   // expands a compact dictionary
+
+    void append_raw(const uint8_t* data, const uint32_t* offsets, size_t n,
+                    const uint8_t* validity);
+
+    void write_impl(std::ostream& out, bool cold) const;
 
     friend class OnPairColumnView;
+    friend class ColumnBuilder;
 };
 
 // ─── OnPairColumn::compress<Range> (template definition) ─────────────────────
@@ -89,8 +331,89 @@ OnPairColumn OnPairColumn::compress(Range&& strings, const Config& cfg)
     return compress_raw(data.data(), offsets.data(), n, cfg);
 }
 
+// ─── OnPairColumn::compress_shared / compress_with (template definitions) ────
+
+template<std::ranges::input_range Columns>
+    requires std::ranges::input_range<std::ranges::range_reference_t<Columns>> &&
+             std::convertible_to<
+                 std::ranges::range_value_t<std::ranges::range_reference_t<Columns>>,
+                 std::string_view>
+std::vector<OnPairColumn> OnPairColumn::compress_shared(Columns&& columns,
+                                                        const Config& cfg)
+{
+    std::vector<uint8_t>  data;
+    std::vector<uint32_t> offsets{0};
+    std::vector<size_t>   rows;
+
+    for (auto&& column : columns) {
+        size_t count = 0;
+        for (const auto& s : column) {
+            const std::string_view sv = s;
+            data.insert(data.end(),
+                        reinterpret_cast<const uint8_t*>(sv.data()),
+                        reinterpret_cast<const uint8_t*>(sv.data()) + sv.size());
+            offsets.push_back(static_cast<uint32_t>(data.size()));
+            ++count;
+        }
+        rows.push_back(count);
+    }
+
+    return compress_shared_raw(data.data(), offsets.data(), rows, cfg);
+}
+
+template<std::ranges::input_range Range>
+    requires std::convertible_to<std::ranges::range_value_t<Range>, std::string_view>
+OnPairColumn OnPairColumn::compress_with(const OnPairColumn& reference,
+                                         Range&& strings)
+{
+    std::vector<uint8_t>  data;
+    std::vector<uint32_t> offsets{0};
+
+    for (const auto& s : strings) {
+        const std::string_view sv = s;
+        data.insert(data.end(),
+                    reinterpret_cast<const uint8_t*>(sv.data()),
+                    reinterpret_cast<const uint8_t*>(sv.data()) + sv.size());
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+    }
+
+    return compress_with_raw(reference, data.data(), offsets.data(),
+                             offsets.size() - 1);
+}
+
+// ─── OnPairColumn::append<Range> (template definition) ───────────────────────
+
+template<std::ranges::input_range Range>
+    requires std::convertible_to<std::ranges::range_value_t<Range>, std::string_view>
+void OnPairColumn::append(Range&& strings)
+{
+    std::vector<uint8_t>  data;
+    std::vector<uint32_t> offsets;
+
+    if constexpr (std::ranges::sized_range<Range>)
+        offsets.reserve(std::ranges::size(strings) + 1);
+    offsets.push_back(0);
+
+    for (const auto& s : strings) {
+        const std::string_view sv = s;
+        data.insert(data.end(),
+                    reinterpret_cast<const uint8_t*>(sv.data()),
+                    reinterpret_cast<const uint8_t*>(sv.data()) + sv.size());
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+    }
+
+    append_raw(data.data(), offsets.data(), offsets.size() - 1, nullptr);
+}
+
+inline const Dictionary& OnPairColumn::dict() const {
+    static const Dictionary empty;
+    return dict_ ? *dict_ : lazy_ ? *lazy_->get() : empty;
+}
+
 // ─── OnPairColumnView constructor (needs OnPairColumn to be complete) ────────
-inline OnPairColumnView::OnPairColumnView(const OnPairColumn& col) noexcept
-    : sv_(col.store_), dv_(col.dict_) {}
+inline OnPairColumnView::OnPairColumnView(const OnPairColumn& col)
+    : sv_(col.store_), dv_(col.dict()), stats_(col.statistics()),
+      validity_(col.validity_.empty() ? nullptr : col.validity_.data()),
+      deleted_(col.deleted_.empty() ? nullptr : col.deleted_.data()) {}
 
 } // namespace onpair
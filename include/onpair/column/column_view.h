@@ -1,14 +1,24 @@
 #pragma once
 #include <onpair/core/dictionary_view.h>
+#include <onpair/core/statistics.h>
 #include <onpair/core/store_view.h>
+#include <onpair/core/row_filter.h>
+#include <onpair/core/run_control.h>
 #include <onpair/decoding/decoder.h>
+#include <onpair/decoding/detail/drop_rows.h>
 #include <onpair/search/automata/scan.h>
 #include <onpair/search/automata/kmp_automaton.h>
+#include <onpair/search/automata/multi_prefix_automaton.h>
 #include <onpair/search/automata/prefix_automaton.h>
+#include <onpair/search/automata/token_set_automaton.h>
+#include <onpair/search/byte_scan.h>
 #include <onpair/search/eq_search.h>
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <functional>
+#include <span>
 #include <string_view>
 #include <type_traits>
 #include <vector>
@@ -31,13 +41,21 @@ class OnPairColumn;  // forward declaration
 // ─────────────────────────────────────────────────────────────────────────────
 // Non-owning view over a compressed column.  Provides decompression and
 // search operations.  Lifetime is tied to the underlying OnPairColumn.
+//
+// Null rows (see validity.h) decompress as empty strings, are reported by
+// is_valid() and decompress_all()'s validity output, and never match a
+// search.  Deleted rows (see row_filter.h) never match either, and
+// decompress as empty strings too, so their bytes never leave the column.
 
 class OnPairColumnView {
 public:
-    /* implicit */ OnPairColumnView(const OnPairColumn& col) noexcept;
+    /* implicit */ OnPairColumnView(const OnPairColumn& col);
 
-    OnPairColumnView(StoreView sv, DictionaryView dv) noexcept
-        : sv_(sv), dv_(dv) {}
+    OnPairColumnView(StoreView sv, DictionaryView dv,
+                     const ColumnStatistics* stats = nullptr,
+                     const uint64_t* validity = nullptr,
+                     const uint64_t* deleted  = nullptr) noexcept
+        : sv_(sv), dv_(dv), stats_(stats), validity_(validity), deleted_(deleted) {}
 
     // ── Metadata ──────────────────────────────────────────────────────────────
     size_t   num_strings() const noexcept { return sv_.num_strings(); }
@@ -46,22 +64,114 @@ public:
         return sv_.bytes_used() + dv_.bytes_used();
     }
 
+    // Compress-time statistics; nullptr if the column has none.
+    const ColumnStatistics* statistics() const noexcept { return stats_; }
+
+    // ── Nulls ─────────────────────────────────────────────────────────────────
+    // validity() is the word-form bitmap, or nullptr when no row is null.
+    const uint64_t* validity()   const noexcept { return validity_; }
+    bool            has_nulls()  const noexcept { return validity_ != nullptr; }
+    bool            is_valid(size_t idx) const noexcept {
+        return is_valid_row(validity_, idx);
+    }
+    size_t          null_count() const noexcept {
+        return count_nulls(validity_, num_strings());
+    }
+
+    // ── Deletions ─────────────────────────────────────────────────────────────
+    // deletions() is the deletion vector, or nullptr when no row is deleted.
+    const uint64_t* deletions()     const noexcept { return deleted_; }
+    bool            has_deletions() const noexcept { return deleted_ != nullptr; }
+    bool            is_deleted(size_t idx) const noexcept {
+        return is_deleted_row(deleted_, idx);
+    }
+    size_t          deleted_count() const noexcept {
+        return count_deleted(deleted_, num_strings());
+    }
+
     // ── Random access ─────────────────────────────────────────────────────────
     size_t decompress(size_t idx, char* buf) const noexcept {
+        if (is_deleted_row(deleted_, idx)) return 0;
         return decoding::decompress(sv_, dv_, idx,
                                     reinterpret_cast<uint8_t*>(buf));
     }
 
     // ── Bulk decompression ───────────────────────────────────────────────────
+    // Deleted rows are left out of the flat output.
     size_t decompress_all(char* buf) const noexcept {
-        return decoding::decompress_all(sv_, dv_,
-                                        reinterpret_cast<uint8_t*>(buf));
+        auto* out = reinterpret_cast<uint8_t*>(buf);
+        const size_t len = decoding::decompress_all(sv_, dv_, out);
+        if (!deleted_) return len;
+        return dispatch_bits(sv_.bits(), [&](auto bits) {
+            return decoding::detail::drop_rows<bits.value>(
+                sv_.packed_data(), sv_.boundaries(), dv_.raw_offsets(),
+                deleted_, num_strings(), out);
+        });
     }
 
+    // One slot per row; deleted rows occupy empty slots.
     size_t decompress_all(char* buf, uint32_t* out_offsets) const noexcept {
-        return decoding::decompress_all(sv_, dv_,
-                                        reinterpret_cast<uint8_t*>(buf),
-                                        out_offsets);
+        auto* out = reinterpret_cast<uint8_t*>(buf);
+        const size_t len = decoding::decompress_all(sv_, dv_, out, out_offsets);
+        if (!deleted_) return len;
+        return decoding::detail::drop_rows(deleted_, num_strings(), out, out_offsets);
+    }
+
+    // Also writes the Arrow validity bitmap, (num_strings() + 7) / 8 bytes,
+    // to out_validity.  Null and deleted rows occupy empty slots in buf and
+    // are marked null.
+    size_t decompress_all(char* buf, uint32_t* out_offsets,
+                          uint8_t* out_validity) const noexcept {
+        const size_t n = num_strings();
+        unpack_validity(validity_, n, out_validity);
+        if (deleted_) {
+            for (size_t i = 0; i < (n + 7) / 8; ++i)
+                out_validity[i] &= uint8_t(~(deleted_[i / 8] >> (8 * (i % 8))));
+        }
+        return decompress_all(buf, out_offsets);
+    }
+
+    // Controlled: decodes one RunControl block at a time (see run_control.h).
+    // A cancelled run has written out_offsets[0, r.rows] and the r.bytes
+    // bytes they cover, and nothing past them.  Deleted rows occupy empty
+    // slots, as above.
+    RunResult decompress_all(char* buf, uint32_t* out_offsets,
+                             const RunControl& ctl) const {
+        const size_t n = num_strings();
+        if (n == 0) {
+            out_offsets[0] = 0;
+            return {};
+        }
+        auto* out = reinterpret_cast<uint8_t*>(buf);
+        const uint32_t* bounds     = sv_.boundaries();
+        const uint8_t*  dict_bytes = dv_.raw_bytes();
+        const uint32_t* dict_offs  = dv_.raw_offsets();
+        size_t pos = 0;
+
+        RunResult r = dispatch_bits(sv_.bits(), [&](auto bits) -> RunResult {
+            decoding::TokenCursor<bits.value> cursor(sv_.packed_data());
+            const size_t block = ctl.block();
+            for (size_t begin = 0; begin < n; begin += block) {
+                if (ctl.stop_requested()) return {RunStatus::Cancelled, begin};
+                const size_t end = std::min(n, begin + block);
+                for (size_t i = begin; i < end; ++i) {
+                    out_offsets[i] = static_cast<uint32_t>(pos);
+                    if (is_deleted_row(deleted_, i)) continue;
+                    cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+                    while (cursor.has_more()) {
+                        const Token    t   = cursor.next();
+                        const uint32_t off = dict_offs[t];
+                        std::memcpy(out + pos, dict_bytes + off, MAX_TOKEN_SIZE);
+                        pos += dict_offs[t + 1] - off;
+                    }
+                }
+                ctl.report(end, n);
+            }
+            return {RunStatus::Complete, n};
+        });
+        out_offsets[r.rows] = static_cast<uint32_t>(pos);
+        r.bytes = pos;
+        return r;
     }
 
     // ── Generic automaton scan ────────────────────────────────────────────────
@@ -75,7 +185,11 @@ public:
         const auto* bounds = sv_.boundaries();
         const size_t n = sv_.num_strings();
         dispatch_bits(sv_.bits(), [&](auto bits) {
-            search::detail::scan_impl<bits.value>(aut, packed, bounds, n, on_match);
+            if (const RowFilter f = filter())
+                search::detail::scan_impl<bits.value>(aut, packed, bounds,
+                                                      f, n, on_match);
+            else
+                search::detail::scan_impl<bits.value>(aut, packed, bounds, n, on_match);
         });
     }
 
@@ -87,12 +201,114 @@ public:
         return result;
     }
 
-    // ── Substring search (KMP) ────────────────────────────────────────────────
+    // Controlled: stops at a block boundary once ctl.stop is requested (see
+    // run_control.h).  on_match has then seen every match in [0, r.rows).
+    template<typename A, std::invocable<size_t> F>
+        requires search::TokenAutomaton<std::remove_reference_t<A>>
+    RunResult scan(A&& aut, F&& on_match, const RunControl& ctl) const {
+        const size_t n = sv_.num_strings();
+        if (n == 0) return {};
+        return dispatch_bits(sv_.bits(), [&](auto bits) {
+            return search::detail::scan_impl<bits.value>(
+                aut, sv_.packed_data(), sv_.boundaries(), filter(), n, ctl, on_match);
+        });
+    }
+
+    // ── Fused scan and decompression ──────────────────────────────────────────
+    // Same rows as scan(), each decoded as soon as it is accepted, while its
+    // packed words are still in cache (see scan_decompress_impl).  Writes the
+    // accepted rows to buf with Arrow offsets in out_offsets (one entry per
+    // row plus a final one) and their ids to out_rows when non-null.
+    // Returns the number of accepted rows.  Buffer requirements:
+    //   buf         — accepted rows' bytes + DECOMPRESS_BUFFER_PADDING
+    //                 (a decompress_all() buffer always suffices)
+    //   out_offsets — accepted rows + 1   (num_strings() + 1 suffices)
+    //   out_rows    — accepted rows
+    template<typename A>
+        requires search::TokenAutomaton<std::remove_reference_t<A>>
+    size_t scan_decompress(A&& aut, char* buf, uint32_t* out_offsets,
+                           size_t* out_rows = nullptr) const {
+        return dispatch_bits(sv_.bits(), [&](auto bits) {
+            return search::detail::scan_decompress_impl<bits.value>(
+                aut, sv_.packed_data(), sv_.boundaries(), filter(),
+                sv_.num_strings(), dv_.raw_bytes(), dv_.raw_offsets(),
+                reinterpret_cast<uint8_t*>(buf), out_offsets, out_rows);
+        });
+    }
+
+    // ── Interleaved automaton scan ────────────────────────────────────────────
+    // Same result as scan(), computed K rows at a time in lockstep.  `aut` is
+    // copied into K independent lanes, so it must be Replicable (combinators
+    // are not — they reference their operands).  Pays off on short rows and
+    // automata with small tables; every lane holds its own copy of the tables.
+
+    template<size_t K = 8, typename A, std::invocable<size_t> F>
+        requires search::Replicable<std::remove_cvref_t<A>>
+    void scan_interleaved(const A& aut, F&& on_match) const {
+        auto lanes = search::detail::replicate<K>(aut);
+        const auto* packed = sv_.packed_data();
+        const auto* bounds = sv_.boundaries();
+        const size_t n = sv_.num_strings();
+        dispatch_bits(sv_.bits(), [&](auto bits) {
+            with_filter(on_match, [&](auto&& emit) {
+                search::detail::scan_interleaved_impl<bits.value>(
+                    lanes, packed, bounds, n, emit);
+            });
+        });
+    }
+
+    template<size_t K = 8, typename A>
+        requires search::Replicable<std::remove_cvref_t<A>>
+    std::vector<size_t> scan_interleaved(const A& aut) const {
+        std::vector<size_t> result;
+        scan_interleaved<K>(aut, [&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+    // ── Block-unpacked automaton scan ─────────────────────────────────────────
+    // Same result as scan().  Bulk-unpacks blocks of rows into a Token buffer
+    // with the decode_all group kernels, then drives `aut` over the buffer.
+
+    template<typename A, std::invocable<size_t> F>
+        requires search::TokenAutomaton<std::remove_reference_t<A>>
+    void scan_blocked(A&& aut, F&& on_match) const {
+        const auto* packed = sv_.packed_data();
+        const auto* bounds = sv_.boundaries();
+        const size_t n = sv_.num_strings();
+        dispatch_bits(sv_.bits(), [&](auto bits) {
+            with_filter(on_match, [&](auto&& emit) {
+                search::detail::scan_blocked_impl<bits.value>(aut, packed, bounds, n, emit);
+            });
+        });
+    }
+
+    template<typename A>
+        requires search::TokenAutomaton<std::remove_reference_t<A>>
+    std::vector<size_t> scan_blocked(A&& aut) const {
+        std::vector<size_t> result;
+        scan_blocked(aut, [&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+    // ── Substring search ──────────────────────────────────────────────────────
+    // A single-byte pattern is a one-byte class and goes to contains_class().
+    // Otherwise contains() compiles a KmpAutomaton and lets
+    // choose_contains_engine() decide between the token engine (scan) and the
+    // byte engine (contains_bytes).  All paths return identical results.
 
     template<std::invocable<size_t> F>
     void contains(std::string_view pattern, F&& on_match) const {
+        if (pattern.size() == 1) {
+            contains_class(search::TokenSetAutomaton::any_of(pattern, dv_),
+                           std::forward<F>(on_match));
+            return;
+        }
         search::KmpAutomaton kmp(pattern, dv_);
-        scan(kmp, std::forward<F>(on_match));
+        if (search::choose_contains_engine(pattern, dv_, kmp)
+                == search::ContainsEngine::bytes)
+            contains_bytes(pattern, std::forward<F>(on_match));
+        else
+            scan(kmp, std::forward<F>(on_match));
     }
 
     std::vector<size_t> contains(std::string_view pattern) const {
@@ -101,6 +317,67 @@ public:
         return result;
     }
 
+    // Byte engine: block-decompress, then vectorised substring search.
+    template<std::invocable<size_t> F>
+    void contains_bytes(std::string_view pattern, F&& on_match) const {
+        const auto* packed = sv_.packed_data();
+        const auto* bounds = sv_.boundaries();
+        const size_t n = sv_.num_strings();
+        dispatch_bits(sv_.bits(), [&](auto bits) {
+            with_filter(on_match, [&](auto&& emit) {
+                search::detail::scan_bytes_impl<bits.value>(
+                    pattern, packed, bounds, n,
+                    dv_.raw_bytes(), dv_.raw_offsets(), emit);
+            });
+        });
+    }
+
+    std::vector<size_t> contains_bytes(std::string_view pattern) const {
+        std::vector<size_t> result;
+        contains_bytes(pattern, [&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+    // ── Byte-class search ─────────────────────────────────────────────────────
+    // Rows containing at least one byte for which `pred` holds.
+    // contains_byte_if() builds a TokenSetAutomaton and lets
+    // choose_token_set_engine() pick scan_token_set(), which scans
+    // block-unpacked tokens with its membership bitmap, or a row-at-a-time
+    // scan() for dense classes.  Pass a prebuilt automaton to
+    // scan_token_set() to reuse it across calls.
+
+    template<std::invocable<size_t> F>
+    void scan_token_set(const search::TokenSetAutomaton& set, F&& on_match) const {
+        const auto* packed = sv_.packed_data();
+        const auto* bounds = sv_.boundaries();
+        const size_t n = sv_.num_strings();
+        dispatch_bits(sv_.bits(), [&](auto bits) {
+            with_filter(on_match, [&](auto&& emit) {
+                search::detail::scan_token_set_impl<bits.value>(set, packed, bounds, n, emit);
+            });
+        });
+    }
+
+    std::vector<size_t> scan_token_set(const search::TokenSetAutomaton& set) const {
+        std::vector<size_t> result;
+        scan_token_set(set, [&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+    template<std::predicate<uint8_t> P, std::invocable<size_t> F>
+    void contains_byte_if(P&& pred, F&& on_match) const {
+        contains_class(search::TokenSetAutomaton(std::forward<P>(pred), dv_),
+                       std::forward<F>(on_match));
+    }
+
+    template<std::predicate<uint8_t> P>
+    std::vector<size_t> contains_byte_if(P&& pred) const {
+        std::vector<size_t> result;
+        contains_byte_if(std::forward<P>(pred),
+                         [&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
     // ── Prefix search ─────────────────────────────────────────────────────────
 
     template<std::invocable<size_t> F>
@@ -115,6 +392,28 @@ public:
         return result;
     }
     
+    // Rows starting with any of `prefixes`, decided in one pass by a
+    // MultiPrefixAutomaton.  The two-argument callback also receives the
+    // index of a matching prefix (see MultiPrefixAutomaton::matched_prefix).
+
+    template<typename F>
+        requires std::invocable<F, size_t> || std::invocable<F, size_t, uint32_t>
+    void starts_with_any(std::span<const std::string_view> prefixes,
+                         F&& on_match) const {
+        search::MultiPrefixAutomaton mpa(prefixes, dv_);
+        if constexpr (std::invocable<F, size_t, uint32_t>)
+            scan(mpa, [&](size_t idx) { on_match(idx, mpa.matched_prefix()); });
+        else
+            scan(mpa, std::forward<F>(on_match));
+    }
+
+    std::vector<size_t> starts_with_any(
+        std::span<const std::string_view> prefixes) const {
+        std::vector<size_t> result;
+        starts_with_any(prefixes, [&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
     // ── Exact-match search ─────────────────────────────────────────────────────
 
     template<std::invocable<size_t> F>
@@ -124,7 +423,9 @@ public:
         const auto* bounds = sv_.boundaries();
         const size_t n = sv_.num_strings();
         dispatch_bits(sv_.bits(), [&](auto bits) {
-            em.template scan<bits.value>(packed, bounds, n, on_match);
+            with_filter(on_match, [&](auto&& emit) {
+                em.template scan<bits.value>(packed, bounds, n, emit);
+            });
         });
     }
 
@@ -139,8 +440,36 @@ public:
     DictionaryView dictionary() const noexcept { return dv_; }
 
 private:
-    StoreView      sv_;
-    DictionaryView dv_;
+    RowFilter filter() const noexcept { return {validity_, deleted_}; }
+
+    template<typename F>
+    void contains_class(search::TokenSetAutomaton set, F&& on_match) const {
+        if (search::choose_token_set_engine(set, dv_) == search::TokenSetEngine::rows)
+            scan(set, std::forward<F>(on_match));
+        else
+            scan_token_set(set, std::forward<F>(on_match));
+    }
+
+    // Kernels without a filtered variant run unchanged; their matches are
+    // filtered here.  Null rows hold no tokens, so they cost the kernel next
+    // to nothing; deleted rows are scanned until compact() removes them.
+    template<typename F, typename Run>
+    void with_filter(F& on_match, Run&& run) const {
+        const RowFilter f = filter();
+        if (!f) {
+            run(on_match);
+            return;
+        }
+        run([&](size_t idx) {
+            if (f.passes(idx)) on_match(idx);
+        });
+    }
+
+    StoreView               sv_;
+    DictionaryView          dv_;
+    const ColumnStatistics* stats_    = nullptr;
+    const uint64_t*         validity_ = nullptr;
+    const uint64_t*         deleted_  = nullptr;
 };
 
 } // namespace onpair
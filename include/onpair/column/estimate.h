@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Compression estimate.
+//
+// OnPairColumn::estimate() predicts what compress() would produce without
+// compressing the whole input.  It trains a dictionary on one sample of rows
+// and parses a second, disjoint sample with it.  From that it projects the
+// column size, and it times decompression and a full-row scan over the
+// parsed sample.  A storage layer can compare the result against dictionary
+// or plain encoding before it commits to OnPair.
+//
+// The samples are spread across the input: each sample takes one random row
+// from every stride of rows.  Each holds about `sample_bytes` of input.
+// When the input is less than twice that, the whole input is used for both
+// training and parsing, so the projection is exact up to timing.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+inline constexpr size_t ESTIMATE_SAMPLE_BYTES = size_t(1) << 20;
+
+struct CompressionEstimate {
+    size_t rows        = 0;   // input rows
+    size_t input_bytes = 0;   // input bytes
+
+    size_t train_rows  = 0;   // rows in the training sample
+    size_t parse_rows  = 0;   // rows in the parse sample
+
+    size_t dictionary_tokens = 0;
+    double bytes_per_token   = 0;   // over the parse sample
+    double tokens_per_row    = 0;   // over the parse sample
+
+    size_t bytes_used        = 0;   // projected OnPairColumn::bytes_used()
+    double compression_ratio = 0;   // input_bytes / bytes_used
+
+    // Measured on the parse sample on this machine, in input bytes per
+    // second.  decompress_all() and a scan() that visits every token.
+    double decode_bytes_per_second = 0;
+    double scan_bytes_per_second   = 0;
+};
+
+} // namespace onpair
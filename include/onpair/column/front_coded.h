@@ -0,0 +1,238 @@
+#pragma once
+#include <onpair/column/column.h>
+#include <onpair/core/dictionary.h>
+#include <onpair/core/dictionary_view.h>
+#include <onpair/core/row_filter.h>
+#include <onpair/core/store.h>
+#include <onpair/search/automata/eq_automaton.h>
+#include <onpair/search/automata/kmp_automaton.h>
+#include <onpair/search/automata/prefix_automaton.h>
+#include <onpair/search/automata/scan.h>
+#include <onpair/search/automata/token_set_automaton.h>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace onpair {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FrontCodedColumn — row-level front coding over OnPair tokens
+// ─────────────────────────────────────────────────────────────────────────────
+// Sorted keys, URLs and file paths repeat most of the previous row, and a
+// plain column stores that shared prefix again in every row.  Here each row
+// stores how many leading tokens it shares with the row before, plus only
+// the tokens after them.  Every restart_interval()-th row is a restart
+// point and stores all its tokens, so random access decodes at most that
+// many rows.
+//
+// Built from an OnPairColumn, whose token streams it compares and re-packs
+// without re-parsing; the dictionary is shared.  Rows whose bytes share a
+// prefix usually share tokens too, since the greedy parse takes the same
+// tokens up to shortly before the bytes diverge.  A run of identical rows
+// costs no tokens at all.  Validity and deletions are carried over.
+//
+// Scans rebuild each row and, for Resumable automata (token_automaton.h),
+// resume from the state saved at the end of the shared prefix instead of
+// stepping it again (see scan_front_coded_impl).  The shared count is kept
+// in 16 bits; a longer common prefix is stored in part.
+
+inline constexpr size_t FRONT_CODING_RESTART     = 16;
+inline constexpr size_t MAX_FRONT_CODING_RESTART = 1024;
+
+class FrontCodedColumn {
+public:
+    // Throws std::invalid_argument unless
+    // 1 <= restart_interval <= MAX_FRONT_CODING_RESTART.
+    static FrontCodedColumn encode(const OnPairColumn& col,
+                                   size_t restart_interval = FRONT_CODING_RESTART);
+
+    template<std::ranges::input_range Range>
+        requires std::convertible_to<std::ranges::range_value_t<Range>, std::string_view>
+    static FrontCodedColumn compress(Range&& strings,
+                                     const OnPairColumn::Config& cfg = {},
+                                     size_t restart_interval = FRONT_CODING_RESTART) {
+        return encode(OnPairColumn::compress(std::forward<Range>(strings), cfg),
+                      restart_interval);
+    }
+
+    // ── Metadata ──────────────────────────────────────────────────────────────
+    size_t   num_strings()      const noexcept { return store_.num_strings(); }
+    BitWidth bits()             const noexcept { return store_.bit_width; }
+    size_t   restart_interval() const noexcept { return restart_; }
+    size_t   num_tokens()       const noexcept { return store_.num_tokens(); }   // stored
+    size_t   bytes_used()       const noexcept {
+        return store_.bytes_used() + shared_.size() * sizeof(uint16_t)
+             + dictionary().bytes_used();
+    }
+
+    // Leading tokens row `idx` shares with row idx - 1.
+    size_t shared_tokens(size_t idx) const noexcept { return shared_[idx]; }
+
+    bool is_valid(size_t idx)   const noexcept { return is_valid_row(validity_ptr(), idx); }
+    bool is_deleted(size_t idx) const noexcept { return is_deleted_row(deleted_ptr(), idx); }
+
+    DictionaryView dictionary() const noexcept {
+        static const Dictionary empty;
+        return dict_ ? *dict_ : empty;
+    }
+    const std::shared_ptr<const Dictionary>& shared_dictionary() const noexcept {
+        return dict_;
+    }
+
+    // ── Random access ─────────────────────────────────────────────────────────
+    // Walks back to the restart point and decodes, for each row up to `idx`,
+    // only the tokens that survive into row `idx`.  Null and deleted rows
+    // decompress as empty strings.  buf needs DECOMPRESS_BUFFER_PADDING.
+    size_t decompress(size_t idx, char* buf) const noexcept;
+
+    // ── Bulk decompression ────────────────────────────────────────────────────
+    // One slot per row, as OnPairColumnView::decompress_all.  Each row copies
+    // its shared prefix from the previous row's bytes in one memmove and
+    // decodes only its own tokens.  buf must hold every row, deleted rows
+    // included, plus DECOMPRESS_BUFFER_PADDING; deleted rows then occupy
+    // empty slots.
+    size_t decompress_all(char* buf, uint32_t* out_offsets) const;
+
+    // ── Search ────────────────────────────────────────────────────────────────
+    template<typename A, std::invocable<size_t> F>
+        requires search::TokenAutomaton<std::remove_reference_t<A>>
+    void scan(A&& aut, F&& on_match) const {
+        if (num_strings() == 0) return;
+        dispatch_bits(bits(), [&](auto bits) {
+            search::detail::scan_front_coded_impl<bits.value>(
+                aut, store_.packed.data(), store_.boundaries.data(), shared_.data(),
+                RowFilter{validity_ptr(), deleted_ptr()}, num_strings(),
+                max_row_tokens_, on_match);
+        });
+    }
+
+    template<typename A>
+        requires search::TokenAutomaton<std::remove_reference_t<A>>
+    std::vector<size_t> scan(A&& aut) const {
+        std::vector<size_t> result;
+        scan(aut, [&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+    std::vector<size_t> contains(std::string_view pattern) const {
+        if (pattern.size() == 1)
+            return scan(search::TokenSetAutomaton::any_of(pattern, dictionary()));
+        return scan(search::KmpAutomaton(pattern, dictionary()));
+    }
+    std::vector<size_t> starts_with(std::string_view prefix) const {
+        return scan(search::PrefixAutomaton(prefix, dictionary()));
+    }
+    std::vector<size_t> equals(std::string_view value) const {
+        return scan(search::EqAutomaton(value, dictionary()));
+    }
+
+    // ── Lifecycle ─────────────────────────────────────────────────────────────
+    FrontCodedColumn()                                   = default;
+    FrontCodedColumn(FrontCodedColumn&&)                 = default;
+    FrontCodedColumn& operator=(FrontCodedColumn&&)      = default;
+    FrontCodedColumn(const FrontCodedColumn&)            = delete;
+    FrontCodedColumn& operator=(const FrontCodedColumn&) = delete;
+
+private:
+    std::shared_ptr<const Dictionary> dict_;
+    Store                 store_{9, {}, {}};   // tokens after each row's shared prefix
+    std::vector<uint16_t> shared_;             // per row; 0 at restart points
+    size_t                restart_        = FRONT_CODING_RESTART;
+    size_t                max_row_tokens_ = 0; // longest row, shared tokens included
+    std::vector<uint64_t> validity_;           // empty when no row is null
+    std::vector<uint64_t> deleted_;            // empty when no row is deleted
+
+    const uint64_t* validity_ptr() const noexcept {
+        return validity_.empty() ? nullptr : validity_.data();
+    }
+    const uint64_t* deleted_ptr() const noexcept {
+        return deleted_.empty() ? nullptr : deleted_.data();
+    }
+};
+
+// ─── Decompression (inline definitions) ──────────────────────────────────────
+
+inline size_t FrontCodedColumn::decompress(size_t idx, char* buf) const noexcept {
+    if (is_deleted(idx)) return 0;
+    const uint32_t* bounds = store_.boundaries.data();
+    const size_t    first  = idx - idx % restart_;
+
+    // keep[j - first]: leading tokens of row j that survive into row idx.
+    // Row j contributes its stored tokens up to that count.
+    uint32_t keep[MAX_FRONT_CODING_RESTART];
+    uint32_t k = shared_[idx] + (bounds[idx + 1] - bounds[idx]);
+    for (size_t j = idx + 1; j-- > first;) {
+        keep[j - first] = k;
+        k = std::min<uint32_t>(k, shared_[j]);
+    }
+
+    const DictionaryView dv     = dictionary();
+    const uint8_t*  dict_bytes  = dv.raw_bytes();
+    const uint32_t* dict_offs   = dv.raw_offsets();
+    auto* out = reinterpret_cast<uint8_t*>(buf);
+    size_t pos = 0;
+    dispatch_bits(bits(), [&](auto bits) {
+        decoding::TokenCursor<bits.value> cursor(store_.packed.data());
+        for (size_t j = first; j <= idx; ++j) {
+            if (keep[j - first] <= shared_[j]) continue;
+            const uint32_t begin = bounds[j];
+            cursor.reset_to(StreamSpan{begin, begin + keep[j - first] - shared_[j]});
+            while (cursor.has_more()) {
+                const Token    t   = cursor.next();
+                const uint32_t off = dict_offs[t];
+                std::memcpy(out + pos, dict_bytes + off, MAX_TOKEN_SIZE);
+                pos += dict_offs[t + 1] - off;
+            }
+        }
+    });
+    return pos;
+}
+
+inline size_t FrontCodedColumn::decompress_all(char* buf, uint32_t* out_offsets) const {
+    const size_t n = num_strings();
+    out_offsets[0] = 0;
+    if (n == 0) return 0;
+
+    const uint32_t* bounds = store_.boundaries.data();
+    const DictionaryView dv    = dictionary();
+    const uint8_t*  dict_bytes = dv.raw_bytes();
+    const uint32_t* dict_offs  = dv.raw_offsets();
+    auto* out = reinterpret_cast<uint8_t*>(buf);
+
+    // ends[k]: byte end of token k of the last row, from the row's start.
+    std::vector<uint32_t> ends(max_row_tokens_);
+    size_t pos = 0, prev = 0;     // start of this row and of the last one
+    dispatch_bits(bits(), [&](auto bits) {
+        decoding::TokenCursor<bits.value> cursor(store_.packed.data());
+        for (size_t i = 0; i < n; ++i) {
+            out_offsets[i] = static_cast<uint32_t>(pos);
+            size_t   k   = shared_[i];
+            uint32_t len = k ? ends[k - 1] : 0;
+            if (len && prev != pos) std::memmove(out + pos, out + prev, len);
+
+            cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+            while (cursor.has_more()) {
+                const Token    t   = cursor.next();
+                const uint32_t off = dict_offs[t];
+                std::memcpy(out + pos + len, dict_bytes + off, MAX_TOKEN_SIZE);
+                len += dict_offs[t + 1] - off;
+                ends[k++] = len;
+            }
+            // A deleted row is rebuilt for the next one to copy from, then
+            // overwritten by it.
+            prev = pos;
+            if (!is_deleted(i)) pos += len;
+        }
+    });
+    out_offsets[n] = static_cast<uint32_t>(pos);
+    return pos;
+}
+
+} // namespace onpair
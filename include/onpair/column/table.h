@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Table compression inputs.
+//
+// OnPairColumn::compress_table() compresses many columns at once, on the
+// caller's executor or on threads of its own.
+//
+// - Columns are taken largest first.  A worker that finishes a small column
+//   pulls the next one, so one wide column does not serialise the tail.
+// - A job's working set is estimated up front (see TableOptions).  No job
+//   starts while the jobs in flight plus it would exceed memory_budget.  A
+//   job larger than the whole budget still runs, but alone.
+// - Columns with the same shared_group train one dictionary together, as in
+//   compress_shared().  The group trains once, with the Config of its first
+//   column, and then its columns are parsed as separate jobs.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+// One Arrow-style input column: data[offsets[i], offsets[i + 1]) is row i;
+// `validity` (LSB-first bitmap, clear = NULL) may be null.
+struct TableColumn {
+    const char*     data     = nullptr;
+    const uint32_t* offsets  = nullptr;
+    size_t          n        = 0;
+    const uint8_t*  validity = nullptr;
+
+    static constexpr int NO_GROUP = -1;
+    int shared_group = NO_GROUP;   // >= 0: share a dictionary with that group
+};
+
+struct TableOptions {
+    // Workers.  0 means std::thread::hardware_concurrency().  The calling
+    // thread is always one of them.
+    unsigned threads = 0;
+
+    // Upper bound on the estimated working set of all jobs in flight, in
+    // bytes; 0 means unbounded.  A job is estimated at twice its input bytes
+    // (input plus packed output), plus four bytes per row of boundaries,
+    // plus 64 bytes per dictionary slot for training.
+    size_t memory_budget = 0;
+};
+
+// A job sink: executor(task) must run task() once, on any thread, inline or
+// later.  A thread pool's submit() wrapped in a lambda qualifies.
+using TableExecutor = std::function<void(std::function<void()>)>;
+
+} // namespace onpair
@@ -0,0 +1,158 @@
+#pragma once
+#include <onpair/column/column.h>
+#include <onpair/encoding/training/templates.h>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace onpair {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TemplateColumn — structured IDs as template id plus packed integers
+// ─────────────────────────────────────────────────────────────────────────────
+// compress() mines templates from the input (see templates.h).  Each row
+// matching one is stored as a tag naming the template plus one integer per
+// numeric field.  Each field is bit-packed at the width of its own value
+// range, frame-of-reference from its smallest value.  Every other row goes
+// to a fallback OnPairColumn, trained on those rows alone.
+//
+// Tags are packed at 1, 2, 4 or 8 bits per row.  Every RANK_BLOCK rows a
+// directory records how many rows of each tag came before, so random
+// access finds a row's slot among its template's values with a short
+// count inside one block.
+//
+// Predicates work on the integers.  equals() parses the value with the
+// same templates and compares field values, and starts_with() turns a
+// prefix into a value interval per field.  A prefix ending inside a field
+// gives a range, so 'user_0004' keeps user_000400 through user_000499.
+// field_between() is a plain integer range test.  Rows in the fallback are
+// searched there.
+//
+// Nulls are not supported.
+
+class TemplateColumn {
+public:
+    using Config = encoding::TrainingConfig;
+
+    static constexpr uint32_t NO_TEMPLATE = encoding::TemplateSet::NO_MATCH;
+    static constexpr size_t   RANK_BLOCK  = 256;
+
+    template<std::ranges::input_range Range>
+        requires std::convertible_to<std::ranges::range_value_t<Range>, std::string_view>
+    static TemplateColumn compress(Range&& strings, const Config& cfg = {},
+                                   const encoding::TemplateConfig& tcfg = {});
+
+    static TemplateColumn compress(const char* data, const uint32_t* offsets,
+                                   size_t n, const Config& cfg = {},
+                                   const encoding::TemplateConfig& tcfg = {});
+
+    // ── Metadata ──────────────────────────────────────────────────────────────
+    size_t num_strings()   const noexcept { return n_; }
+    size_t num_templates() const noexcept { return templates_.size(); }
+    size_t bytes_used()    const noexcept;
+
+    const encoding::TemplateSet& templates() const noexcept { return templates_; }
+
+    // The template row `idx` is stored with, or NO_TEMPLATE.
+    uint32_t template_of(size_t idx) const noexcept { return tag(idx) - 1; }
+
+    // Rows that fit no template, in row order.
+    const OnPairColumn& fallback() const noexcept { return fallback_; }
+
+    // ── Decompression ─────────────────────────────────────────────────────────
+    // buf needs DECOMPRESS_BUFFER_PADDING, as for OnPairColumnView.
+    size_t decompress(size_t idx, char* buf) const noexcept;
+    size_t decompress_all(char* buf, uint32_t* out_offsets) const;
+
+    // ── Search ────────────────────────────────────────────────────────────────
+    // Row ids in ascending order.
+    std::vector<size_t> equals(std::string_view value) const;
+    std::vector<size_t> starts_with(std::string_view prefix) const;
+
+    // Rows of template t whose field `field` lies in [lo, hi].
+    // Throws std::out_of_range for a bad template or field.
+    std::vector<size_t> field_between(uint32_t t, size_t field,
+                                      uint64_t lo, uint64_t hi) const;
+
+    // ── Lifecycle ─────────────────────────────────────────────────────────────
+    TemplateColumn()                                 = default;
+    TemplateColumn(TemplateColumn&&)                 = default;
+    TemplateColumn& operator=(TemplateColumn&&)      = default;
+    TemplateColumn(const TemplateColumn&)            = delete;
+    TemplateColumn& operator=(const TemplateColumn&) = delete;
+
+private:
+    // One numeric field of one template: value = base + packed[i].
+    struct Field {
+        uint64_t              base = 0;
+        unsigned              bits = 0;
+        std::vector<uint64_t> packed;
+
+        uint64_t get(size_t i) const noexcept {
+            if (bits == 0) return base;
+            const size_t   bit = i * bits;
+            const size_t   w   = bit >> 6, s = bit & 63;
+            uint64_t       v   = packed[w] >> s;
+            if (s + bits > 64) v |= packed[w + 1] << (64 - s);
+            return base + (bits == 64 ? v : v & ((uint64_t(1) << bits) - 1));
+        }
+    };
+
+    // Allowed value intervals per field; an empty list allows any value.
+    using Intervals = std::vector<std::pair<uint64_t, uint64_t>>;
+    using Filter    = std::array<Intervals, encoding::MAX_TEMPLATE_FIELDS>;
+
+    size_t                          n_ = 0;
+    encoding::TemplateSet           templates_;
+    std::vector<std::vector<Field>> fields_;      // [template][field]
+    unsigned                        tag_bits_ = 0;
+    std::vector<uint64_t>           tags_;        // 0 = fallback, t + 1 = template t
+    std::vector<uint32_t>           rank_;        // [block][tag]: rows of tag before block
+    OnPairColumn                    fallback_;
+    size_t                          fallback_bytes_ = 0;   // decompressed size
+
+    uint32_t tag(size_t i) const noexcept {
+        if (tag_bits_ == 0) return 0;
+        const size_t bit = i * tag_bits_;
+        return uint32_t(tags_[bit >> 6] >> (bit & 63)) & ((1u << tag_bits_) - 1);
+    }
+    // Rows before `i` with tag `t`.
+    size_t rank(uint32_t t, size_t i) const noexcept;
+
+    static TemplateColumn compress_raw(const uint8_t* data, const uint32_t* offsets,
+                                       size_t n, const Config& cfg,
+                                       const encoding::TemplateConfig& tcfg);
+
+    // Whether row r of template t passes `filter`.
+    bool fields_match(uint32_t t, const Filter& filter, size_t r) const noexcept;
+    void scan_template(uint32_t t, const Filter& filter, std::vector<size_t>& out) const;
+    void add_fallback(const std::vector<size_t>& hits, std::vector<size_t>& out) const;
+};
+
+// ─── TemplateColumn::compress<Range> (template definition) ───────────────────
+
+template<std::ranges::input_range Range>
+    requires std::convertible_to<std::ranges::range_value_t<Range>, std::string_view>
+TemplateColumn TemplateColumn::compress(Range&& strings, const Config& cfg,
+                                        const encoding::TemplateConfig& tcfg)
+{
+    std::vector<uint8_t>  data;
+    std::vector<uint32_t> offsets{0};
+
+    for (const auto& s : strings) {
+        const std::string_view sv = s;
+        data.insert(data.end(),
+                    reinterpret_cast<const uint8_t*>(sv.data()),
+                    reinterpret_cast<const uint8_t*>(sv.data()) + sv.size());
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+    }
+
+    return compress_raw(data.data(), offsets.data(), offsets.size() - 1, cfg, tcfg);
+}
+
+} // namespace onpair
@@ -0,0 +1,75 @@
+#pragma once
+#include <onpair/core/store.h>
+#include <onpair/core/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Entropy-coded token store for cold storage.
+//
+// A Store spends `bit_width` bits on every token, whatever its frequency.
+// Token frequencies are skewed, so a canonical Huffman code over them is
+// markedly shorter: ColdStore is that code, for archival copies that are
+// written once and read rarely.  It is never scanned; decode() transcodes
+// it back to the fixed-width Store the decoders and automata read.
+//
+//   code lengths    one byte per token id, at most MAX_COLD_CODE_LENGTH
+//   blocks          COLD_BLOCK_TOKENS tokens each, byte aligned; the block
+//                   index holds each block's byte offset
+//   row lengths     tokens per row as LEB128 varints, in place of the
+//                   uint32_t boundaries
+//
+// A block of COLD_BLOCK_TOKENS tokens fills whole uint64_t words of the
+// fixed-width store, so decode() hands blocks to threads that write
+// disjoint words.  Codes are read MSB-first, two per refill, through a
+// 12-bit lookup table; longer codes fall back to a canonical search.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+inline constexpr size_t COLD_BLOCK_TOKENS    = size_t(1) << 16;
+inline constexpr size_t MAX_COLD_CODE_LENGTH = 24;
+
+class ColdStore {
+public:
+    ColdStore() = default;
+
+    // `frequency[t]` counts token t in `store`, as
+    // ColumnStatistics::token_frequency does; when it is empty or misses a
+    // token that occurs, the tokens are counted from the store.
+    static ColdStore encode(const Store& store, std::span<const uint32_t> frequency = {});
+
+    // The fixed-width store, sentinel word included.  `threads` 0 means
+    // std::thread::hardware_concurrency(); at most one thread per block.
+    Store decode(unsigned threads = 0) const;
+
+    size_t   num_strings() const noexcept { return rows_; }
+    size_t   num_tokens()  const noexcept { return tokens_; }
+    BitWidth bit_width()   const noexcept { return bits_; }
+    size_t   num_blocks()  const noexcept { return blocks_.size(); }
+    size_t   bytes_used()  const noexcept {
+        return lengths_.size() + row_lengths_.size() + blocks_.size() * sizeof(uint64_t)
+             + (payload_.empty() ? 0 : payload_.size() - PAYLOAD_PADDING);
+    }
+
+    // Throws std::runtime_error on a truncated or corrupt stream.
+    void             write_to(std::ostream& out) const;
+    static ColdStore read_from(std::istream& in);
+
+private:
+    // The decoder loads 8 bytes at a time, up to 8 bytes past a block.
+    static constexpr size_t PAYLOAD_PADDING = 8;
+
+    BitWidth              bits_   = 9;
+    size_t                rows_   = 0;
+    size_t                tokens_ = 0;
+    std::vector<uint8_t>  lengths_;       // code length per token id; 0 = unused
+    std::vector<uint8_t>  row_lengths_;   // LEB128 tokens per row
+    std::vector<uint64_t> blocks_;        // byte offset of each block in payload_
+    std::vector<uint8_t>  payload_;       // codes, then PAYLOAD_PADDING zero bytes
+};
+
+} // namespace onpair
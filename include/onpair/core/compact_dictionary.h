@@ -0,0 +1,104 @@
+#pragma once
+#include <onpair/core/dictionary.h>
+#include <onpair/core/types.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Compact dictionary storage.
+//
+// A Dictionary spends a uint32_t offset per token next to token bytes that,
+// being sorted, mostly repeat the token before: a 16-bit dictionary is
+// around 1 MB.  CompactDictionary front-codes the tokens in blocks of
+// COMPACT_DICT_BLOCK.  Each token is one header byte, the length it shares
+// with the previous token in the high nibble and its suffix length minus
+// one in the low nibble, followed by the suffix bytes.  The first token of
+// a block shares nothing.  One uint32_t per block locates it, so a single
+// token decodes from at most COMPACT_DICT_BLOCK headers.
+//
+// Lengths fit the nibbles because tokens are 1..MAX_TOKEN_SIZE bytes and a
+// suffix is never empty: a token equal to the previous one, or a prefix of
+// it, shares one byte less.
+//
+// The compact form is for storage.  Decoders and automata read the flat
+// Dictionary layout, which expand() rebuilds in one pass.  LazyDictionary
+// holds a compact dictionary and expands it the first time it is asked for
+// the flat one.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+inline constexpr size_t COMPACT_DICT_BLOCK = 16;
+
+class CompactDictionary {
+public:
+    CompactDictionary() = default;
+
+    // Throws std::invalid_argument for an empty token or one longer than
+    // MAX_TOKEN_SIZE.
+    static CompactDictionary encode(const Dictionary& dict);
+
+    // Rebuild from num_tokens() and bytes(), as written to a file.
+    // Throws std::runtime_error when `bytes` does not hold exactly
+    // `num_tokens` well-formed tokens.
+    static CompactDictionary from_bytes(size_t num_tokens, std::vector<uint8_t> bytes);
+
+    size_t num_tokens() const noexcept { return n_; }
+    size_t bytes_used() const noexcept {
+        return bytes_.size() + blocks_.size() * sizeof(uint32_t);
+    }
+    const std::vector<uint8_t>& bytes() const noexcept { return bytes_; }
+
+    // Write token `id` to `out` (MAX_TOKEN_SIZE bytes) and return its length.
+    size_t token(Token id, uint8_t* out) const noexcept;
+
+    // The flat layout, padded for the decoder.
+    Dictionary expand() const;
+
+private:
+    size_t                n_ = 0;
+    std::vector<uint8_t>  bytes_;    // header + suffix per token
+    std::vector<uint32_t> blocks_;   // byte offset of each block in bytes_
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LazyDictionary — a compact dictionary expanded on first use
+// ─────────────────────────────────────────────────────────────────────────────
+// get() expands once and keeps the result; concurrent first calls expand
+// once between them.  The compact form stays, so a fresh LazyDictionary
+// over the same compact() drops the expansion without re-encoding.
+
+class LazyDictionary {
+public:
+    explicit LazyDictionary(std::shared_ptr<const CompactDictionary> compact) noexcept
+        : compact_(std::move(compact)) {}
+
+    const std::shared_ptr<const Dictionary>& get() const {
+        if (!ready_.load(std::memory_order_acquire)) {
+            std::lock_guard lock(mutex_);
+            if (!ready_.load(std::memory_order_relaxed)) {
+                expanded_ = std::make_shared<const Dictionary>(compact_->expand());
+                ready_.store(true, std::memory_order_release);
+            }
+        }
+        return expanded_;
+    }
+
+    bool expanded() const noexcept { return ready_.load(std::memory_order_acquire); }
+
+    const std::shared_ptr<const CompactDictionary>& compact() const noexcept {
+        return compact_;
+    }
+
+private:
+    std::shared_ptr<const CompactDictionary>  compact_;
+    mutable std::mutex                        mutex_;
+    mutable std::atomic<bool>                 ready_{false};
+    mutable std::shared_ptr<const Dictionary> expanded_;
+};
+
+} // namespace onpair
@@ -0,0 +1,117 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Dictionary drift.
+//
+// A dictionary is trained once and then frozen, so rows appended later are
+// encoded with tokens chosen for the training data.  When the data shifts,
+// matches get shorter: bytes per token fall, tokens per row rise, the column
+// grows and every scan steps more tokens.
+//
+// DriftMonitor compares the rows encoded since training against the
+// baseline measured over the training input.  Recent rows are weighted by an
+// exponential window of DriftPolicy::window_rows, so a shift that arrives
+// after a long stable period shows up within about one window rather than
+// being averaged away.  retrain_recommended() turns the comparison into a
+// yes/no signal once enough rows have been observed.
+//
+// Tokens per row also rise when values merely get longer, with no change in
+// how well the dictionary fits, so only bytes per token gates the signal by
+// default.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+// Encoded volume: rows, their uncompressed bytes, and the tokens they took.
+struct DriftTotals {
+    double rows   = 0;
+    double bytes  = 0;
+    double tokens = 0;
+
+    double bytes_per_token() const noexcept { return tokens ? bytes / tokens : 0.0; }
+    double tokens_per_row()  const noexcept { return rows   ? tokens / rows  : 0.0; }
+};
+
+struct DriftPolicy {
+    // Recommend retraining when recent bytes/token drop below this fraction
+    // of the baseline.
+    double min_bytes_per_token_ratio = 0.85;
+
+    // ... or when recent tokens/row exceed this multiple of the baseline.
+    // 0 disables the check.
+    double max_tokens_per_row_ratio = 0.0;
+
+    // No recommendation before this many rows have been observed.
+    uint64_t min_rows = 4096;
+
+    // Observations lose weight by e^-1 for every window_rows newer rows.
+    uint64_t window_rows = 65536;
+
+    bool operator==(const DriftPolicy&) const = default;
+};
+
+class DriftMonitor {
+public:
+    DriftMonitor() = default;
+
+    explicit DriftMonitor(DriftTotals baseline, DriftPolicy policy = {}) noexcept
+        : policy_(policy), baseline_(baseline) {}
+
+    // Restore a monitor written out with the accessors below.
+    DriftMonitor(DriftTotals baseline, DriftTotals recent,
+                 uint64_t observed_rows, DriftPolicy policy) noexcept
+        : policy_(policy), baseline_(baseline), recent_(recent),
+          observed_rows_(observed_rows) {}
+
+    // Record a batch of newly encoded rows.
+    void observe(uint64_t rows, uint64_t bytes, uint64_t tokens) noexcept {
+        const double keep = policy_.window_rows
+            ? std::exp(-double(rows) / double(policy_.window_rows)) : 0.0;
+        recent_.rows   = recent_.rows   * keep + double(rows);
+        recent_.bytes  = recent_.bytes  * keep + double(bytes);
+        recent_.tokens = recent_.tokens * keep + double(tokens);
+        observed_rows_ += rows;
+    }
+
+    // A baseline with no tokens (no rows, or only empty ones) gives nothing
+    // to compare against, and never recommends retraining.
+    bool has_baseline() const noexcept { return baseline_.tokens > 0; }
+
+    const DriftTotals& baseline() const noexcept { return baseline_; }
+    const DriftTotals& recent()   const noexcept { return recent_;   }
+    uint64_t observed_rows()      const noexcept { return observed_rows_; }
+
+    // Recent / baseline; 1.0 while either side is undefined.
+    double bytes_per_token_ratio() const noexcept {
+        return ratio(recent_.bytes_per_token(), baseline_.bytes_per_token(),
+                     recent_.tokens);
+    }
+    double tokens_per_row_ratio() const noexcept {
+        return ratio(recent_.tokens_per_row(), baseline_.tokens_per_row(),
+                     recent_.rows);
+    }
+
+    bool retrain_recommended() const noexcept {
+        if (!has_baseline() || observed_rows_ < policy_.min_rows) return false;
+        if (bytes_per_token_ratio() < policy_.min_bytes_per_token_ratio) return true;
+        return policy_.max_tokens_per_row_ratio > 0 &&
+               tokens_per_row_ratio() > policy_.max_tokens_per_row_ratio;
+    }
+
+    const DriftPolicy& policy() const noexcept { return policy_; }
+    void set_policy(const DriftPolicy& policy) noexcept { policy_ = policy; }
+
+private:
+    static double ratio(double recent, double base, double support) noexcept {
+        return (support > 0 && base > 0) ? recent / base : 1.0;
+    }
+
+    DriftPolicy policy_;
+    DriftTotals baseline_;
+    DriftTotals recent_;
+    uint64_t    observed_rows_ = 0;
+};
+
+} // namespace onpair
@@ -0,0 +1,114 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Generator<T> — minimal lazy C++20 coroutine generator.
+//
+// std::generator arrives in C++23; the library targets C++20, so this is
+// the small subset its scans need.  The coroutine starts suspended and runs
+// only when the consumer pulls: next() resumes it up to its next co_yield,
+// then value() refers to the yielded object until the following next().
+// It is also an input range, so range-for works.
+//
+// Move-only.  Destroying a generator that has not finished destroys the
+// suspended coroutine frame, and with it everything the body held.  An
+// exception escaping the body is rethrown from next().
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+template<typename T>
+class Generator {
+public:
+    struct promise_type {
+        const T*           current = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object() noexcept {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend()   const noexcept { return {}; }
+
+        // The yielded object lives in the suspended co_yield expression.
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+
+        // Generators only yield.
+        template<typename U> std::suspend_never await_transform(U&&) = delete;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    Generator(Generator&& other) noexcept
+        : h_(std::exchange(other.h_, nullptr)) {}
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(other.h_, nullptr);
+        }
+        return *this;
+    }
+    Generator(const Generator&)            = delete;
+    Generator& operator=(const Generator&) = delete;
+    ~Generator() { if (h_) h_.destroy(); }
+
+    // Run to the next co_yield.  False once the body has returned.
+    bool next() {
+        if (!h_ || h_.done()) return false;
+        h_.resume();
+        if (h_.promise().error)
+            std::rethrow_exception(std::exchange(h_.promise().error, nullptr));
+        return !h_.done();
+    }
+
+    // The value of the last co_yield; valid until the next call to next().
+    const T& value() const noexcept { return *h_.promise().current; }
+
+    // ── Input range ───────────────────────────────────────────────────────────
+    class iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type       = T;
+        using difference_type  = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(Generator* g) noexcept : g_(g) {}
+
+        const T& operator*() const noexcept { return g_->value(); }
+        iterator& operator++() {
+            if (!g_->next()) g_ = nullptr;
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+            return it.g_ == nullptr;
+        }
+
+    private:
+        Generator* g_ = nullptr;
+    };
+
+    iterator begin() {
+        iterator it(this);
+        ++it;
+        return it;
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    explicit Generator(handle_type h) noexcept : h_(h) {}
+
+    handle_type h_;
+};
+
+} // namespace onpair
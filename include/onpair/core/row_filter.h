@@ -0,0 +1,83 @@
+#pragma once
+#include <onpair/core/validity.h>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Deletion vector and RowFilter.
+//
+// A deletion vector marks rows removed from a column (row deletes, erasure):
+// bit i (LSB-first, 64-bit words) set means row i is deleted.  Deleted rows
+// keep their row ids and their tokens until OnPairColumn::compact() rewrites
+// the store; until then every scan and decoder treats them as absent.  Bits
+// past the last row are kept clear.
+//
+// RowFilter combines the validity bitmap (validity.h) with the deletion
+// vector: a row passes when it is valid and not deleted.  Either pointer may
+// be null; an empty filter passes every row.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+inline bool is_deleted_row(const uint64_t* deleted, size_t i) noexcept {
+    return deleted && ((deleted[i >> 6] >> (i & 63)) & 1u);
+}
+
+inline size_t count_deleted(const uint64_t* deleted, size_t n) noexcept {
+    if (!deleted) return 0;
+    size_t count = 0;
+    for (size_t w = 0; w < validity_words(n); ++w)
+        count += size_t(std::popcount(deleted[w]));
+    return count;
+}
+
+struct RowFilter {
+    const uint64_t* validity = nullptr;   // set = valid
+    const uint64_t* deleted  = nullptr;   // set = deleted
+
+    explicit operator bool() const noexcept { return validity || deleted; }
+
+    bool passes(size_t i) const noexcept {
+        return is_valid_row(validity, i) && !is_deleted_row(deleted, i);
+    }
+
+    // Passing rows of word w, for a column of n rows.
+    uint64_t word(size_t w, size_t n) const noexcept {
+        uint64_t m = validity ? validity[w] : ~uint64_t(0);
+        if (deleted) m &= ~deleted[w];
+        if (w == n / 64) m &= (uint64_t(1) << (n % 64)) - 1;
+        return m;
+    }
+};
+
+// Call fn(i) for every row in [0, n) that passes `filter`, in ascending
+// order, walking the set bits of each combined word.
+template<typename Fn>
+void for_each_passing(RowFilter filter, size_t n, Fn&& fn) {
+    if (!filter) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+    for (size_t w = 0; w < validity_words(n); ++w) {
+        for (uint64_t m = filter.word(w, n); m; m &= m - 1)
+            fn(w * 64 + size_t(std::countr_zero(m)));
+    }
+}
+
+// As above, restricted to rows [begin, end) of the column.
+template<typename Fn>
+void for_each_passing(RowFilter filter, size_t begin, size_t end, Fn&& fn) {
+    if (!filter) {
+        for (size_t i = begin; i < end; ++i) fn(i);
+        return;
+    }
+    for (size_t w = begin / 64; w * 64 < end; ++w) {
+        uint64_t m = filter.word(w, end);
+        if (w == begin / 64) m &= ~uint64_t(0) << (begin % 64);
+        for (; m; m &= m - 1)
+            fn(w * 64 + size_t(std::countr_zero(m)));
+    }
+}
+
+} // namespace onpair
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// RunControl — cancellation and progress for long column operations.
+//
+// The controlled overloads of scan(), decompress_all() and compress() work
+// through the rows in blocks of `block_rows`.  Before each block they test
+// `stop`, and after each block they call `progress(rows_done, total_rows)`.
+// Nothing is checked inside a block, so the per-row loops are the same as in
+// the plain overloads, which stay unchanged.
+//
+// A cancelled run stops at a block boundary and returns RunStatus::Cancelled.
+// Its RunResult::rows says how far it got: rows [0, rows) were fully
+// processed, and nothing past them was.
+//
+//   std::stop_source src;                 // src.request_stop() from any thread
+//   RunControl ctl{src.get_token(), [](size_t done, size_t total) { ... }};
+//   RunResult r = view.scan(kmp, on_match, ctl);
+//   if (!r.complete()) ...                // matches cover rows [0, r.rows)
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+inline constexpr size_t RUN_BLOCK_ROWS = size_t(1) << 16;
+
+struct RunControl {
+    std::stop_token                               stop;       // default: never stops
+    std::function<void(size_t done, size_t total)> progress;  // may be empty
+    size_t                                        block_rows = RUN_BLOCK_ROWS;
+
+    bool stop_requested() const noexcept { return stop.stop_requested(); }
+
+    void report(size_t done, size_t total) const {
+        if (progress) progress(done, total);
+    }
+
+    // Block length actually used: block_rows rounded up to a whole number of
+    // 64-row bitmap words, so a block never splits a validity word.
+    size_t block() const noexcept {
+        return block_rows <= 64 ? 64 : (block_rows + 63) & ~size_t(63);
+    }
+};
+
+enum class RunStatus : uint8_t { Complete, Cancelled };
+
+struct RunResult {
+    RunStatus status = RunStatus::Complete;
+    size_t    rows   = 0;   // rows [0, rows) were processed
+    size_t    bytes  = 0;   // bytes decoded, or input bytes compressed
+
+    bool complete() const noexcept { return status == RunStatus::Complete; }
+};
+
+} // namespace onpair
@@ -0,0 +1,57 @@
+#pragma once
+#include <onpair/analytics/hyperloglog.h>
+#include <onpair/core/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Column statistics.
+//
+// Optional per-column facts gathered by parse() while the input is hot
+// (TrainingConfig::collect_statistics) and persisted with the column, so a
+// planner or zone map can answer basic questions without scanning.
+//
+// min/max value are stored as token prefixes in the column's dictionary: the
+// first STATS_PREFIX_TOKENS tokens of the byte-wise smallest and largest
+// strings.  When *_exact is false the prefix is truncated — every value is
+// still ≥ the decoded min prefix, and every value is < the successor of the
+// decoded max prefix.
+//
+// token_count_histogram[k] counts rows of k tokens; the last bucket collects
+// every row of STATS_HISTOGRAM_BUCKETS - 1 tokens or more.
+// token_frequency[t] counts occurrences of token t across the column.
+// distinct is a HyperLogLog over the token-sequence hashes (TokenHasher).
+// Null rows are stored, and therefore counted, as empty strings.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+inline constexpr size_t  STATS_PREFIX_TOKENS     = 8;
+inline constexpr size_t  STATS_HISTOGRAM_BUCKETS = 64;
+inline constexpr uint8_t STATS_HLL_PRECISION     = 12;   // 4 KiB, ~1.6 % error
+
+struct ColumnStatistics {
+    uint64_t num_strings = 0;
+    uint64_t total_bytes = 0;       // uncompressed size
+    uint32_t min_length  = 0;
+    uint32_t max_length  = 0;
+    uint64_t empty_count = 0;
+
+    std::vector<Token> min_prefix;
+    std::vector<Token> max_prefix;
+    bool               min_exact = true;
+    bool               max_exact = true;
+
+    std::vector<uint64_t> token_count_histogram;
+    std::vector<uint32_t> token_frequency;
+
+    analytics::HyperLogLog distinct{STATS_HLL_PRECISION};
+
+    double mean_length() const noexcept {
+        return num_strings ? double(total_bytes) / double(num_strings) : 0.0;
+    }
+    double distinct_estimate() const noexcept { return distinct.estimate(); }
+};
+
+} // namespace onpair
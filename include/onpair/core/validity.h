@@ -0,0 +1,66 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Validity bitmap.
+//
+// Arrow-compatible null mask: bit i (LSB-first) set means row i is valid,
+// clear means NULL.  It is held as 64-bit words so scans can test and skip 64
+// rows at a time; on little-endian targets the words' bytes are exactly the
+// Arrow byte bitmap.  Bits past the last row are kept clear.
+//
+// A column without nulls stores no bitmap at all — an empty vector, or a
+// nullptr in views — and every helper below treats nullptr as all-valid.
+// Null rows are stored as empty token sequences.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair {
+
+inline constexpr size_t validity_words(size_t n) noexcept { return (n + 63) / 64; }
+
+inline bool is_valid_row(const uint64_t* bits, size_t i) noexcept {
+    return !bits || ((bits[i >> 6] >> (i & 63)) & 1u);
+}
+
+// Copy an Arrow byte bitmap covering n rows into word form.
+inline std::vector<uint64_t> pack_validity(const uint8_t* bitmap, size_t n) {
+    std::vector<uint64_t> words(validity_words(n), 0);
+    if (n) std::memcpy(words.data(), bitmap, (n + 7) / 8);
+    if (n % 64) words.back() &= (uint64_t(1) << (n % 64)) - 1;
+    return words;
+}
+
+// Write the Arrow byte bitmap for n rows into out[0, (n + 7) / 8).
+inline void unpack_validity(const uint64_t* bits, size_t n, uint8_t* out) noexcept {
+    const size_t bytes = (n + 7) / 8;
+    if (bits) std::memcpy(out, bits, bytes);
+    else      std::memset(out, 0xFF, bytes);
+}
+
+inline size_t count_nulls(const uint64_t* bits, size_t n) noexcept {
+    if (!bits) return 0;
+    size_t valid = 0;
+    for (size_t w = 0; w < validity_words(n); ++w)
+        valid += size_t(std::popcount(bits[w]));
+    return n - valid;
+}
+
+// Call fn(i) for every valid row i in [0, n), in ascending order.  Walks the
+// set bits of each word, so a run of 64 nulls costs one load and one test.
+template<typename Fn>
+void for_each_valid(const uint64_t* bits, size_t n, Fn&& fn) {
+    if (!bits) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+    for (size_t w = 0; w < validity_words(n); ++w) {
+        for (uint64_t m = bits[w]; m; m &= m - 1)
+            fn(w * 64 + size_t(std::countr_zero(m)));
+    }
+}
+
+} // namespace onpair
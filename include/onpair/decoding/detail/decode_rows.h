@@ -0,0 +1,52 @@
+#pragma once
+#include <onpair/core/types.h>
+#include <onpair/decoding/detail/unpack.h>
+#include <cstdint>
+#include <cstring>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// decode_rows<Bits> — decompress a contiguous row range with offsets.
+//
+// decode_all's offset-aware overload always starts at token 0.  Consumers
+// that work block by block (the byte-scan engine) need rows [row_begin,
+// row_end) on their own, so this kernel unpacks that row range's tokens into
+// `tok_buf` with unpack_tokens<Bits>, then emits bytes with the usual
+// MAX_TOKEN_SIZE over-copy.
+//
+// out_offsets receives (row_end - row_begin + 1) Arrow-style entries
+// relative to `out`.  Buffer requirements:
+//   tok_buf     — bounds[row_end] - bounds[row_begin] tokens
+//   out         — decoded size + MAX_TOKEN_SIZE padding
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair::decoding::detail {
+
+template<BitWidth Bits>
+size_t decode_rows(const uint64_t* ONPAIR_RESTRICT packed,
+                   const uint32_t* ONPAIR_RESTRICT bounds,
+                   const uint8_t*  ONPAIR_RESTRICT dict_bytes,
+                   const uint32_t* ONPAIR_RESTRICT dict_offsets,
+                   size_t row_begin, size_t row_end,
+                   Token*    ONPAIR_RESTRICT tok_buf,
+                   uint8_t*  ONPAIR_RESTRICT out,
+                   uint32_t* ONPAIR_RESTRICT out_offsets) noexcept
+{
+    const uint32_t base = bounds[row_begin];
+    unpack_tokens<Bits>(packed, base, bounds[row_end] - base, tok_buf);
+
+    uint8_t* const out_start = out;
+    for (size_t r = row_begin; r < row_end; ++r) {
+        *out_offsets++ = static_cast<uint32_t>(out - out_start);
+        const Token* t   = tok_buf + (bounds[r] - base);
+        const Token* end = tok_buf + (bounds[r + 1] - base);
+        for (; t != end; ++t) {
+            const uint32_t off = dict_offsets[*t];
+            std::memcpy(out, dict_bytes + off, MAX_TOKEN_SIZE);
+            out += dict_offsets[*t + 1] - off;
+        }
+    }
+    *out_offsets = static_cast<uint32_t>(out - out_start);
+    return size_t(out - out_start);
+}
+
+} // namespace onpair::decoding::detail
@@ -0,0 +1,79 @@
+#pragma once
+#include <onpair/core/row_filter.h>
+#include <onpair/core/types.h>
+#include <onpair/decoding/token_cursor.h>
+#include <cstdint>
+#include <cstring>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// drop_rows — erase deleted rows from bulk-decoded output, in place.
+//
+// decode_all always emits every row; a column with a deletion vector runs
+// one of these afterwards so deleted bytes never reach the caller.  Surviving
+// runs of rows are moved down with one memmove each.
+//
+//   with offsets     — rows keep their slots (row ids stay aligned with the
+//                      column); deleted rows become empty.  Offsets are
+//                      rewritten in place.
+//   without offsets  — row byte lengths come from the token stream, so the
+//                      column's tokens are walked once more; deleted rows
+//                      simply disappear from the flat output.
+//
+// Both return the new total byte count.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair::decoding::detail {
+
+inline size_t drop_rows(const uint64_t* deleted, size_t n,
+                        uint8_t* buf, uint32_t* offsets) noexcept
+{
+    uint32_t out = 0;
+    for (size_t i = 0; i < n; ) {
+        const bool del = is_deleted_row(deleted, i);
+        size_t j = i + 1;
+        while (j < n && is_deleted_row(deleted, j) == del) ++j;
+
+        // offsets[j] is still the original value: only [i, j) is rewritten.
+        if (del) {
+            for (size_t k = i; k < j; ++k) offsets[k] = out;
+        } else {
+            const uint32_t src = offsets[i];
+            const uint32_t len = offsets[j] - src;
+            std::memmove(buf + out, buf + src, len);
+            for (size_t k = i; k < j; ++k) offsets[k] = out + (offsets[k] - src);
+            out += len;
+        }
+        i = j;
+    }
+    offsets[n] = out;
+    return out;
+}
+
+template<BitWidth Bits>
+size_t drop_rows(const uint64_t* ONPAIR_RESTRICT packed,
+                 const uint32_t* ONPAIR_RESTRICT bounds,
+                 const uint32_t* ONPAIR_RESTRICT dict_offsets,
+                 const uint64_t* deleted, size_t n, uint8_t* buf) noexcept
+{
+    TokenCursor<Bits> cursor(packed);
+    size_t src = 0, out = 0;
+    size_t run_begin = 0;       // source offset of the pending surviving run
+    for (size_t i = 0; i < n; ++i) {
+        size_t len = 0;
+        cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+        while (cursor.has_more()) {
+            const Token t = cursor.next();
+            len += dict_offsets[t + 1] - dict_offsets[t];
+        }
+        if (is_deleted_row(deleted, i)) {
+            std::memmove(buf + out, buf + run_begin, src - run_begin);
+            out += src - run_begin;
+            run_begin = src + len;
+        }
+        src += len;
+    }
+    std::memmove(buf + out, buf + run_begin, src - run_begin);
+    return out + (src - run_begin);
+}
+
+} // namespace onpair::decoding::detail
@@ -0,0 +1,77 @@
+#pragma once
+#include <onpair/core/types.h>
+#include <onpair/decoding/detail/decode_all.h>
+#include <cstdint>
+#include <cstring>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// unpack_tokens<Bits> — bulk token extraction into a flat Token[] buffer.
+//
+// Decodes tokens [first, first + count) of a bit-packed stream.  The range
+// is split at natural-group boundaries (see decode_all.h):
+//
+//   head  — tokens before the first group boundary, one unaligned load each
+//   body  — whole groups, through the unrolled extract16<Bits> kernels
+//   tail  — tokens after the last whole group, one unaligned load each
+//
+// Unlike decode_all, the start token need not be group-aligned, so callers
+// can unpack any row range.  Bits == 16 is a plain uint16_t copy.
+//
+// The scalar head/tail loads read 4 bytes; the packed stream's trailing
+// sentinel word keeps that in bounds.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair::decoding::detail {
+
+template<BitWidth Bits>
+inline void unpack_scalar(const uint8_t* ONPAIR_RESTRICT base,
+                          uint32_t first, uint32_t count,
+                          Token* ONPAIR_RESTRICT out) noexcept
+{
+    constexpr uint32_t MASK = (uint32_t(1) << Bits) - 1;
+    size_t bit_pos = size_t(first) * Bits;
+    for (uint32_t i = 0; i < count; ++i, bit_pos += Bits) {
+        uint32_t raw;
+        std::memcpy(&raw, base + (bit_pos >> 3), sizeof(raw));
+        out[i] = Token((raw >> (bit_pos & 7)) & MASK);
+    }
+}
+
+template<BitWidth Bits>
+inline void unpack_tokens(const uint64_t* ONPAIR_RESTRICT packed,
+                          uint32_t first, uint32_t count,
+                          Token* ONPAIR_RESTRICT out) noexcept
+{
+    if constexpr (Bits == 16) {
+        std::memcpy(out, reinterpret_cast<const uint16_t*>(packed) + first,
+                    size_t(count) * sizeof(Token));
+    } else {
+        using G = group_traits<Bits>;
+        constexpr uint32_t B = Bits;
+        const auto* base = reinterpret_cast<const uint8_t*>(packed);
+
+        // ── Head: up to the next group boundary ──────────────────────────────
+        const uint32_t misalign = first % G::tokens;
+        uint32_t head = misalign ? G::tokens - misalign : 0;
+        if (head > count) head = count;
+        unpack_scalar<Bits>(base, first, head, out);
+        first += head; count -= head; out += head;
+
+        // ── Body: whole groups through extract16 ─────────────────────────────
+        const uint64_t* g = packed + size_t(first / G::tokens) * G::words;
+        const uint32_t full = count / G::tokens;
+        for (uint32_t k = 0; k < full; ++k, g += G::words, out += G::tokens) {
+                                          extract16<Bits,  0 * B>(g, out);
+            if constexpr (G::subs >= 2) { extract16<Bits, 16 * B>(g, out + 16); }
+            if constexpr (G::subs >= 3) { extract16<Bits, 32 * B>(g, out + 32); }
+            if constexpr (G::subs >= 4) { extract16<Bits, 48 * B>(g, out + 48); }
+        }
+        first += full * G::tokens;
+        count -= full * G::tokens;
+
+        // ── Tail ─────────────────────────────────────────────────────────────
+        unpack_scalar<Bits>(base, first, count, out);
+    }
+}
+
+} // namespace onpair::decoding::detail
@@ -29,6 +29,20 @@ public:
         store_.packed.reserve(256);
     }
 
+    // Resume a stream that already holds `tokens` tokens and was flushed:
+    // the sentinel word is dropped and the partial last word is reloaded, so
+    // new tokens follow the old ones with no gap.
+    BitWriter(Store& store, size_t tokens) noexcept
+        : store_(store)
+        , bits_(store.bit_width)
+        , mask_((uint64_t(1) << bits_) - 1)
+        , buf_(0), shift_(int(tokens * bits_ % 64)), count_(tokens), flushed_(false)
+    {
+        const size_t full = tokens * bits_ / 64;
+        if (shift_) buf_ = store_.packed[full];
+        store_.packed.resize(full);
+    }
+
     ~BitWriter() noexcept { flush(); }
 
     // Append one token into the packed stream.
@@ -46,6 +60,19 @@ public:
         ++count_;
     }
 
+    // Append tokens [first, first + count) of another packed stream with the
+    // same bit width, copied 64 bits at a time without unpacking them.
+    // Precondition: `packed` ends with the sentinel word flush() appends.
+    void write_run(const uint64_t* packed, size_t first, size_t count) noexcept {
+        size_t bit  = first * bits_;
+        size_t left = count * bits_;
+        for (; left >= 64; bit += 64, left -= 64)
+            append(load_bits(packed, bit), 64);
+        if (left)
+            append(load_bits(packed, bit) & ((uint64_t(1) << left) - 1), int(left));
+        count_ += count;
+    }
+
     // Flush the in-progress word to the store (zero-padded), then append one
     // zero sentinel word so readers can safely do a 4-byte look-ahead at the
     // last token.  Idempotent: subsequent calls are no-ops.
@@ -64,6 +91,26 @@ public:
     size_t tokens_written() const noexcept { return count_; }
 
 private:
+    // 64 bits of `packed` starting at bit `bit` (may span two words).
+    static uint64_t load_bits(const uint64_t* packed, size_t bit) noexcept {
+        const size_t idx = bit >> 6;
+        const int    sh  = int(bit & 63);
+        uint64_t w = packed[idx] >> sh;
+        if (sh) w |= packed[idx + 1] << (64 - sh);
+        return w;
+    }
+
+    // Append the low `nb` bits of w (1 ≤ nb ≤ 64; higher bits must be 0).
+    void append(uint64_t w, int nb) noexcept {
+        buf_ |= w << shift_;
+        shift_ += nb;
+        if (shift_ >= 64) {
+            store_.packed.push_back(buf_);
+            shift_ -= 64;
+            buf_ = shift_ ? w >> (nb - shift_) : 0;
+        }
+    }
+
     Store&   store_;
     const BitWidth bits_;
     const uint64_t mask_;
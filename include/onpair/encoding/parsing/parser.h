@@ -1,4 +1,6 @@
 #pragma once
+#include <onpair/core/run_control.h>
+#include <onpair/core/statistics.h>
 #include <onpair/core/store.h>
 #include <onpair/core/types.h>
 #include <onpair/encoding/lpm.h>
@@ -10,18 +12,34 @@
 //
 // parse() drives the LongestPrefixMatcher over every input string, writes the
 // resulting token IDs into a Store via BitWriter, and records per-string
-// token-count boundaries.
+// token-count boundaries.  When `stats` is non-null it also fills a
+// ColumnStatistics in the same pass; token_frequency is sized 2^bits and
+// left for the caller to trim to the dictionary size.
 // ─────────────────────────────────────────────────────────────────────────────
 
 namespace onpair::encoding {
 
 // Encode all strings into `store` using `lpm`.
 // data[offsets[i]..offsets[i+1]) is string i; offsets has n+1 elements.
-void parse(const uint8_t*              data,
-           const uint32_t*             offsets,
-           size_t                      n,
-           const LongestPrefixMatcher& lpm,
-           BitWidth                    bits,
-           Store&                store);
+// With `ctl`, parsing goes block by block and stops early once ctl->stop is
+// requested; `store` (and `stats`) then cover only the rows parsed.
+// Returns the number of rows parsed.
+size_t parse(const uint8_t*              data,
+             const uint32_t*             offsets,
+             size_t                      n,
+             const LongestPrefixMatcher& lpm,
+             BitWidth                    bits,
+             Store&                      store,
+             ColumnStatistics*           stats = nullptr,
+             const RunControl*           ctl   = nullptr);
+
+// Encode n more strings after those already in `store`, extending its packed
+// stream and boundaries in place.  `store` must have been filled by parse()
+// with the dictionary behind `lpm`.
+void parse_append(const uint8_t*              data,
+                  const uint32_t*             offsets,
+                  size_t                      n,
+                  const LongestPrefixMatcher& lpm,
+                  Store&                      store);
 
 } // namespace onpair::encoding
@@ -39,6 +39,18 @@ struct TrainingConfig {
     // RNG seed for the training shuffle.  nullopt → non-deterministic.
     // Set for reproducible compression (same dictionary across runs).
     std::optional<uint64_t> seed;
+
+    // Gather ColumnStatistics during parse() and persist them with the
+    // column.  Adds per-token bookkeeping to the parse loop and ~4 KiB plus
+    // 4 bytes per dictionary token of storage.
+    bool collect_statistics = false;
+
+    // Refinement passes after the merge scan.  Each pass parses a sample of
+    // the input with the dictionary, scores every merged token by the tokens
+    // it actually saves, and swaps the least useful ones for the most
+    // frequent adjacent pairs of the parse.  Stops early once a pass swaps
+    // nothing.  0 → the single-pass dictionary.
+    uint8_t refine_passes = 0;
 };
 
 } // namespace onpair::encoding
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Template mining — encoding-internal API.
+//
+// Structured IDs such as `user_000001` or `ORD-2024-0000042` are literal
+// text around decimal numbers.  The literal part repeats in every row, and
+// the numbers are high-entropy, so as token sequences they compress poorly.
+// A Template captures the shape: literal segments separated by numeric
+// fields.  A row matching it is stored as the template id plus one integer
+// per field (see TemplateColumn).
+//
+// A row's shape is its maximal runs of ASCII digits (the fields) and the
+// text between them (the literals, which therefore hold no digit).  Two
+// rows have the same template when their literals are equal.  Each field is
+//   fixed width w  (w > 0)  exactly w digits, leading zeros allowed;
+//   variable       (w = 0)  1–19 digits with no leading zero, or "0".
+// Both forms fit a uint64_t, and a value formats back to the same bytes.
+//
+// mine_templates()
+//   Groups a sample of rows by literals and keeps the most frequent shapes
+//   with 1..MAX_TEMPLATE_FIELDS fields that cover at least
+//   cfg.min_fraction of the sample.  A field is fixed width when every
+//   sampled row gives it the same number of digits, variable when they
+//   differ and none has a leading zero, and otherwise fixed at its most
+//   common width.  Rows that fit no template are left to the tokenizer.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace onpair::encoding {
+
+inline constexpr size_t MAX_TEMPLATE_FIELDS = 4;
+inline constexpr size_t MAX_FIELD_DIGITS    = 19;   // 10^19 - 1 < 2^64
+
+inline bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+// Value of a run of at most MAX_FIELD_DIGITS ASCII digits.
+inline uint64_t parse_digits(std::string_view run) noexcept {
+    uint64_t v = 0;
+    for (char c : run) v = v * 10 + uint64_t(c - '0');
+    return v;
+}
+
+struct TemplateConfig {
+    // Smallest share of the sampled rows a shape must cover to be kept.
+    double min_fraction  = 0.01;
+
+    // At most this many templates, the most frequent first.  Range: [0, 255].
+    size_t max_templates = 16;
+
+    // Rows sampled, evenly spaced over the input.
+    size_t sample_rows   = size_t(1) << 16;
+};
+
+struct Template {
+    std::vector<std::string> literals;   // fields() + 1 segments, no digits
+    std::vector<uint8_t>     widths;     // per field: digits, or 0 = variable
+
+    size_t fields() const noexcept { return widths.size(); }
+
+    // "ORD-{4}-{7}" / "item_{}": literals with {width} or {} per field.
+    std::string pattern() const;
+};
+
+class TemplateSet {
+public:
+    static constexpr uint32_t NO_MATCH = UINT32_MAX;
+
+    TemplateSet() = default;
+    explicit TemplateSet(std::vector<Template> templates);
+
+    size_t          size()                   const noexcept { return templates_.size(); }
+    bool            empty()                  const noexcept { return templates_.empty(); }
+    const Template& operator[](uint32_t t)   const noexcept { return templates_[t]; }
+
+    // The template `row` matches, with its field values in values[0,
+    // fields()), or NO_MATCH.  At most one template can match a row.
+    uint32_t match(std::string_view row, uint64_t* values) const;
+
+    // Write template t with `values` to `out` and return the length.
+    // `out` needs max_length(t) bytes.
+    size_t format(uint32_t t, const uint64_t* values, char* out) const noexcept;
+    size_t max_length(uint32_t t) const noexcept;
+
+private:
+    // A template whose fields are all fixed width formats as a copy of its
+    // prototype, zeros in the fields, with the digits written over it.
+    struct Layout {
+        std::string         prototype;   // empty unless every field is fixed
+        std::vector<size_t> starts;      // field offsets in the prototype
+    };
+
+    std::vector<Template>                     templates_;
+    std::vector<Layout>                       layouts_;
+    std::unordered_map<std::string, uint32_t> index_;   // literal key -> id
+};
+
+TemplateSet mine_templates(const uint8_t*        data,
+                           const uint32_t*       offsets,
+                           size_t                n,
+                           const TemplateConfig& cfg = {});
+
+} // namespace onpair::encoding
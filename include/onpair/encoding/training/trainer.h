@@ -14,6 +14,11 @@
 //   the single-byte values 0x00–0xFF; subsequent tokens are pair merges
 //   discovered during the training scan.
 //
+//   With cfg.refine_passes > 0 the merged tokens are then revised against a
+//   greedy parse of a sample: tokens whose occurrences would cost few extra
+//   tokens without them give way to frequent adjacent pairs, so the same
+//   capacity buys fewer tokens per row.
+//
 //   The returned dictionary is always sorted lexicographically by token byte
 //   sequence, with token IDs reassigned to match the sorted order.  Sorting
 //   is performed as the final step of training and enables optimised query
@@ -75,6 +75,11 @@ public:
     bool is_dead()              const noexcept { return hit_; }
     void reset()                      noexcept { state_ = ROOT_STATE; hit_ = all_match_; }
 
+    // ── Resumable interface ─────────────────────────────────────────────────
+    struct Checkpoint { State state; bool hit; };
+    Checkpoint checkpoint() const noexcept { return {state_, hit_}; }
+    void resume(Checkpoint c)     noexcept { state_ = c.state; hit_ = c.hit; }
+
 private:
     static constexpr State HIT = AhoCorasickTrie::NULL_STATE;
     static constexpr State ROOT_STATE = AhoCorasickTrie::ROOT_STATE;
@@ -46,6 +46,16 @@ public:
 
     bool is_dead() const noexcept { return failed_; }
 
+    // ── Resumable interface ─────────────────────────────────────────────────
+    struct Checkpoint { uint32_t pos; bool failed; };
+    Checkpoint checkpoint() const noexcept {
+        return {static_cast<uint32_t>(pos_), failed_};
+    }
+    void resume(Checkpoint c) noexcept {
+        pos_    = c.pos;
+        failed_ = c.failed;
+    }
+
     // ── Accessors ───────────────────────────────────────────────────────────
     size_t query_length() const noexcept { return query_tokens_.size(); }
 
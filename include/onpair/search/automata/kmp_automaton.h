@@ -53,6 +53,11 @@ public:
     void reset()       noexcept       { state_ = 0; }
     bool is_dead()     const noexcept { return state_ == match_state_; }
 
+    // ── Resumable interface ─────────────────────────────────────────────────
+    using Checkpoint = State;
+    Checkpoint checkpoint() const noexcept { return state_; }
+    void resume(Checkpoint c)     noexcept { state_ = c; }
+
     // ── Accessors (testing / introspection) ─────────────────────────────────
     size_t pattern_length()     const noexcept { return match_state_; }
     size_t sparse_range_count() const noexcept { return sparse_.size(); }
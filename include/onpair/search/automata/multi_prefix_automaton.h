@@ -0,0 +1,215 @@
+#pragma once
+#include <onpair/search/automata/token_automaton.h>
+#include <onpair/core/types.h>
+#include <onpair/core/dictionary_view.h>
+#include <onpair/search/detail/tokenize.h>
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace onpair::search {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// MultiPrefixAutomaton
+// ─────────────────────────────────────────────────────────────────────────────
+// Token-level automaton for many prefixes at once (SQL `col LIKE 'p1%' OR
+// col LIKE 'p2%' OR …`), decided in a single pass per row.
+//
+// Construction:
+//   1. Tokenize every prefix and insert its token sequence into a trie.
+//   2. For each prefix and position i, compute PrefixAutomaton's divergence
+//      interval — the tokens whose bytes start with the prefix's remaining
+//      suffix — and attach it to the trie node at depth i.
+//   3. Compile each node into one sorted list of disjoint edges:
+//        accept(id) — a divergence interval: some prefix is matched
+//        goto(node) — the next token of a longer prefix
+//      Divergence intervals are prefix ranges of the sorted dictionary, so
+//      any two are nested or disjoint; only maximal ones are kept, and a
+//      child token inside one is shadowed by it (accepting now is final).
+//      The root's edges are expanded into a dense per-token table, since
+//      every row takes that step.
+//
+// step() is one table lookup at the root and a binary search below it.
+// A node where some prefix ends accepts on entry.
+//
+// DeadDetectable: is_dead() is true once the row is accepted or rejected.
+// matched_prefix() reports the index of one matching prefix — the first
+// decided on the row's path — or NO_MATCH.
+
+class MultiPrefixAutomaton {
+public:
+    static constexpr uint32_t NO_MATCH = UINT32_MAX;
+
+    MultiPrefixAutomaton(std::span<const std::string_view> prefixes,
+                         DictionaryView dv);
+
+    // ── TokenAutomaton / DeadDetectable interface ───────────────────────────
+    void step(Token t) noexcept {
+        if (is_dead()) return;
+
+        const uint32_t x = node_ == 0 ? root_[t] : lookup(node_, t);
+        if (x == REJECT) {
+            status_ = Status::rejected;
+        } else if (x & ACCEPT) {
+            status_  = Status::accepted;
+            matched_ = x & ~ACCEPT;
+        } else {
+            enter(x);
+        }
+    }
+
+    bool is_accepted() const noexcept { return status_ == Status::accepted; }
+
+    void reset() noexcept {
+        status_  = Status::matching;
+        matched_ = NO_MATCH;
+        enter(0);
+    }
+
+    bool is_dead() const noexcept { return status_ != Status::matching; }
+
+    // ── Resumable interface ─────────────────────────────────────────────────
+    struct Checkpoint { uint32_t node; uint32_t matched; uint8_t status; };
+    Checkpoint checkpoint() const noexcept {
+        return {node_, matched_, static_cast<uint8_t>(status_)};
+    }
+    void resume(Checkpoint c) noexcept {
+        node_    = c.node;
+        matched_ = c.matched;
+        status_  = static_cast<Status>(c.status);
+    }
+
+    // ── Accessors ───────────────────────────────────────────────────────────
+    uint32_t matched_prefix() const noexcept { return matched_; }
+    size_t   num_prefixes()   const noexcept { return num_prefixes_; }
+    size_t   num_nodes()      const noexcept { return nodes_.size(); }
+
+private:
+    enum class Status : uint8_t { matching, accepted, rejected };
+
+    static constexpr uint32_t ACCEPT = 0x80000000u;
+    static constexpr uint32_t REJECT = UINT32_MAX;
+
+    struct Edge {
+        TokenRange range;
+        uint32_t   target;      // ACCEPT | prefix id, or child node id
+    };
+
+    struct Node {
+        uint32_t edges_begin = 0;
+        uint32_t edges_end   = 0;
+        uint32_t terminal    = NO_MATCH;   // prefix ending here, if any
+    };
+
+    void enter(uint32_t node) noexcept {
+        node_ = node;
+        if (nodes_[node].terminal != NO_MATCH) {
+            status_  = Status::accepted;
+            matched_ = nodes_[node].terminal;
+        }
+    }
+
+    uint32_t lookup(uint32_t node, Token t) const noexcept {
+        const Edge* first = edges_.data() + nodes_[node].edges_begin;
+        const Edge* last  = edges_.data() + nodes_[node].edges_end;
+        // First edge whose range ends at or after t.
+        const Edge* e = std::partition_point(first, last,
+            [t](const Edge& x) { return x.range.last < t; });
+        return (e != last && e->range.begin <= t) ? e->target : REJECT;
+    }
+
+    std::vector<Node>     nodes_;
+    std::vector<Edge>     edges_;
+    std::vector<uint32_t> root_;          // dense root transitions, per token
+    size_t                num_prefixes_ = 0;
+
+    uint32_t node_    = 0;
+    Status   status_  = Status::matching;
+    uint32_t matched_ = NO_MATCH;
+};
+
+// ─── Implementation ─────────────────────────────────────────────────────────
+
+inline MultiPrefixAutomaton::MultiPrefixAutomaton(
+    std::span<const std::string_view> prefixes, DictionaryView dv)
+    : num_prefixes_(prefixes.size())
+{
+    // ── Trie over token sequences, with per-node divergence intervals ───────
+    struct Pending {
+        std::vector<Edge> intervals;   // target = ACCEPT | prefix id
+        std::vector<Edge> children;    // single-token ranges, target = node
+    };
+    std::vector<Pending> pending(1);
+    nodes_.resize(1);
+
+    for (uint32_t id = 0; id < prefixes.size(); ++id) {
+        const std::string_view p = prefixes[id];
+        const auto tokens = detail::tokenize(p, dv);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(p.data());
+
+        uint32_t node = 0;
+        size_t   pos  = 0;
+        for (Token q : tokens) {
+            if (nodes_[node].terminal != NO_MATCH) break;   // shorter prefix wins
+
+            TokenRange iv = dv.prefix_range(bytes + pos, p.size() - pos);
+            if (!iv.empty())
+                pending[node].intervals.push_back({iv, ACCEPT | id});
+
+            auto& ch = pending[node].children;
+            auto it = std::find_if(ch.begin(), ch.end(),
+                [q](const Edge& e) { return e.range.begin == q; });
+            if (it == ch.end()) {
+                const auto child = static_cast<uint32_t>(nodes_.size());
+                nodes_.emplace_back();
+                pending.emplace_back();
+                pending[node].children.push_back({TokenRange{q, q}, child});
+                node = child;
+            } else {
+                node = it->target;
+            }
+            pos += dv.token_size(q);
+        }
+        if (nodes_[node].terminal == NO_MATCH) nodes_[node].terminal = id;
+    }
+
+    // ── Compile each node into sorted, disjoint edges ──────────────────────
+    for (size_t n = 0; n < nodes_.size(); ++n) {
+        auto& iv = pending[n].intervals;
+        std::sort(iv.begin(), iv.end(), [](const Edge& a, const Edge& b) {
+            if (a.range.begin != b.range.begin) return a.range.begin < b.range.begin;
+            return a.range.last > b.range.last;      // widest first
+        });
+        std::vector<Edge> maximal;
+        for (const Edge& e : iv)
+            if (maximal.empty() || e.range.begin > maximal.back().range.last)
+                maximal.push_back(e);
+
+        std::vector<Edge> merged = maximal;
+        for (const Edge& c : pending[n].children) {
+            const Token q = c.range.begin;
+            const bool shadowed = std::any_of(maximal.begin(), maximal.end(),
+                [q](const Edge& e) { return e.range.contains(q); });
+            if (!shadowed) merged.push_back(c);
+        }
+        std::sort(merged.begin(), merged.end(), [](const Edge& a, const Edge& b) {
+            return a.range.begin < b.range.begin;
+        });
+
+        nodes_[n].edges_begin = static_cast<uint32_t>(edges_.size());
+        edges_.insert(edges_.end(), merged.begin(), merged.end());
+        nodes_[n].edges_end   = static_cast<uint32_t>(edges_.size());
+    }
+
+    // ── Dense root table ────────────────────────────────────────────────────
+    root_.assign(dv.num_tokens(), REJECT);
+    for (uint32_t e = nodes_[0].edges_begin; e < nodes_[0].edges_end; ++e)
+        for (uint32_t t = edges_[e].range.begin; t <= edges_[e].range.last; ++t)
+            root_[t] = edges_[e].target;
+
+    reset();
+}
+
+} // namespace onpair::search
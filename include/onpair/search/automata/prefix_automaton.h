@@ -52,6 +52,16 @@ public:
 
     bool is_dead() const noexcept { return status_ != Status::matching; }
 
+    // ── Resumable interface ─────────────────────────────────────────────────
+    struct Checkpoint { uint32_t pos; uint8_t status; };
+    Checkpoint checkpoint() const noexcept {
+        return {static_cast<uint32_t>(pos_), static_cast<uint8_t>(status_)};
+    }
+    void resume(Checkpoint c) noexcept {
+        pos_    = c.pos;
+        status_ = static_cast<Status>(c.status);
+    }
+
     // ── Accessors ───────────────────────────────────────────────────────────
     size_t query_length() const noexcept { return query_tokens_.size(); }
 
@@ -1,10 +1,19 @@
 #pragma once
+#include <onpair/core/row_filter.h>
+#include <onpair/core/run_control.h>
 #include <onpair/search/automata/token_automaton.h>
 #include <onpair/search/automata/token_stream.h>
 #include <onpair/decoding/token_cursor.h>
+#include <onpair/decoding/detail/unpack.h>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 namespace onpair::search {
 
@@ -46,5 +55,307 @@ void scan_impl(A& aut, const uint64_t* ONPAIR_RESTRICT packed,
     }
 }
 
+// Filtered variant: only rows passing `filter` (valid, not deleted) are
+// driven, so null and deleted rows never cost an automaton step and never
+// match (not even an automaton that accepts the empty string).
+template<BitWidth Bits, TokenAutomaton A, std::invocable<size_t> F>
+void scan_impl(A& aut, const uint64_t* ONPAIR_RESTRICT packed,
+               const uint32_t* ONPAIR_RESTRICT bounds,
+               RowFilter filter, size_t n, F&& on_match)
+{
+    decoding::TokenCursor<Bits> cursor(packed);
+    for_each_passing(filter, n, [&](size_t i) {
+        cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+        if (drive(aut, cursor)) on_match(i);
+    });
+}
+
+// Controlled variant: the same row loop, run one RunControl block at a time
+// (see run_control.h).  Stops before a block once ctl.stop is requested.
+template<BitWidth Bits, TokenAutomaton A, std::invocable<size_t> F>
+RunResult scan_impl(A& aut, const uint64_t* ONPAIR_RESTRICT packed,
+                    const uint32_t* ONPAIR_RESTRICT bounds,
+                    RowFilter filter, size_t n, const RunControl& ctl,
+                    F&& on_match)
+{
+    decoding::TokenCursor<Bits> cursor(packed);
+    auto visit = [&](size_t i) {
+        cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+        if (drive(aut, cursor)) on_match(i);
+    };
+
+    const size_t block = ctl.block();
+    for (size_t begin = 0; begin < n; begin += block) {
+        if (ctl.stop_requested()) return {RunStatus::Cancelled, begin};
+        const size_t end = std::min(n, begin + block);
+        if (!filter) {
+            for (size_t i = begin; i < end; ++i) visit(i);
+        } else {
+            for (size_t w = begin / 64; w < validity_words(end); ++w)
+                for (uint64_t m = filter.word(w, n); m; m &= m - 1)
+                    visit(w * 64 + size_t(std::countr_zero(m)));
+        }
+        ctl.report(end, n);
+    }
+    return {RunStatus::Complete, n};
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// scan_decompress_impl — scan, decoding each accepted row on the spot
+// ─────────────────────────────────────────────────────────────────────────────
+// Late materialization after scan() takes a second, random-access pass over
+// the packed words the scan already touched.  Here an accepted row is
+// decoded at once, while its words are still in L1.  Decoding restarts at
+// the row's first token, so a row accepted early (DeadDetectable automata
+// stop at the first match) is still emitted whole; the automaton never
+// decodes a rejected row.
+//
+// Writes Arrow output (out_offsets gets one entry per accepted row plus a
+// final one) and, when out_rows is non-null, the accepted row ids.  Returns
+// the number of accepted rows.
+
+template<BitWidth Bits, TokenAutomaton A>
+size_t scan_decompress_impl(A& aut, const uint64_t* ONPAIR_RESTRICT packed,
+                            const uint32_t* ONPAIR_RESTRICT bounds,
+                            RowFilter filter, size_t n,
+                            const uint8_t*  ONPAIR_RESTRICT dict_bytes,
+                            const uint32_t* ONPAIR_RESTRICT dict_offsets,
+                            uint8_t*  ONPAIR_RESTRICT out,
+                            uint32_t* ONPAIR_RESTRICT out_offsets,
+                            size_t*   ONPAIR_RESTRICT out_rows)
+{
+    decoding::TokenCursor<Bits> cursor(packed);
+    uint8_t* const out_start = out;
+    size_t matched = 0;
+
+    auto visit = [&](size_t i) {
+        const StreamSpan span{bounds[i], bounds[i + 1]};
+        cursor.reset_to(span);
+        if (!drive(aut, cursor)) return;
+
+        out_offsets[matched] = static_cast<uint32_t>(out - out_start);
+        if (out_rows) out_rows[matched] = i;
+        ++matched;
+        cursor.reset_to(span);
+        while (cursor.has_more()) {
+            const Token    t   = cursor.next();
+            const uint32_t off = dict_offsets[t];
+            std::memcpy(out, dict_bytes + off, MAX_TOKEN_SIZE);
+            out += dict_offsets[t + 1] - off;
+        }
+    };
+
+    for_each_passing(filter, n, visit);
+
+    out_offsets[matched] = static_cast<uint32_t>(out - out_start);
+    return matched;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// scan_interleaved_impl — K-lane lockstep scan, monomorphised on Bits and K
+// ─────────────────────────────────────────────────────────────────────────────
+// scan_impl runs one short dependent chain per row (boundary load → packed
+// load → step → is_dead), so on short rows the core mostly waits.  This
+// kernel keeps K cursors and K independent automaton copies live and advances
+// every unfinished lane by one token per round, so the K chains overlap in
+// the out-of-order window instead of running back to back.
+//
+// Rows are processed in batches of K; matches are reported after each batch
+// in ascending row order, exactly as scan_impl reports them.  Rows that do
+// not fill a final batch run through lane 0 with the sequential loop.
+//
+// Not the default: when the packed stream is read sequentially and the
+// automaton tables sit in L1, scan_impl has little latency to hide and the
+// lane bookkeeping costs about as much as it saves.  Prefer it when step()
+// chains are long (large sparse tables, lazily expanded states).
+
+template<size_t K, typename A>
+std::array<A, K> replicate(const A& proto) {
+    return [&]<size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<A, K>{ ((void)Is, proto)... };
+    }(std::make_index_sequence<K>{});
+}
+
+template<BitWidth Bits, size_t K, TokenAutomaton A, std::invocable<size_t> F>
+void scan_interleaved_impl(std::array<A, K>& lanes,
+                           const uint64_t* ONPAIR_RESTRICT packed,
+                           const uint32_t* ONPAIR_RESTRICT bounds,
+                           size_t n, F&& on_match)
+{
+    static_assert(K >= 1, "at least one lane");
+
+    decoding::TokenCursor<Bits> cur[K];
+    size_t i = 0;
+
+    for (; i + K <= n; i += K) {
+        for (size_t k = 0; k < K; ++k) {
+            cur[k] = decoding::TokenCursor<Bits>(
+                packed, StreamSpan{bounds[i + k], bounds[i + k + 1]});
+            lanes[k].reset();
+        }
+
+        // One round = one token for every lane that is neither exhausted nor
+        // dead.  K is a constant, so the lane loop fully unrolls.
+        for (bool any = true; any; ) {
+            any = false;
+            for (size_t k = 0; k < K; ++k) {
+                bool active = cur[k].has_more();
+                if constexpr (DeadDetectable<A>)
+                    active = active && !lanes[k].is_dead();
+                if (active) {
+                    lanes[k].step(cur[k].next());
+                    any = true;
+                }
+            }
+        }
+
+        for (size_t k = 0; k < K; ++k)
+            if (lanes[k].is_accepted()) on_match(i + k);
+    }
+
+    decoding::TokenCursor<Bits> cursor(packed);
+    for (; i < n; ++i) {
+        cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+        if (drive(lanes[0], cursor)) on_match(i);
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// scan_blocked_impl — unpack a block of rows, then match over the buffer
+// ─────────────────────────────────────────────────────────────────────────────
+// Separates unpacking from matching.  Consecutive rows are grouped until
+// their tokens fill SCAN_BLOCK_TOKENS; the group is bulk-unpacked into a
+// stack buffer with unpack_tokens<Bits> (the decode_all extract16 kernels),
+// and the automaton then walks each row as a plain Token array.  Each phase
+// runs its own tight loop, which pays off most for automata with cheap
+// steps, where TokenCursor's per-token load and shift dominates.  Automata
+// that die early (prefix, equality) still pay to unpack the whole row, so
+// scan_impl stays the default.
+//
+// A row longer than one block is driven directly from the packed stream.
+
+inline constexpr uint32_t SCAN_BLOCK_TOKENS = 2048;
+
+template<BitWidth Bits, TokenAutomaton A, std::invocable<size_t> F>
+void scan_blocked_impl(A& aut, const uint64_t* ONPAIR_RESTRICT packed,
+                       const uint32_t* ONPAIR_RESTRICT bounds,
+                       size_t n, F&& on_match)
+{
+    Token buf[SCAN_BLOCK_TOKENS];
+    decoding::TokenCursor<Bits> cursor(packed);
+
+    size_t i = 0;
+    while (i < n) {
+        const uint32_t base = bounds[i];
+        // Last row end that fits: bounds is sorted, so binary search.
+        const uint32_t* last = std::upper_bound(
+            bounds + i + 1, bounds + n + 1, base + SCAN_BLOCK_TOKENS);
+        const size_t j = size_t(last - bounds) - 1;
+
+        if (j == i) {
+            cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+            if (drive(aut, cursor)) on_match(i);
+            ++i;
+            continue;
+        }
+
+        decoding::detail::unpack_tokens<Bits>(packed, base,
+                                              bounds[j] - base, buf);
+        for (; i < j; ++i) {
+            TokenSpanStream row{buf + (bounds[i] - base),
+                                buf + (bounds[i + 1] - base)};
+            if (drive(aut, row)) on_match(i);
+        }
+    }
+}
+// ─────────────────────────────────────────────────────────────────────────────
+// scan_front_coded_impl — scan of a front-coded column (front_coded.h)
+// ─────────────────────────────────────────────────────────────────────────────
+// Row i is the first shared[i] tokens of row i - 1 followed by the tokens
+// stored for row i; the loop rebuilds rows in a Token buffer of
+// max_row_tokens entries, the length of the longest row.
+//
+// For Resumable automata it also keeps a checkpoint after every token it
+// steps.  A row resumes from the checkpoint at its shared-prefix length, so
+// a prefix common to a run of rows is stepped once, not once per row.  If
+// the previous row stopped earlier, its automaton was dead there, and so is
+// this row's: the verdict is final without touching a token.  Stored tokens
+// are unpacked only as the automaton reaches them, so a prefix or equality
+// automaton that dies early leaves the rest of the row packed.  The buffer
+// then ends short of the row, but only past a dead checkpoint, which no
+// later row resumes beyond.
+//
+// Other automata are driven over the whole rebuilt row.  Rows failing
+// `filter` are rebuilt, since the next row may share their prefix, but
+// never driven.
+
+template<BitWidth Bits, TokenAutomaton A, std::invocable<size_t> F>
+void scan_front_coded_impl(A& aut, const uint64_t* ONPAIR_RESTRICT packed,
+                           const uint32_t* ONPAIR_RESTRICT bounds,
+                           const uint16_t* ONPAIR_RESTRICT shared,
+                           RowFilter filter, size_t n, size_t max_row_tokens,
+                           F&& on_match)
+{
+    decoding::TokenCursor<Bits> cursor(packed);
+    std::vector<Token> buffer(max_row_tokens);
+    Token* const row = buffer.data();
+    size_t have = 0;   // leading tokens of the current row held in `row`
+
+    // Append row i's stored tokens, if the buffer holds its whole prefix.
+    auto unpack_rest = [&](size_t i) {
+        if (have != shared[i]) return;
+        cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+        while (cursor.has_more()) row[have++] = cursor.next();
+    };
+
+    if constexpr (Resumable<A>) {
+        auto dead = [&] {
+            if constexpr (DeadDetectable<A>) return aut.is_dead();
+            else                              return false;
+        };
+        std::vector<typename A::Checkpoint> cps(max_row_tokens + 1);
+        aut.reset();
+        cps[0] = aut.checkpoint();
+        size_t stepped = 0;   // cps[0, stepped] hold for the buffered row
+        for (size_t i = 0; i < n; ++i) {
+            have = std::min<size_t>(shared[i], have);
+            size_t k = std::min<size_t>(shared[i], stepped);
+            if (filter && !filter.passes(i)) {
+                unpack_rest(i);
+                stepped = k;
+                continue;
+            }
+            aut.resume(cps[k]);
+
+            // Shared tokens past the resume point, then the stored ones.
+            for (; k < have && !dead(); ++k) {
+                aut.step(row[k]);
+                cps[k + 1] = aut.checkpoint();
+            }
+            if (have == shared[i] && !dead()) {
+                cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+                const size_t len = have + cursor.remaining();
+                for (; k < len && !dead(); ++k) {
+                    const Token t = cursor.next();
+                    row[k] = t;
+                    aut.step(t);
+                    cps[k + 1] = aut.checkpoint();
+                }
+                have = k;
+            }
+            stepped = k;
+            if (aut.is_accepted()) on_match(i);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            have = std::min<size_t>(shared[i], have);
+            unpack_rest(i);
+            if (filter && !filter.passes(i)) continue;
+            TokenSpanStream stream{row, row + have};
+            if (drive(aut, stream)) on_match(i);
+        }
+    }
+}
+
 } // namespace detail
 } // namespace onpair::search
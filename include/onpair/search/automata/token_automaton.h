@@ -31,17 +31,38 @@ concept DeadDetectable = TokenAutomaton<A> && requires(const A a) {
     { a.is_dead() } -> std::convertible_to<bool>;
 };
 
+// Optional refinement: automata whose whole per-row match state is a small
+// value.  checkpoint() captures it part-way through a row; resume() restores
+// it, as if the same tokens had been stepped again since reset().  The
+// front-coded scan (scan_front_coded_impl) resumes each row from the
+// checkpoint taken at the end of the prefix it shares with the row before.
+
+template<typename A>
+concept Resumable = TokenAutomaton<A> && requires(A a, const A ca) {
+    typename A::Checkpoint;
+    { ca.checkpoint() } -> std::same_as<typename A::Checkpoint>;
+    { a.resume(ca.checkpoint()) } -> std::same_as<void>;
+};
+
+namespace detail {
+// A::Checkpoint when A is Resumable; a placeholder otherwise, so that
+// combinators can name the type and constrain the members that use it.
+struct NoCheckpoint {};
+template<typename A> struct checkpoint_of { using type = NoCheckpoint; };
+template<Resumable A> struct checkpoint_of<A> { using type = typename A::Checkpoint; };
+} // namespace detail
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Automaton combinators
 // ─────────────────────────────────────────────────────────────────────────────
 // Composable zero-cost wrappers that build new TokenAutomata from existing
 // ones — enabling boolean algebra over compressed-domain search.
 //
-// All combinators satisfy TokenAutomaton.  DeadDetectable is satisfied
-// conditionally when the wrapped automata satisfy it.
+// All combinators satisfy TokenAutomaton.  DeadDetectable and Resumable are
+// satisfied conditionally when the wrapped automata satisfy them.
 
 // ── NegatedAutomaton<A> ───────────────────────────────────────────────────────
-// Inverts is_accepted().  is_dead() is forwarded unchanged.
+// Inverts is_accepted().  is_dead() and checkpoints are forwarded unchanged.
 
 template<TokenAutomaton A>
 struct NegatedAutomaton {
@@ -51,6 +72,10 @@ struct NegatedAutomaton {
     bool is_accepted() const { return !inner.is_accepted(); }
     void reset()             { inner.reset(); }
     bool is_dead() const requires DeadDetectable<A> { return inner.is_dead(); }
+
+    using Checkpoint = typename detail::checkpoint_of<A>::type;
+    Checkpoint checkpoint() const requires Resumable<A> { return inner.checkpoint(); }
+    void resume(Checkpoint c)     requires Resumable<A> { inner.resume(c); }
 };
 
 // ── AndAutomaton<A, B> ────────────────────────────────────────────────────────
@@ -75,6 +100,18 @@ struct AndAutomaton {
             if (b.is_dead() && !b.is_accepted()) return true;
         return false;
     }
+
+    struct Checkpoint {
+        typename detail::checkpoint_of<A>::type a;
+        typename detail::checkpoint_of<B>::type b;
+    };
+    Checkpoint checkpoint() const requires (Resumable<A> && Resumable<B>) {
+        return {a.checkpoint(), b.checkpoint()};
+    }
+    void resume(Checkpoint c) requires (Resumable<A> && Resumable<B>) {
+        a.resume(c.a);
+        b.resume(c.b);
+    }
 };
 
 // ── OrAutomaton<A, B> ─────────────────────────────────────────────────────────
@@ -99,8 +136,42 @@ struct OrAutomaton {
             if (b.is_dead() && b.is_accepted()) return true;
         return false;
     }
+
+    struct Checkpoint {
+        typename detail::checkpoint_of<A>::type a;
+        typename detail::checkpoint_of<B>::type b;
+    };
+    Checkpoint checkpoint() const requires (Resumable<A> && Resumable<B>) {
+        return {a.checkpoint(), b.checkpoint()};
+    }
+    void resume(Checkpoint c) requires (Resumable<A> && Resumable<B>) {
+        a.resume(c.a);
+        b.resume(c.b);
+    }
 };
 
+// ─────────────────────────────────────────────────────────────────────────────
+// Replicable concept
+// ─────────────────────────────────────────────────────────────────────────────
+// Automata whose copies are fully independent instances — every table and
+// every bit of match state is owned by value (or shared read-only).  The
+// interleaved scan kernel runs one copy per lane.
+//
+// Combinators are excluded: they hold references to their operands, so two
+// copies would step the same underlying automata and corrupt each other.
+
+namespace detail {
+template<typename A> inline constexpr bool is_combinator = false;
+template<typename A>             inline constexpr bool is_combinator<NegatedAutomaton<A>> = true;
+template<typename A, typename B> inline constexpr bool is_combinator<AndAutomaton<A, B>>  = true;
+template<typename A, typename B> inline constexpr bool is_combinator<OrAutomaton<A, B>>   = true;
+} // namespace detail
+
+template<typename A>
+concept Replicable = TokenAutomaton<A>
+                  && std::copy_constructible<A>
+                  && !detail::is_combinator<A>;
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Operator overloads
 // ─────────────────────────────────────────────────────────────────────────────
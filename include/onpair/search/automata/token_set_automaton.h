@@ -0,0 +1,203 @@
+#pragma once
+#include <onpair/search/automata/token_automaton.h>
+#include <onpair/search/automata/scan.h>
+#include <onpair/core/dictionary_view.h>
+#include <onpair/decoding/token_cursor.h>
+#include <onpair/decoding/detail/unpack.h>
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+namespace onpair::search {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TokenSetAutomaton
+// ─────────────────────────────────────────────────────────────────────────────
+// Token-level automaton for "row contains a byte from class S" predicates
+// (SQL `LIKE '%@%'`, "contains a digit", "contains non-ASCII").
+//
+// Construction:
+//   For every dictionary token, test its bytes against the predicate and set
+//   one bit in a membership bitmap (8 KiB at 16 bits, so it stays in L1).
+//   A row matches iff one of its tokens is a member: each token's bytes are
+//   a contiguous slice of the row, so no byte can straddle two tokens.
+//
+// step() is one bitmap probe.  DeadDetectable: is_dead() is true after the
+// first member token — the verdict cannot change.
+//
+// find_first() tests a whole unpacked token array at once (AVX2 gather when
+// compiled with it); scan_token_set_impl uses it over block-unpacked rows.
+
+class TokenSetAutomaton {
+public:
+    template<std::predicate<uint8_t> P>
+    TokenSetAutomaton(P&& pred, DictionaryView dv)
+        : bits_((dv.num_tokens() + 63) / 64 + 1, 0)
+    {
+        bool in_class[256];
+        for (unsigned b = 0; b < 256; ++b)
+            in_class[b] = static_cast<bool>(pred(static_cast<uint8_t>(b)));
+
+        const size_t n = dv.num_tokens();
+        for (size_t t = 0; t < n; ++t) {
+            const uint8_t* p = dv.data(static_cast<Token>(t));
+            const size_t len = dv.token_size(static_cast<Token>(t));
+            for (size_t k = 0; k < len; ++k) {
+                if (in_class[p[k]]) {
+                    bits_[t >> 6] |= uint64_t(1) << (t & 63);
+                    ++members_;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Byte class given by enumeration: matches rows containing any of `bytes`.
+    static TokenSetAutomaton any_of(std::string_view bytes, DictionaryView dv) {
+        bool in_class[256] = {};
+        for (char c : bytes) in_class[static_cast<uint8_t>(c)] = true;
+        return TokenSetAutomaton([&](uint8_t b) { return in_class[b]; }, dv);
+    }
+
+    // ── TokenAutomaton / DeadDetectable interface ───────────────────────────
+    void step(Token t) noexcept { hit_ |= contains(t); }
+
+    bool is_accepted() const noexcept { return hit_; }
+    void reset()       noexcept       { hit_ = false; }
+    bool is_dead()     const noexcept { return hit_; }
+
+    // ── Resumable interface ─────────────────────────────────────────────────
+    using Checkpoint = bool;
+    Checkpoint checkpoint() const noexcept { return hit_; }
+    void resume(Checkpoint c)     noexcept { hit_ = c; }
+
+    // ── Set queries ─────────────────────────────────────────────────────────
+    bool contains(Token t) const noexcept {
+        return (bits_[t >> 6] >> (t & 63)) & 1;
+    }
+
+    // Index of the first member in tokens[0, count), or count if none.
+    size_t find_first(const Token* tokens, size_t count) const noexcept {
+        size_t i = 0;
+#if defined(__AVX2__)
+        // Dense classes hit within the first few tokens of a row; probe those
+        // directly before paying for the vector setup.
+        for (const size_t head = std::min<size_t>(count, 4); i < head; ++i)
+            if (contains(tokens[i])) return i;
+
+        // Eight tokens per round: widen to 32 bits, gather the 32-bit bitmap
+        // word t >> 5, and test bit t & 31.  Viewing the uint64_t bitmap as
+        // uint32_t words keeps the bit order on little-endian targets.
+        const auto* words = reinterpret_cast<const int*>(bits_.data());
+        const __m256i low5 = _mm256_set1_epi32(31);
+        const __m256i one  = _mm256_set1_epi32(1);
+        for (; i + 8 <= count; i += 8) {
+            const __m256i t = _mm256_cvtepu16_epi32(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(tokens + i)));
+            const __m256i w = _mm256_i32gather_epi32(
+                words, _mm256_srli_epi32(t, 5), 4);
+            const __m256i b = _mm256_and_si256(
+                _mm256_srlv_epi32(w, _mm256_and_si256(t, low5)), one);
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_slli_epi32(b, 31))));
+            if (mask) return i + size_t(std::countr_zero(mask));
+        }
+#endif
+        for (; i < count; ++i)
+            if (contains(tokens[i])) return i;
+        return count;
+    }
+
+    // ── Accessors ───────────────────────────────────────────────────────────
+    size_t member_count() const noexcept { return members_; }
+
+private:
+    std::vector<uint64_t> bits_;    // one bit per token, plus a zero word
+    size_t members_ = 0;
+    bool   hit_     = false;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Engine selection
+// ─────────────────────────────────────────────────────────────────────────────
+// The block kernel skips rows without members at no per-row cost, 4-5x
+// faster than a row scan when members are rare.  A dense class hits within
+// the first token or two of nearly every row; there the row scan, which
+// stops reading a row once is_dead(), beats the block kernel's unpack and
+// per-hit bookkeeping ("." over 1M short rows at 12 bits: 2.2 vs 5.4 ms).
+// The share of dictionary tokens that are members stands in for the hit
+// rate.
+inline constexpr double DENSE_TOKEN_SET_SHARE = 0.125;
+
+enum class TokenSetEngine : uint8_t { blocks, rows };
+
+inline TokenSetEngine choose_token_set_engine(const TokenSetAutomaton& set,
+                                              DictionaryView dv) noexcept
+{
+    const size_t n = dv.num_tokens();
+    return n && double(set.member_count()) > DENSE_TOKEN_SET_SHARE * double(n)
+               ? TokenSetEngine::rows
+               : TokenSetEngine::blocks;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// scan_token_set_impl — block-unpacked membership scan, monomorphised on Bits
+// ─────────────────────────────────────────────────────────────────────────────
+// Rows are grouped into blocks of up to SCAN_BLOCK_TOKENS tokens, as in
+// scan_blocked_impl.  Instead of driving the automaton row by row, the whole
+// block is searched with find_first(); each hit is mapped to its row through
+// a monotone cursor over `bounds`, reported, and the search resumes at the
+// next row.  Rows without members cost no per-row work at all.
+
+namespace detail {
+
+template<BitWidth Bits, std::invocable<size_t> F>
+void scan_token_set_impl(const TokenSetAutomaton& set,
+                         const uint64_t* ONPAIR_RESTRICT packed,
+                         const uint32_t* ONPAIR_RESTRICT bounds,
+                         size_t n, F&& on_match)
+{
+    Token buf[SCAN_BLOCK_TOKENS];
+    decoding::TokenCursor<Bits> cursor(packed);
+
+    size_t i = 0;
+    while (i < n) {
+        const uint32_t base = bounds[i];
+        const uint32_t* last = std::upper_bound(
+            bounds + i + 1, bounds + n + 1, base + SCAN_BLOCK_TOKENS);
+        const size_t j = size_t(last - bounds) - 1;
+
+        if (j == i) {
+            cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+            while (cursor.has_more()) {
+                if (set.contains(cursor.next())) { on_match(i); break; }
+            }
+            ++i;
+            continue;
+        }
+
+        const size_t total = bounds[j] - base;
+        decoding::detail::unpack_tokens<Bits>(packed, base,
+                                              static_cast<uint32_t>(total), buf);
+        size_t pos = 0;
+        while (pos < total) {
+            pos += set.find_first(buf + pos, total - pos);
+            if (pos == total) break;
+            while (bounds[i + 1] - base <= pos) ++i;
+            on_match(i);
+            pos = bounds[++i] - base;
+        }
+        i = j;
+    }
+}
+
+} // namespace detail
+} // namespace onpair::search
@@ -16,4 +16,18 @@ concept TokenStream = requires(S s) {
     { s.next()     } -> std::same_as<Token>;
 };
 
+// ─────────────────────────────────────────────────────────────────────────────
+// TokenSpanStream
+// ─────────────────────────────────────────────────────────────────────────────
+// TokenStream over an already-unpacked [begin, end) range of token ids.  The
+// block scan unpacks many rows at once and walks each row with one of these.
+
+struct TokenSpanStream {
+    const Token* cur;
+    const Token* end;
+
+    bool  has_more() const noexcept { return cur != end; }
+    Token next()           noexcept { return *cur++; }
+};
+
 } // namespace onpair::search
@@ -0,0 +1,181 @@
+#pragma once
+#include <onpair/core/dictionary_view.h>
+#include <onpair/core/types.h>
+#include <onpair/decoding/detail/decode_rows.h>
+#include <onpair/search/automata/kmp_automaton.h>
+#include <onpair/search/automata/scan.h>
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+namespace onpair::search {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Byte-scan engine — block decompression plus vectorised substring search
+// ─────────────────────────────────────────────────────────────────────────────
+// The token engine (KmpAutomaton + scan_impl) never materialises bytes, but
+// it pays one table step per token and, for some patterns, a linear walk
+// over that state's sparse ranges.  When those walks are long it can be
+// cheaper to decompress a block of rows into a cache-resident buffer and
+// search the bytes directly.
+//
+// scan_bytes_impl decodes up to SCAN_BLOCK_TOKENS tokens (or SCAN_BLOCK_ROWS
+// rows) at a time with decode_rows<Bits>, searches the whole block with
+// find_bytes, and maps every hit back to its row through the block offsets.
+// A hit that straddles two rows is discarded; after a hit the search resumes
+// at the next row, since one hit decides the row.
+//
+// find_bytes uses AVX2 when the consumer compiles with it (first/last-byte
+// filter over 32-byte windows, memcmp on candidates); otherwise it falls
+// back to memchr / std::string_view::find.
+//
+// choose_contains_engine() picks between the two engines for
+// OnPairColumnView::contains().
+
+inline constexpr size_t SCAN_BLOCK_ROWS = 1024;
+
+namespace detail {
+
+inline constexpr size_t NPOS = size_t(-1);
+
+// First position of needle[0, m) in hay[0, len), or NPOS.  Precondition: m ≥ 1.
+inline size_t find_bytes(const uint8_t* hay, size_t len,
+                         const uint8_t* needle, size_t m) noexcept
+{
+    if (m > len) return NPOS;
+    if (m == 1) {
+        const void* p = std::memchr(hay, needle[0], len);
+        return p ? size_t(static_cast<const uint8_t*>(p) - hay) : NPOS;
+    }
+
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+    const __m256i last  = _mm256_set1_epi8(static_cast<char>(needle[m - 1]));
+    for (; i + m - 1 + 32 <= len; i += 32) {
+        const __m256i bf = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(hay + i));
+        const __m256i bl = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(hay + i + m - 1));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(bf, first),
+                             _mm256_cmpeq_epi8(bl, last))));
+        while (mask) {
+            const size_t bit = size_t(std::countr_zero(mask));
+            if (std::memcmp(hay + i + bit + 1, needle + 1, m - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    const std::string_view rest(reinterpret_cast<const char*>(hay + i), len - i);
+    const size_t p = rest.find(
+        std::string_view(reinterpret_cast<const char*>(needle), m));
+    return p == std::string_view::npos ? NPOS : i + p;
+}
+
+template<BitWidth Bits, std::invocable<size_t> F>
+void scan_bytes_impl(std::string_view needle,
+                     const uint64_t* ONPAIR_RESTRICT packed,
+                     const uint32_t* ONPAIR_RESTRICT bounds,
+                     size_t n,
+                     const uint8_t*  ONPAIR_RESTRICT dict_bytes,
+                     const uint32_t* ONPAIR_RESTRICT dict_offsets,
+                     F&& on_match)
+{
+    if (needle.empty()) {
+        for (size_t i = 0; i < n; ++i) on_match(i);
+        return;
+    }
+
+    const auto*  nd = reinterpret_cast<const uint8_t*>(needle.data());
+    const size_t m  = needle.size();
+
+    std::vector<Token>    toks(SCAN_BLOCK_TOKENS);
+    std::vector<uint8_t>  buf(SCAN_BLOCK_TOKENS * MAX_TOKEN_SIZE + MAX_TOKEN_SIZE);
+    std::vector<uint32_t> offs(SCAN_BLOCK_ROWS + 1);
+
+    size_t i = 0;
+    while (i < n) {
+        const uint32_t base = bounds[i];
+        const size_t   cap  = std::min(n, i + SCAN_BLOCK_ROWS);
+        size_t j = size_t(std::upper_bound(bounds + i + 1, bounds + cap + 1,
+                                           base + SCAN_BLOCK_TOKENS) - bounds) - 1;
+        if (j == i) {
+            // One row longer than a block: grow the buffers for it alone.
+            j = i + 1;
+            const size_t cnt = bounds[j] - base;
+            if (toks.size() < cnt) toks.resize(cnt);
+            if (buf.size() < cnt * MAX_TOKEN_SIZE + MAX_TOKEN_SIZE)
+                buf.resize(cnt * MAX_TOKEN_SIZE + MAX_TOKEN_SIZE);
+        }
+
+        const size_t len = decoding::detail::decode_rows<Bits>(
+            packed, bounds, dict_bytes, dict_offsets, i, j,
+            toks.data(), buf.data(), offs.data());
+
+        // Hits arrive in increasing position, so the row cursor only advances.
+        const uint32_t* row_end = offs.data() + 1;   // end offset of row i
+        size_t row = i;
+        size_t pos = 0;
+        while (pos + m <= len) {
+            const size_t hit = find_bytes(buf.data() + pos, len - pos, nd, m);
+            if (hit == NPOS) break;
+            const size_t at = pos + hit;
+            while (*row_end <= at) { ++row_end; ++row; }
+            if (at + m <= *row_end) {
+                on_match(row);
+                pos = *row_end;
+            } else {
+                pos = at + 1;
+            }
+        }
+        i = j;
+    }
+}
+
+} // namespace detail
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Engine selection
+// ─────────────────────────────────────────────────────────────────────────────
+// Token cost per row ≈ tokens × (step + sparse walk); byte cost per row ≈
+// tokens × copy + bytes × search.  The byte engine's copy alone is about the
+// price of a dense token step, so it only pays off when the average step
+// walks many sparse ranges.  Short needles do not qualify by themselves:
+// their KMP tables are tiny and every step is a single dense lookup.
+//
+// The threshold scales with the average dictionary token length: the byte
+// engine pays per byte, the token engine per token.  It is deliberately
+// conservative — on the corpora measured so far it keeps the token engine,
+// and contains_bytes() remains available for callers who know better.
+enum class ContainsEngine : uint8_t { tokens, bytes };
+
+inline ContainsEngine choose_contains_engine(std::string_view pattern,
+                                             DictionaryView dv,
+                                             const KmpAutomaton& kmp) noexcept
+{
+    if (pattern.empty()) return ContainsEngine::tokens;
+
+    // Mean sparse ranges walked per non-initial state.
+    const size_t states = kmp.pattern_length() > 1 ? kmp.pattern_length() - 1 : 1;
+    const double ranges_per_state = double(kmp.sparse_range_count()) / double(states);
+
+    const size_t   ntok      = dv.num_tokens();
+    const uint32_t dict_len  = ntok ? dv.raw_offsets()[ntok] : 0;
+    const double   avg_token = ntok ? double(dict_len) / double(ntok) : 1.0;
+
+    return ranges_per_state > 16.0 * avg_token ? ContainsEngine::bytes
+                                               : ContainsEngine::tokens;
+}
+
+} // namespace onpair::search
@@ -0,0 +1,182 @@
+#pragma once
+#include <onpair/column/column_view.h>
+#include <onpair/core/row_filter.h>
+#include <onpair/decoding/token_cursor.h>
+#include <onpair/search/automata/scan.h>
+#include <onpair/search/automata/token_automaton.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace onpair::search {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// ColumnPredicate — an automaton bound to the column it runs on
+// ─────────────────────────────────────────────────────────────────────────────
+// An lvalue automaton is held by reference; a temporary (e.g. `!kmp`) is
+// moved in.  The view must outlive the predicate.
+
+template<typename A>
+    requires TokenAutomaton<std::remove_reference_t<A>>
+struct ColumnPredicate {
+    OnPairColumnView view;
+    A                aut;
+};
+
+template<typename A>
+ColumnPredicate(const OnPairColumnView&, A&&) -> ColumnPredicate<A>;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Conjunction — AND of predicates over equally long columns, in one row loop
+// ─────────────────────────────────────────────────────────────────────────────
+// `a LIKE '%x%' AND b = 'y'` as two scans plus an intersection walks every
+// row of both columns.  Conjunction walks the rows once.  Each row is tested
+// against the predicates in order(), each on its own column's tokens, and it
+// stops at the first rejection, so later predicates only see rows that
+// survived the earlier ones.  Put the most selective or the cheapest
+// predicate first.  The default order is argument order.
+//
+// Rows that are null or deleted in any column never match.  Their bitmaps
+// are ANDed 64 rows at a time before any automaton runs.
+//
+//   search::KmpAutomaton kmp("x", a.dictionary());
+//   search::EqAutomaton  eq("y", b.dictionary());
+//   search::Conjunction q(search::ColumnPredicate{a, kmp},
+//                         search::ColumnPredicate{b, eq});
+//   q.set_order({1, 0});          // equality first
+//   auto rows = q.scan();
+
+template<typename... P>
+class Conjunction {
+public:
+    static constexpr size_t N = sizeof...(P);
+    static_assert(N >= 1, "at least one predicate");
+
+    // Throws std::invalid_argument when the columns differ in row count.
+    explicit Conjunction(P... preds) : preds_(std::move(preds)...) {
+        n_ = std::get<0>(preds_).view.num_strings();
+        std::apply([&](const auto&... p) {
+            if (((p.view.num_strings() != n_) || ...))
+                throw std::invalid_argument(
+                    "OnPair: conjunction columns differ in row count");
+        }, preds_);
+        for (size_t k = 0; k < N; ++k) order_[k] = k;
+    }
+
+    // Evaluation order: a permutation of [0, N) indexing the predicates.
+    // Throws std::invalid_argument if `order` is not one.
+    void set_order(std::span<const size_t> order) {
+        std::array<bool, N> seen{};
+        if (order.size() != N)
+            throw std::invalid_argument("OnPair: conjunction order has wrong size");
+        for (size_t k : order) {
+            if (k >= N || seen[k])
+                throw std::invalid_argument("OnPair: conjunction order is not a permutation");
+            seen[k] = true;
+        }
+        std::copy(order.begin(), order.end(), order_.begin());
+    }
+    void set_order(std::initializer_list<size_t> order) {
+        set_order(std::span<const size_t>(order.begin(), order.size()));
+    }
+    std::span<const size_t> order() const noexcept { return order_; }
+
+    size_t num_strings() const noexcept { return n_; }
+
+    // Calls on_match(row) for every row all predicates accept, ascending.
+    template<std::invocable<size_t> F>
+    void scan(F&& on_match) {
+        std::array<RowFilter, N> filters;
+        bool filtered = false;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((filters[Is] = RowFilter{std::get<Is>(preds_).view.validity(),
+                                      std::get<Is>(preds_).view.deletions()},
+              filtered |= bool(filters[Is])), ...);
+        }(std::index_sequence_for<P...>{});
+
+        // The leading predicate runs every row, so its loop is monomorphised
+        // on its index and bit width, with one cursor reset per row as in
+        // scan_impl.  The rest are reached through test_at().
+        with_index(order_[0], [&](auto lead) {
+            auto& p = std::get<lead.value>(preds_);
+            const StoreView sv = p.view.store();
+            dispatch_bits(sv.bits(), [&](auto bits) {
+                decoding::TokenCursor<bits.value> cursor(sv.packed_data());
+                const uint32_t* bounds = sv.boundaries();
+                auto test_row = [&](size_t i) {
+                    cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+                    if (!drive(p.aut, cursor)) return;
+                    for (size_t k = 1; k < N; ++k)
+                        if (!test_at(order_[k], i)) return;
+                    on_match(i);
+                };
+
+                if (!filtered) {
+                    for (size_t i = 0; i < n_; ++i) test_row(i);
+                    return;
+                }
+                for (size_t w = 0; w < validity_words(n_); ++w) {
+                    uint64_t m = ~uint64_t(0);
+                    for (const RowFilter& f : filters) m &= f.word(w, n_);
+                    for (; m; m &= m - 1)
+                        test_row(w * 64 + size_t(std::countr_zero(m)));
+                }
+            });
+        });
+    }
+
+    std::vector<size_t> scan() {
+        std::vector<size_t> result;
+        scan([&](size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+private:
+    // Drive predicate K over row i of its column.  The bit-width switch is
+    // per row, but it resolves the same way every time and predicts well.
+    template<size_t K>
+    bool test(size_t i) {
+        auto& p = std::get<K>(preds_);
+        const StoreView sv = p.view.store();
+        return dispatch_bits(sv.bits(), [&](auto bits) {
+            decoding::TokenCursor<bits.value> cursor(sv.packed_data(),
+                                                     sv.string_span(i));
+            return drive(p.aut, cursor);
+        });
+    }
+
+    // fn(std::integral_constant<size_t, k>{}) for a runtime k < N.  Expands
+    // to a compare chain rather than a call through a table, so fn inlines.
+    template<typename Fn>
+    static decltype(auto) with_index(size_t k, Fn&& fn) {
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            using R = decltype(fn(std::integral_constant<size_t, 0>{}));
+            if constexpr (std::is_void_v<R>) {
+                (void)((k == Is && (fn(std::integral_constant<size_t, Is>{}), true)) || ...);
+            } else {
+                R r{};
+                (void)((k == Is && (r = fn(std::integral_constant<size_t, Is>{}), true)) || ...);
+                return r;
+            }
+        }(std::index_sequence_for<P...>{});
+    }
+
+    bool test_at(size_t k, size_t i) {
+        return with_index(k, [&](auto K) { return test<K.value>(i); });
+    }
+
+    std::tuple<P...>      preds_;
+    std::array<size_t, N> order_{};
+    size_t                n_ = 0;
+};
+
+} // namespace onpair::search
@@ -0,0 +1,92 @@
+#pragma once
+#include <onpair/column/column_view.h>
+#include <onpair/core/generator.h>
+#include <onpair/core/row_filter.h>
+#include <onpair/decoding/token_cursor.h>
+#include <onpair/search/automata/scan.h>
+#include <onpair/search/automata/token_automaton.h>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace onpair::search {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// scan_batches — pull-based scan yielding batches of matching row ids
+// ─────────────────────────────────────────────────────────────────────────────
+// scan() pushes every match into a callback, so a pull-based operator must
+// either buffer the whole result or run the scan on another thread.
+// scan_batches() returns a Generator instead.  Each next() resumes the scan
+// loop where it last stopped and runs it until `batch_rows` more rows have
+// matched or the column ends, then yields them as a span.  Memory stays at
+// one batch, and no thread is involved.
+//
+//   auto gen = search::scan_batches(view, search::KmpAutomaton("x", dv));
+//   while (gen.next())
+//       consume(gen.value());        // std::span<const size_t>, ascending
+//
+// A span stays valid until the following next().  Rows are reported exactly
+// as scan() reports them, and null and deleted rows never match.
+//
+// The generator owns a copy of `view` and of `aut`: pass automata by value,
+// or std::move them in.  Combinators (!a, a && b) refer to their operands,
+// so those operands must outlive the generator.  The column must not be
+// modified while the generator is alive.
+
+namespace detail {
+
+template<BitWidth Bits, TokenAutomaton A>
+Generator<std::span<const size_t>>
+scan_batches_impl(OnPairColumnView view, A aut, size_t batch_rows)
+{
+    const StoreView sv     = view.store();
+    const uint32_t* bounds = sv.boundaries();
+    const size_t    n      = sv.num_strings();
+    const RowFilter filter{view.validity(), view.deletions()};
+
+    decoding::TokenCursor<Bits> cursor(sv.packed_data());
+    std::vector<size_t> batch;
+    batch.reserve(std::min(batch_rows, n));
+
+    for (size_t w = 0; w < validity_words(n); ++w) {
+        uint64_t m = filter ? filter.word(w, n)
+                            : (w == n / 64 ? (uint64_t(1) << (n % 64)) - 1
+                                           : ~uint64_t(0));
+        for (; m; m &= m - 1) {
+            const size_t i = w * 64 + size_t(std::countr_zero(m));
+            cursor.reset_to(StreamSpan{bounds[i], bounds[i + 1]});
+            if (!drive(aut, cursor)) continue;
+            batch.push_back(i);
+            if (batch.size() == batch_rows) {
+                co_yield std::span<const size_t>(batch);
+                batch.clear();
+            }
+        }
+    }
+    if (!batch.empty()) co_yield std::span<const size_t>(batch);
+}
+
+} // namespace detail
+
+inline constexpr size_t SCAN_BATCH_ROWS = 2048;
+
+// Throws std::invalid_argument when batch_rows is 0.
+template<typename A>
+    requires TokenAutomaton<std::remove_cvref_t<A>>
+Generator<std::span<const size_t>>
+scan_batches(OnPairColumnView view, A&& aut, size_t batch_rows = SCAN_BATCH_ROWS)
+{
+    if (batch_rows == 0)
+        throw std::invalid_argument("OnPair: scan_batches needs batch_rows > 0");
+    return dispatch_bits(view.bits(), [&](auto bits) {
+        return detail::scan_batches_impl<bits.value, std::remove_cvref_t<A>>(
+            view, std::forward<A>(aut), batch_rows);
+    });
+}
+
+} // namespace onpair::search
@@ -0,0 +1,185 @@
+#include <onpair/column/builder.h>
+#include <onpair/encoding/lpm.h>
+#include <onpair/encoding/parsing/bit_writer.h>
+#include <onpair/encoding/parsing/parser.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace onpair {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Stage — one producer's rows
+// ─────────────────────────────────────────────────────────────────────────────
+// Rows are staged as raw bytes until STAGE_BYTES have gathered, then parsed
+// onto the end of `store`, whose boundaries therefore cover every encoded
+// row.  `valid` and `seqs` cover encoded and staged rows alike.
+
+struct ColumnBuilder::Stage {
+    const encoding::LongestPrefixMatcher& lpm;
+    const Order                           order;
+
+    std::vector<uint8_t>  data;           // staged bytes
+    std::vector<uint32_t> offsets{0};     // staged rows
+    Store                 store;          // encoded rows
+    std::vector<uint64_t> valid;          // bit per row, set = valid
+    std::vector<uint64_t> seqs;           // Order::Preserve only
+    size_t                rows  = 0;
+    size_t                nulls = 0;
+    uint64_t              bytes = 0;      // raw bytes encoded
+
+    Stage(const encoding::LongestPrefixMatcher& m, BitWidth bits, Order o)
+        : lpm(m), order(o) {
+        store.bit_width = bits;
+        store.boundaries.push_back(0);
+    }
+
+    void push(std::string_view row, bool is_valid) {
+        if (rows % 64 == 0) valid.push_back(0);
+        valid.back() |= uint64_t(is_valid) << (rows % 64);
+        nulls += !is_valid;
+        ++rows;
+        data.insert(data.end(), row.begin(), row.end());
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+        if (data.size() >= STAGE_BYTES) encode();
+    }
+
+    void encode() {
+        const size_t n = offsets.size() - 1;
+        if (n == 0) return;
+        encoding::parse_append(data.data(), offsets.data(), n, lpm, store);
+        bytes += data.size();
+        data.clear();
+        offsets.resize(1);
+    }
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Producer
+// ─────────────────────────────────────────────────────────────────────────────
+
+void ColumnBuilder::Producer::add(std::string_view row) {
+    if (s_->order != Order::Relaxed)
+        throw std::logic_error("OnPair: ordered builder needs a sequence number");
+    s_->push(row, true);
+}
+
+void ColumnBuilder::Producer::add_null() {
+    if (s_->order != Order::Relaxed)
+        throw std::logic_error("OnPair: ordered builder needs a sequence number");
+    s_->push({}, false);
+}
+
+void ColumnBuilder::Producer::add(uint64_t seq, std::string_view row) {
+    if (s_->order != Order::Preserve)
+        throw std::logic_error("OnPair: relaxed builder takes no sequence number");
+    s_->seqs.push_back(seq);
+    s_->push(row, true);
+}
+
+void ColumnBuilder::Producer::add_null(uint64_t seq) {
+    if (s_->order != Order::Preserve)
+        throw std::logic_error("OnPair: relaxed builder takes no sequence number");
+    s_->seqs.push_back(seq);
+    s_->push({}, false);
+}
+
+void ColumnBuilder::Producer::flush() { s_->encode(); }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// ColumnBuilder
+// ─────────────────────────────────────────────────────────────────────────────
+
+ColumnBuilder::ColumnBuilder(const OnPairColumn& reference, Order order)
+    : dict_(reference.shared_dictionary()), lpm_(reference.encoder_),
+      bits_(reference.bits()), order_(order)
+{
+    if (!dict_)
+        throw std::logic_error("OnPair: builder needs a column with a dictionary");
+    if (!lpm_)
+        lpm_ = std::make_shared<const encoding::LongestPrefixMatcher>(
+            encoding::LongestPrefixMatcher::from_dictionary(reference.view().dictionary()));
+}
+
+ColumnBuilder::~ColumnBuilder() = default;
+
+ColumnBuilder::Producer ColumnBuilder::producer() {
+    std::lock_guard lk(mutex_);
+    stages_.push_back(std::make_unique<Stage>(*lpm_, bits_, order_));
+    return Producer(*stages_.back());
+}
+
+OnPairColumn ColumnBuilder::seal() {
+    std::vector<std::unique_ptr<Stage>> stages;
+    {
+        std::lock_guard lk(mutex_);
+        stages.swap(stages_);
+    }
+
+    size_t rows = 0, nulls = 0;
+    uint64_t bytes = 0;
+    for (auto& s : stages) {
+        s->encode();
+        rows  += s->rows;
+        nulls += s->nulls;
+        bytes += s->bytes;
+    }
+
+    OnPairColumn col;
+    Store& out = col.store_;
+    out.bit_width = bits_;
+    out.boundaries.reserve(rows + 1);
+    out.boundaries.push_back(0);
+    if (nulls) col.validity_.assign(validity_words(rows), 0);
+
+    {
+        encoding::BitWriter writer(out);
+        // Copy rows [first, first + count) of stage s to the end of `out`.
+        auto copy_rows = [&](const Stage& s, size_t first, size_t count) {
+            const uint32_t* b    = s.store.boundaries.data();
+            const size_t    base = writer.tokens_written();
+            writer.write_run(s.store.packed.data(), b[first], b[first + count] - b[first]);
+            for (size_t r = first; r < first + count; ++r) {
+                if (nulls && ((s.valid[r >> 6] >> (r & 63)) & 1u)) {
+                    const size_t i = out.boundaries.size() - 1;
+                    col.validity_[i >> 6] |= uint64_t(1) << (i & 63);
+                }
+                out.boundaries.push_back(
+                    static_cast<uint32_t>(base + b[r + 1] - b[first]));
+            }
+        };
+
+        if (order_ == Order::Relaxed) {
+            for (const auto& s : stages) copy_rows(*s, 0, s->rows);
+        } else {
+            struct Entry { uint64_t seq; uint32_t stage; uint32_t row; };
+            std::vector<Entry> entries;
+            entries.reserve(rows);
+            for (uint32_t k = 0; k < stages.size(); ++k)
+                for (uint32_t r = 0; r < stages[k]->rows; ++r)
+                    entries.push_back({stages[k]->seqs[r], k, r});
+            std::sort(entries.begin(), entries.end(),
+                      [](const Entry& a, const Entry& b) { return a.seq < b.seq; });
+            for (size_t i = 1; i < entries.size(); ++i)
+                if (entries[i].seq == entries[i - 1].seq)
+                    throw std::invalid_argument("OnPair: repeated sequence number");
+
+            // Rows that follow each other in one stage are copied as one run.
+            for (size_t i = 0; i < entries.size();) {
+                size_t j = i + 1;
+                while (j < entries.size() && entries[j].stage == entries[i].stage &&
+                       entries[j].row == entries[i].row + (j - i))
+                    ++j;
+                copy_rows(*stages[entries[i].stage], entries[i].row, j - i);
+                i = j;
+            }
+        }
+    }
+
+    col.dict_    = dict_;
+    col.encoder_ = lpm_;
+    col.drift_   = DriftMonitor({double(rows), double(bytes), double(out.num_tokens())});
+    return col;
+}
+
+} // namespace onpair
@@ -1,31 +1,212 @@
 #include <onpair/column/column.h>
+#include <onpair/core/cold_store.h>
 #include <onpair/encoding/training/trainer.h>
 #include <onpair/encoding/parsing/parser.h>
+#include <onpair/encoding/parsing/bit_writer.h>
+#include <onpair/decoding/detail/unpack.h>
+#include <algorithm>
+#include <cstring>
+#include <future>
 #include <istream>
+#include <optional>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace onpair {
 
+namespace {
+
+// Null rows are stored as empty strings.  Arrow leaves the bytes of a null
+// slot unspecified, so if any hold bytes, rebuild the input without them in
+// data_out / offsets_out and point data / offsets there; they must not reach
+// training or the store.
+void drop_null_bytes(const uint8_t*& data, const uint32_t*& offsets, size_t n,
+                     const uint64_t* mask, std::vector<uint8_t>& data_out,
+                     std::vector<uint32_t>& offsets_out)
+{
+    bool dirty = false;
+    for (size_t i = 0; i < n && !dirty; ++i)
+        dirty = !is_valid_row(mask, i) && offsets[i + 1] != offsets[i];
+    if (!dirty) return;
+
+    offsets_out.reserve(n + 1);
+    offsets_out.push_back(0);
+    for (size_t i = 0; i < n; ++i) {
+        if (is_valid_row(mask, i))
+            data_out.insert(data_out.end(), data + offsets[i], data + offsets[i + 1]);
+        offsets_out.push_back(static_cast<uint32_t>(data_out.size()));
+    }
+    data    = data_out.data();
+    offsets = offsets_out.data();
+}
+
+// Rows, decoded bytes and tokens of everything in the column's store.
+DriftTotals measure_store(const OnPairColumnView& v) {
+    constexpr uint32_t CHUNK = 4096;
+    const auto sv = v.store();
+    const auto dv = v.dictionary();
+    const uint32_t total = static_cast<uint32_t>(sv.num_tokens());
+    uint64_t bytes = 0;
+    if (total) {
+        dispatch_bits(sv.bits(), [&](auto bits) {
+            Token buf[CHUNK];
+            for (uint32_t lo = 0; lo < total; lo += CHUNK) {
+                const uint32_t cnt = std::min(CHUNK, total - lo);
+                decoding::detail::unpack_tokens<bits.value>(sv.packed_data(), lo, cnt, buf);
+                for (uint32_t k = 0; k < cnt; ++k) bytes += dv.token_size(buf[k]);
+            }
+        });
+    }
+    return {double(sv.num_strings()), double(bytes), double(total)};
+}
+
+} // namespace
+
 // ─────────────────────────────────────────────────────────────────────────────
 // compress_raw  (the single implementation that both public overloads reach)
 // ─────────────────────────────────────────────────────────────────────────────
 
-OnPairColumn OnPairColumn::compress_raw(const uint8_t*  data,
-                                         const uint32_t* offsets,
-                                         size_t          n,
-                                         const Config&   cfg)
+OnPairColumn OnPairColumn::compress_raw(const uint8_t*    data,
+                                         const uint32_t*   offsets,
+                                         size_t            n,
+                                         const Config&     cfg,
+                                         const uint8_t*    validity,
+                                         const RunControl* ctl,
+                                         RunResult*        result)
 {
-    OnPairColumn col;
+    const uint32_t* const input_offsets = offsets;
+    std::vector<uint64_t> packed_validity;
+    std::vector<uint8_t>  valid_data;
+    std::vector<uint32_t> valid_offsets;
+    if (validity) {
+        packed_validity = pack_validity(validity, n);
+        if (count_nulls(packed_validity.data(), n) == 0) packed_validity.clear();
+    }
+    if (!packed_validity.empty())
+        drop_null_bytes(data, offsets, n, packed_validity.data(),
+                        valid_data, valid_offsets);
 
+    // Training is not interruptible; it is bounded by the sample fraction.
+    if (ctl && ctl->stop_requested()) {
+        *result = {RunStatus::Cancelled, 0, 0};
+        return OnPairColumn();
+    }
     encoding::TrainResult trained = encoding::train(data, offsets, n, cfg);
-    encoding::parse(data, offsets, n, trained.lpm, cfg.bits, col.store_);
-    col.dict_ = std::move(trained.dict);
+    OnPairColumn col = encode_raw(
+        std::make_shared<const Dictionary>(std::move(trained.dict)), trained.lpm,
+        cfg.bits, data, offsets, n, cfg.collect_statistics, ctl);
+
+    const size_t done = col.store_.num_strings();
+    if (done < n && !packed_validity.empty()) {
+        packed_validity.resize(validity_words(done));
+        if (done % 64) packed_validity.back() &= (uint64_t(1) << (done % 64)) - 1;
+        if (count_nulls(packed_validity.data(), done) == 0) packed_validity.clear();
+    }
+    col.validity_ = std::move(packed_validity);
+    if (result)
+        *result = {done < n ? RunStatus::Cancelled : RunStatus::Complete, done,
+                   size_t(input_offsets[done] - input_offsets[0])};
+    return col;
+}
 
+// Parse rows [0, n) with an existing dictionary into a new column.
+OnPairColumn OnPairColumn::encode_raw(std::shared_ptr<const Dictionary> dict,
+                                      const encoding::LongestPrefixMatcher& lpm,
+                                      BitWidth bits, const uint8_t* data,
+                                      const uint32_t* offsets, size_t n,
+                                      bool collect_statistics,
+                                      const RunControl* ctl)
+{
+    OnPairColumn col;
+    if (collect_statistics) {
+        col.stats_.emplace();
+        n = encoding::parse(data, offsets, n, lpm, bits, col.store_, &*col.stats_, ctl);
+        col.stats_->token_frequency.resize(dict->num_tokens());
+    } else {
+        n = encoding::parse(data, offsets, n, lpm, bits, col.store_, nullptr, ctl);
+    }
+    col.dict_  = std::move(dict);
+    col.drift_ = DriftMonitor({double(n), double(offsets[n] - offsets[0]),
+                               double(col.store_.num_tokens())});
     return col;
 }
 
+OnPairColumn OnPairColumn::encode_nullable(std::shared_ptr<const Dictionary> dict,
+                                           const encoding::LongestPrefixMatcher& lpm,
+                                           BitWidth bits, const uint8_t* data,
+                                           const uint32_t* offsets, size_t n,
+                                           const uint8_t* validity,
+                                           bool collect_statistics)
+{
+    std::vector<uint64_t> packed_validity;
+    std::vector<uint8_t>  valid_data;
+    std::vector<uint32_t> valid_offsets;
+    if (validity) {
+        packed_validity = pack_validity(validity, n);
+        if (count_nulls(packed_validity.data(), n) == 0) packed_validity.clear();
+    }
+    if (!packed_validity.empty())
+        drop_null_bytes(data, offsets, n, packed_validity.data(),
+                        valid_data, valid_offsets);
+
+    OnPairColumn col = encode_raw(std::move(dict), lpm, bits, data, offsets, n,
+                                  collect_statistics);
+    col.validity_ = std::move(packed_validity);
+    return col;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Shared dictionaries
+// ─────────────────────────────────────────────────────────────────────────────
+
+std::vector<OnPairColumn>
+OnPairColumn::compress_shared_raw(const uint8_t* data, const uint32_t* offsets,
+                                  std::span<const size_t> rows, const Config& cfg)
+{
+    size_t total = 0;
+    for (size_t r : rows) total += r;
+
+    encoding::TrainResult trained = encoding::train(data, offsets, total, cfg);
+    const auto dict = std::make_shared<const Dictionary>(std::move(trained.dict));
+
+    std::vector<OnPairColumn> cols;
+    cols.reserve(rows.size());
+    size_t first = 0;
+    for (size_t r : rows) {
+        cols.push_back(encode_raw(dict, trained.lpm, cfg.bits, data,
+                                  offsets + first, r, cfg.collect_statistics));
+        first += r;
+    }
+    return cols;
+}
+
+OnPairColumn OnPairColumn::compress_with(const OnPairColumn& reference,
+                                         const char* data,
+                                         const uint32_t* offsets, size_t n)
+{
+    return compress_with_raw(reference, reinterpret_cast<const uint8_t*>(data),
+                             offsets, n);
+}
+
+OnPairColumn OnPairColumn::compress_with_raw(const OnPairColumn& reference,
+                                             const uint8_t* data,
+                                             const uint32_t* offsets, size_t n)
+{
+    if (!reference.shared_dictionary())
+        throw std::logic_error("OnPair: compress_with a column with no dictionary");
+    // Reuse the matcher an append() on the reference already built.
+    std::optional<encoding::LongestPrefixMatcher> built;
+    const encoding::LongestPrefixMatcher* lpm = reference.encoder_.get();
+    if (!lpm)
+        lpm = &built.emplace(encoding::LongestPrefixMatcher::from_dictionary(
+            reference.view().dictionary()));
+    return encode_raw(reference.shared_dictionary(), *lpm, reference.bits(), data, offsets, n,
+                      false);
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Arrow-style public overload
 // ─────────────────────────────────────────────────────────────────────────────
@@ -38,6 +219,190 @@ OnPairColumn OnPairColumn::compress(const char*     data,
     return compress_raw(reinterpret_cast<const uint8_t*>(data), offsets, n, cfg);
 }
 
+OnPairColumn OnPairColumn::compress(const char*     data,
+                                     const uint32_t* offsets,
+                                     size_t          n,
+                                     const uint8_t*  validity,
+                                     const Config&   cfg)
+{
+    return compress_raw(reinterpret_cast<const uint8_t*>(data), offsets, n, cfg,
+                        validity);
+}
+
+OnPairColumn OnPairColumn::compress(const char*       data,
+                                     const uint32_t*   offsets,
+                                     size_t            n,
+                                     const uint8_t*    validity,
+                                     const Config&     cfg,
+                                     const RunControl& ctl,
+                                     RunResult&        result)
+{
+    return compress_raw(reinterpret_cast<const uint8_t*>(data), offsets, n, cfg,
+                        validity, &ctl, &result);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Appending, drift and retraining
+// ─────────────────────────────────────────────────────────────────────────────
+
+void OnPairColumn::append(const char* data, const uint32_t* offsets, size_t n) {
+    append_raw(reinterpret_cast<const uint8_t*>(data), offsets, n, nullptr);
+}
+
+void OnPairColumn::append(const char* data, const uint32_t* offsets, size_t n,
+                          const uint8_t* validity) {
+    append_raw(reinterpret_cast<const uint8_t*>(data), offsets, n, validity);
+}
+
+void OnPairColumn::append_raw(const uint8_t* data, const uint32_t* offsets,
+                              size_t n, const uint8_t* validity)
+{
+    if (!dict_ && !lazy_)
+        throw std::logic_error("OnPair: append to a column with no dictionary");
+
+    std::vector<uint64_t> batch_validity;
+    std::vector<uint8_t>  valid_data;
+    std::vector<uint32_t> valid_offsets;
+    if (validity) {
+        batch_validity = pack_validity(validity, n);
+        if (count_nulls(batch_validity.data(), n) == 0) batch_validity.clear();
+    }
+    if (!batch_validity.empty())
+        drop_null_bytes(data, offsets, n, batch_validity.data(),
+                        valid_data, valid_offsets);
+
+    if (!encoder_)
+        encoder_ = std::make_shared<const encoding::LongestPrefixMatcher>(
+            encoding::LongestPrefixMatcher::from_dictionary(view().dictionary()));
+    if (!drift_.has_baseline() && drift_.observed_rows() == 0)
+        drift_ = DriftMonitor(measure_store(view()), drift_.policy());
+
+    const size_t old_rows   = num_strings();
+    const size_t old_tokens = store_.num_tokens();
+    encoding::parse_append(data, offsets, n, *encoder_, store_);
+    drift_.observe(n, offsets[n] - offsets[0], store_.num_tokens() - old_tokens);
+
+    const size_t rows = old_rows + n;
+    if (!batch_validity.empty() && validity_.empty()) {
+        validity_.assign(validity_words(old_rows), ~uint64_t(0));
+        if (old_rows % 64) validity_.back() = (uint64_t(1) << (old_rows % 64)) - 1;
+    }
+    if (!validity_.empty()) {
+        validity_.resize(validity_words(rows), 0);
+        for (size_t i = 0; i < n; ++i) {
+            if (!is_valid_row(batch_validity.empty() ? nullptr
+                                                      : batch_validity.data(), i))
+                continue;
+            const size_t r = old_rows + i;
+            validity_[r >> 6] |= uint64_t(1) << (r & 63);
+        }
+    }
+    if (!deleted_.empty()) deleted_.resize(validity_words(rows), 0);
+    stats_.reset();
+}
+
+OnPairColumn OnPairColumn::retrain(const Config& cfg) const {
+    const auto   v = view();
+    const size_t n = num_strings();
+
+    // Deleted rows come out as empty slots, so row ids line up.
+    std::vector<char>     buf(size_t(measure_store(v).bytes) + DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offs(n + 1);
+    v.decompress_all(buf.data(), offs.data());
+
+    OnPairColumn col = compress_raw(reinterpret_cast<const uint8_t*>(buf.data()),
+                                    offs.data(), n, cfg);
+    col.validity_ = validity_;
+    col.deleted_  = deleted_;
+    col.drift_.set_policy(drift_.policy());
+    return col;
+}
+
+std::future<OnPairColumn>
+OnPairColumn::retrain_async(std::shared_ptr<const OnPairColumn> snapshot, Config cfg) {
+    if (!snapshot)
+        throw std::invalid_argument("OnPair: retrain_async needs a column");
+    return std::async(std::launch::async,
+                      [snapshot = std::move(snapshot), cfg = std::move(cfg)] {
+                          return snapshot->retrain(cfg);
+                      });
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Deletes and compaction
+// ─────────────────────────────────────────────────────────────────────────────
+
+void OnPairColumn::erase(size_t row) {
+    erase(std::span<const size_t>(&row, 1));
+}
+
+void OnPairColumn::erase(std::span<const size_t> rows) {
+    const size_t n = num_strings();
+    for (size_t r : rows)
+        if (r >= n) throw std::out_of_range("OnPair: erase row out of range");
+    if (rows.empty()) return;
+    if (deleted_.empty()) deleted_.assign(validity_words(n), 0);
+    for (size_t r : rows) deleted_[r >> 6] |= uint64_t(1) << (r & 63);
+}
+
+void OnPairColumn::compact() {
+    if (deleted_.empty()) return;
+    const size_t    n      = num_strings();
+    const uint64_t* del    = deleted_.data();
+    const uint32_t* bounds = store_.boundaries.data();
+
+    Store out;
+    out.bit_width = store_.bit_width;
+    out.boundaries.reserve(n + 1 - count_deleted(del, n));
+    out.boundaries.push_back(0);
+    std::vector<uint64_t> validity;
+    if (!validity_.empty()) validity.assign(validity_words(n), 0);
+
+    {
+        encoding::BitWriter writer(out);
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ) {
+            if (is_deleted_row(del, i)) { ++i; continue; }
+            // Stream positions in the run move by this much (mod 2^32).
+            const uint32_t base = uint32_t(writer.tokens_written()) - bounds[i];
+            size_t j = i;
+            for (; j < n && !is_deleted_row(del, j); ++j) {
+                out.boundaries.push_back(base + bounds[j + 1]);
+                if (!validity.empty() && is_valid_row(validity_.data(), j))
+                    validity[kept >> 6] |= uint64_t(1) << (kept & 63);
+                ++kept;
+            }
+            writer.write_run(store_.packed.data(), bounds[i], bounds[j] - bounds[i]);
+            i = j;
+        }
+    }
+
+    if (!validity.empty()) {
+        validity.resize(validity_words(out.num_strings()));
+        if (count_nulls(validity.data(), out.num_strings()) == 0) validity.clear();
+    }
+    store_    = std::move(out);
+    validity_ = std::move(validity);
+    deleted_.clear();
+    stats_.reset();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Compact dictionary
+// ─────────────────────────────────────────────────────────────────────────────
+
+void OnPairColumn::compact_dictionary() {
+    if (lazy_) {
+        if (lazy_->expanded())
+            lazy_ = std::make_shared<const LazyDictionary>(lazy_->compact());
+    } else if (dict_) {
+        lazy_ = std::make_shared<const LazyDictionary>(
+            std::make_shared<const CompactDictionary>(CompactDictionary::encode(*dict_)));
+        dict_.reset();
+    }
+    encoder_.reset();   // built over the expanded dictionary, and larger than it
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Serialisation
 // ─────────────────────────────────────────────────────────────────────────────
@@ -76,59 +441,298 @@ std::vector<T> read_vec(std::istream& in) {
 } // namespace
 
 // Binary format:
-//   "ONPAIR01"            8 bytes  magic + version
+//   "ONPAIR01" … "ONPAIR04"  8 bytes  magic + version
 //   bit_width             1 byte
-//   dict.bytes            uint32 count + data
-//   dict.offsets          uint32 count + uint32 data
-//   store.packed          uint32 count + uint64 data  (sentinel word excluded)
-//   store.boundaries      uint32 count + uint32 data
+//   ONPAIR04 only — flags 1 byte: COLD_COMPACT_DICTIONARY
+//   ONPAIR01 / ONPAIR02, and ONPAIR04 without the flag:
+//     dict.bytes          uint32 count + data
+//     dict.offsets        uint32 count + uint32 data
+//   ONPAIR03, and ONPAIR04 with the flag — compact dictionary
+//   (compact_dictionary.h):
+//     num_tokens          uint32
+//     compact bytes       uint32 count + data
+//   ONPAIR01 … ONPAIR03:
+//     store.packed        uint32 count + uint64 data  (sentinel word excluded)
+//     store.boundaries    uint32 count + uint32 data
+//   ONPAIR04 — entropy-coded store (ColdStore::write_to, cold_store.h)
+//   ONPAIR02 … ONPAIR04 — optional sections, each:
+//     tag                 uint32 (0 terminates the list)
+//     length              uint64 payload bytes
+//     payload
+//   Unknown tags are skipped, so later sections stay readable by this code.
+//   write_cold() writes ONPAIR04.  write_to() writes columns with a compact
+//   dictionary as ONPAIR03, others without optional data as ONPAIR01.
+
+static constexpr char MAGIC_V1[8] = {'O','N','P','A','I','R','0','1'};
+static constexpr char MAGIC_V2[8] = {'O','N','P','A','I','R','0','2'};
+static constexpr char MAGIC_V3[8] = {'O','N','P','A','I','R','0','3'};
+static constexpr char MAGIC_V4[8] = {'O','N','P','A','I','R','0','4'};
+
+static constexpr uint8_t COLD_COMPACT_DICTIONARY = 1;
+
+namespace {
 
-static constexpr char MAGIC[8] = {'O','N','P','A','I','R','0','1'};
+enum SectionTag : uint32_t {
+    SECTION_END        = 0,
+    SECTION_STATISTICS = 1,
+    SECTION_VALIDITY   = 2,   // uint32 count + uint64 words (validity.h)
+    SECTION_DELETIONS  = 3,   // uint32 count + uint64 words (row_filter.h)
+    SECTION_DRIFT      = 4,   // DriftMonitor state (drift.h)
+};
+
+void write_section(std::ostream& out, uint32_t tag, const std::string& payload) {
+    write_pod(out, tag);
+    write_pod(out, static_cast<uint64_t>(payload.size()));
+    out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+}
+
+std::string encode_statistics(const ColumnStatistics& s) {
+    std::ostringstream out;
+    write_pod(out, s.num_strings);
+    write_pod(out, s.total_bytes);
+    write_pod(out, s.min_length);
+    write_pod(out, s.max_length);
+    write_pod(out, s.empty_count);
+    write_pod(out, static_cast<uint8_t>(s.min_exact));
+    write_pod(out, static_cast<uint8_t>(s.max_exact));
+    write_vec(out, s.min_prefix);
+    write_vec(out, s.max_prefix);
+    write_vec(out, s.token_count_histogram);
+    write_vec(out, s.token_frequency);
+    write_pod(out, s.distinct.precision());
+    const auto regs = s.distinct.registers();
+    write_vec(out, std::vector<uint8_t>(regs.begin(), regs.end()));
+    return std::move(out).str();
+}
+
+ColumnStatistics decode_statistics(std::istream& in) {
+    ColumnStatistics s;
+    s.num_strings           = read_pod<uint64_t>(in);
+    s.total_bytes           = read_pod<uint64_t>(in);
+    s.min_length            = read_pod<uint32_t>(in);
+    s.max_length            = read_pod<uint32_t>(in);
+    s.empty_count           = read_pod<uint64_t>(in);
+    s.min_exact             = read_pod<uint8_t>(in) != 0;
+    s.max_exact             = read_pod<uint8_t>(in) != 0;
+    s.min_prefix            = read_vec<Token>(in);
+    s.max_prefix            = read_vec<Token>(in);
+    s.token_count_histogram = read_vec<uint64_t>(in);
+    s.token_frequency       = read_vec<uint32_t>(in);
+    const auto precision    = read_pod<uint8_t>(in);
+    const auto regs         = read_vec<uint8_t>(in);
+    try {
+        s.distinct = analytics::HyperLogLog::from_registers(precision, regs);
+    } catch (const std::invalid_argument&) {
+        throw std::runtime_error("OnPair: corrupt statistics section");
+    }
+    return s;
+}
+
+void write_totals(std::ostream& out, const DriftTotals& t) {
+    write_pod(out, t.rows);
+    write_pod(out, t.bytes);
+    write_pod(out, t.tokens);
+}
+
+DriftTotals read_totals(std::istream& in) {
+    DriftTotals t;
+    t.rows   = read_pod<double>(in);
+    t.bytes  = read_pod<double>(in);
+    t.tokens = read_pod<double>(in);
+    return t;
+}
+
+std::string encode_drift(const DriftMonitor& d) {
+    std::ostringstream out;
+    const DriftPolicy& p = d.policy();
+    write_pod(out, p.min_bytes_per_token_ratio);
+    write_pod(out, p.max_tokens_per_row_ratio);
+    write_pod(out, p.min_rows);
+    write_pod(out, p.window_rows);
+    write_totals(out, d.baseline());
+    write_totals(out, d.recent());
+    write_pod(out, d.observed_rows());
+    return std::move(out).str();
+}
+
+DriftMonitor decode_drift(std::istream& in) {
+    DriftPolicy p;
+    p.min_bytes_per_token_ratio = read_pod<double>(in);
+    p.max_tokens_per_row_ratio  = read_pod<double>(in);
+    p.min_rows                  = read_pod<uint64_t>(in);
+    p.window_rows               = read_pod<uint64_t>(in);
+    const DriftTotals baseline  = read_totals(in);
+    const DriftTotals recent    = read_totals(in);
+    const uint64_t    observed  = read_pod<uint64_t>(in);
+    return DriftMonitor(baseline, recent, observed, p);
+}
+
+} // namespace
 
 void OnPairColumn::write_to(std::ostream& out) const {
-    out.write(MAGIC, 8);
+    write_impl(out, false);
+}
+
+void OnPairColumn::write_cold(std::ostream& out) const {
+    write_impl(out, true);
+}
+
+void OnPairColumn::write_impl(std::ostream& out, bool cold) const {
+    // A drift monitor that has seen no appends and uses the default policy
+    // is rebuilt from the store at the first append, so it is not written.
+    const bool has_drift =
+        drift_.observed_rows() > 0 || !(drift_.policy() == DriftPolicy{});
+    const bool has_sections = stats_.has_value() || !validity_.empty() ||
+                              !deleted_.empty() || has_drift;
+    out.write(cold ? MAGIC_V4 : lazy_ ? MAGIC_V3 : has_sections ? MAGIC_V2 : MAGIC_V1, 8);
 
     write_pod(out, store_.bit_width);
+    if (cold) write_pod(out, static_cast<uint8_t>(lazy_ ? COLD_COMPACT_DICTIONARY : 0));
 
-    // Write only the true token bytes (offsets.back()), not the trailing
-    // decoder-padding added by pad_for_decoder().  read_from() re-adds it.
-    const uint32_t true_bytes = dict_.offsets.empty() ? 0u : dict_.offsets.back();
-    write_pod(out, true_bytes);
-    if (true_bytes) out.write(reinterpret_cast<const char*>(dict_.bytes.data()), true_bytes);
-    write_vec(out, dict_.offsets);
-    // Write packed words without the trailing sentinel added by BitWriter::flush().
-    // read_from() re-adds it.
-    {
+    if (lazy_) {
+        const CompactDictionary& c = *lazy_->compact();
+        write_pod(out, static_cast<uint32_t>(c.num_tokens()));
+        write_vec(out, c.bytes());
+    } else {
+        // Write only the true token bytes (offsets.back()), not the trailing
+        // decoder-padding added by pad_for_decoder().  read_from() re-adds it.
+        const Dictionary& d = dict();
+        const uint32_t true_bytes = d.offsets.empty() ? 0u : d.offsets.back();
+        write_pod(out, true_bytes);
+        if (true_bytes) out.write(reinterpret_cast<const char*>(d.bytes.data()), true_bytes);
+        write_vec(out, d.offsets);
+    }
+    if (cold) {
+        // Statistics, when kept, already hold the token histogram.
+        std::span<const uint32_t> frequency;
+        if (stats_) frequency = stats_->token_frequency;
+        ColdStore::encode(store_, frequency).write_to(out);
+    } else {
+        // Write packed words without the trailing sentinel added by
+        // BitWriter::flush().  read_from() re-adds it.
         const uint32_t real_words = store_.packed.empty()
             ? 0u : static_cast<uint32_t>(store_.packed.size()) - 1u;
         write_pod(out, real_words);
         if (real_words)
             out.write(reinterpret_cast<const char*>(store_.packed.data()),
                       real_words * sizeof(uint64_t));
+        write_vec(out, store_.boundaries);
+    }
+
+    if (has_sections || lazy_ || cold) {
+        if (stats_)
+            write_section(out, SECTION_STATISTICS, encode_statistics(*stats_));
+        if (!validity_.empty()) {
+            std::ostringstream payload;
+            write_vec(payload, validity_);
+            write_section(out, SECTION_VALIDITY, std::move(payload).str());
+        }
+        if (!deleted_.empty()) {
+            std::ostringstream payload;
+            write_vec(payload, deleted_);
+            write_section(out, SECTION_DELETIONS, std::move(payload).str());
+        }
+        if (has_drift)
+            write_section(out, SECTION_DRIFT, encode_drift(drift_));
+        write_pod(out, static_cast<uint32_t>(SECTION_END));
     }
-    write_vec(out, store_.boundaries);
 }
 
 OnPairColumn OnPairColumn::read_from(std::istream& in) {
+    return read_from(in, nullptr);
+}
+
+OnPairColumn OnPairColumn::read_from(std::istream& in,
+                                     const std::shared_ptr<const Dictionary>& shared)
+{
     char magic[8];
     in.read(magic, 8);
-    if (!in || std::memcmp(magic, MAGIC, 8) != 0)
+    const bool v1 = in && std::memcmp(magic, MAGIC_V1, 8) == 0;
+    const bool v2 = in && std::memcmp(magic, MAGIC_V2, 8) == 0;
+    const bool v3 = in && std::memcmp(magic, MAGIC_V3, 8) == 0;
+    const bool v4 = in && std::memcmp(magic, MAGIC_V4, 8) == 0;
+    if (!v1 && !v2 && !v3 && !v4)
         throw std::runtime_error("OnPair: invalid magic / wrong version");
 
     const uint8_t bit_width = read_pod<uint8_t>(in);
     if (!is_valid_bits(bit_width))
         throw std::runtime_error("OnPair: invalid bit_width in file");
+    const uint8_t flags = v4 ? read_pod<uint8_t>(in) : 0;
+    if (flags & ~COLD_COMPACT_DICTIONARY)
+        throw std::runtime_error("OnPair: unknown flags in file");
 
     OnPairColumn col;
-    col.dict_.bytes   = read_vec<uint8_t>(in);
-    col.dict_.offsets = read_vec<uint32_t>(in);
-    col.dict_.pad_for_decoder();  // restore decoder-padding stripped by write_to()
-
-    col.store_.bit_width  = bit_width;
-    col.store_.packed = read_vec<uint64_t>(in);
-    if (!col.store_.packed.empty())
-        col.store_.packed.push_back(0);  // restore sentinel for safe over-read
-    col.store_.boundaries = read_vec<uint32_t>(in);
+    const auto same_as_shared = [&](const Dictionary& dict) {
+        const uint32_t len = dict.offsets.empty() ? 0u : dict.offsets.back();
+        return dict.offsets == shared->offsets && len <= shared->bytes.size() &&
+               std::equal(dict.bytes.begin(), dict.bytes.begin() + len,
+                          shared->bytes.begin());
+    };
+    if (v3 || (flags & COLD_COMPACT_DICTIONARY)) {
+        // Stays compact unless it is `shared`, which only an expansion shows.
+        const uint32_t num_tokens = read_pod<uint32_t>(in);
+        auto compact = std::make_shared<const CompactDictionary>(
+            CompactDictionary::from_bytes(num_tokens, read_vec<uint8_t>(in)));
+        if (shared && same_as_shared(compact->expand()))
+            col.dict_ = shared;
+        else
+            col.lazy_ = std::make_shared<const LazyDictionary>(std::move(compact));
+    } else {
+        Dictionary dict;
+        dict.bytes   = read_vec<uint8_t>(in);
+        dict.offsets = read_vec<uint32_t>(in);
+        if (shared && same_as_shared(dict)) {
+            col.dict_ = shared;
+        } else {
+            dict.pad_for_decoder();  // restore decoder-padding stripped by write_to()
+            col.dict_ = std::make_shared<const Dictionary>(std::move(dict));
+        }
+    }
+
+    if (v4) {
+        col.store_ = ColdStore::read_from(in).decode();
+        if (col.store_.bit_width != bit_width)
+            throw std::runtime_error("OnPair: corrupt cold store");
+    } else {
+        col.store_.bit_width  = bit_width;
+        col.store_.packed = read_vec<uint64_t>(in);
+        if (!col.store_.packed.empty())
+            col.store_.packed.push_back(0);  // restore sentinel for safe over-read
+        col.store_.boundaries = read_vec<uint32_t>(in);
+    }
+
+    if (v2 || v3 || v4) {
+        for (;;) {
+            const uint32_t tag = read_pod<uint32_t>(in);
+            if (tag == SECTION_END) break;
+            const uint64_t len = read_pod<uint64_t>(in);
+            std::string payload(len, '\0');
+            in.read(payload.data(), static_cast<std::streamsize>(len));
+            if (!in) throw std::runtime_error("OnPair: truncated file");
+
+            std::istringstream section(std::move(payload));
+            switch (tag) {
+            case SECTION_STATISTICS:
+                col.stats_ = decode_statistics(section);
+                break;
+            case SECTION_VALIDITY:
+                col.validity_ = read_vec<uint64_t>(section);
+                if (col.validity_.size() != validity_words(col.store_.num_strings()))
+                    throw std::runtime_error("OnPair: corrupt validity section");
+                break;
+            case SECTION_DELETIONS:
+                col.deleted_ = read_vec<uint64_t>(section);
+                if (col.deleted_.size() != validity_words(col.store_.num_strings()))
+                    throw std::runtime_error("OnPair: corrupt deletion section");
+                break;
+            case SECTION_DRIFT:
+                col.drift_ = decode_drift(section);
+                break;
+            default:
+                break;   // unknown section: skip
+            }
+        }
+    }
 
     return col;
 }
@@ -0,0 +1,158 @@
+#include <onpair/column/column.h>
+#include <onpair/encoding/parsing/parser.h>
+#include <onpair/encoding/training/trainer.h>
+#include <onpair/search/automata/kmp_automaton.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <variant>
+#include <vector>
+
+namespace onpair {
+
+namespace {
+
+// A set of rows copied out into Arrow form.
+struct Sample {
+    std::vector<uint8_t>  data;
+    std::vector<uint32_t> offsets{0};
+
+    void add(const uint8_t* row, size_t len) {
+        data.insert(data.end(), row, row + len);
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+    }
+    size_t rows() const noexcept { return offsets.size() - 1; }
+};
+
+// Best-of-N throughput of run() over `bytes`, repeating for at least
+// MIN_TIME so one timer tick or one page fault does not decide it.
+template<typename F>
+double bytes_per_second(size_t bytes, F&& run) {
+    using clock = std::chrono::steady_clock;
+    constexpr auto   MIN_TIME = std::chrono::milliseconds(2);
+    constexpr size_t MAX_REPS = 64;
+
+    double best = std::numeric_limits<double>::infinity();
+    const auto start = clock::now();
+    for (size_t rep = 0; rep < MAX_REPS; ++rep) {
+        const auto t0 = clock::now();
+        run();
+        const auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+        if (t1 - start >= MIN_TIME) break;
+    }
+    return best > 0 ? double(bytes) / best : 0;
+}
+
+// Keeps `v`, and the work that computed it, from being optimised away.
+void keep(size_t v) noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+    asm volatile("" : : "r"(v) : "memory");
+#else
+    volatile size_t sink = v;
+    (void)sink;
+#endif
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// estimate
+// ─────────────────────────────────────────────────────────────────────────────
+
+CompressionEstimate OnPairColumn::estimate(const char*     data,
+                                           const uint32_t* offsets,
+                                           size_t          n,
+                                           const Config&   cfg,
+                                           size_t          sample_bytes)
+{
+    if (sample_bytes == 0)
+        throw std::invalid_argument("OnPair: estimate needs sample_bytes > 0");
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    CompressionEstimate e;
+    e.rows        = n;
+    e.input_bytes = offsets[n] - offsets[0];
+
+    Config train_cfg = cfg;
+    train_cfg.collect_statistics = false;
+
+    Sample train, parse;
+    if (e.input_bytes < 2 * sample_bytes || n < 4) {
+        for (size_t i = 0; i < n; ++i)
+            train.add(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+        parse = train;
+    } else {
+        // One row per stride for each sample, at independent random
+        // positions, so the samples are disjoint and cover the whole input.
+        const double avg_row = double(e.input_bytes) / double(n);
+        const size_t per_sample = std::clamp<size_t>(
+            size_t(std::ceil(double(sample_bytes) / std::max(avg_row, 1.0))),
+            1, n / 2);
+        const size_t stride = n / per_sample;
+        std::mt19937_64 rng(cfg.seed.value_or(std::random_device{}()));
+        for (size_t k = 0; k < per_sample; ++k) {
+            const size_t a = rng() % stride;
+            size_t       b = rng() % (stride - 1);
+            b += (b >= a);
+            const size_t ra = k * stride + a, rb = k * stride + b;
+            train.add(bytes + offsets[ra], offsets[ra + 1] - offsets[ra]);
+            parse.add(bytes + offsets[rb], offsets[rb + 1] - offsets[rb]);
+        }
+
+        // compress() would train on sample_fraction of the whole input.
+        // Spend the same number of bytes here, as far as the sample goes.
+        if (auto* dt = std::get_if<encoding::DynamicThreshold>(&train_cfg.threshold)) {
+            const double budget = dt->sample_fraction * double(e.input_bytes);
+            dt->sample_fraction =
+                std::min(1.0, budget / std::max(1.0, double(train.data.size())));
+        }
+    }
+    e.train_rows = train.rows();
+    e.parse_rows = parse.rows();
+
+    const encoding::TrainResult trained =
+        encoding::train(train.data.data(), train.offsets.data(), train.rows(), train_cfg);
+    Store store;
+    encoding::parse(parse.data.data(), parse.offsets.data(), parse.rows(),
+                    trained.lpm, cfg.bits, store);
+
+    // ── Projection ────────────────────────────────────────────────────────────
+    const size_t parse_bytes = parse.data.size();
+    const size_t tokens      = store.num_tokens();
+    e.dictionary_tokens = trained.dict.num_tokens();
+    e.bytes_per_token   = tokens ? double(parse_bytes) / double(tokens) : 0;
+    e.tokens_per_row    = parse.rows() ? double(tokens) / double(parse.rows()) : 0;
+
+    const double projected_tokens =
+        e.bytes_per_token > 0 ? double(e.input_bytes) / e.bytes_per_token : 0;
+    e.bytes_used = size_t(std::ceil(projected_tokens * cfg.bits / 8))
+                 + (n + 1) * sizeof(uint32_t) + trained.dict.bytes_used();
+    e.compression_ratio = double(e.input_bytes) / double(e.bytes_used);
+
+    // ── Timing ────────────────────────────────────────────────────────────────
+    if (parse_bytes == 0) return e;
+    const OnPairColumnView v(store, trained.dict);
+
+    std::vector<char>     buf(parse_bytes + DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> out_offsets(parse.rows() + 1);
+    e.decode_bytes_per_second = bytes_per_second(parse_bytes, [&] {
+        v.decompress_all(buf.data(), out_offsets.data());
+    });
+
+    // A pattern that (almost) never occurs, so every token of every row is
+    // stepped: the cost of a selective substring predicate.
+    search::KmpAutomaton kmp("\xff\xfe\xfd", v.dictionary());
+    e.scan_bytes_per_second = bytes_per_second(parse_bytes, [&] {
+        size_t hits = 0;
+        v.scan(kmp, [&](size_t) { ++hits; });
+        keep(hits);
+    });
+
+    return e;
+}
+
+} // namespace onpair
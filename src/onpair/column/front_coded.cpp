@@ -0,0 +1,64 @@
+#include <onpair/column/front_coded.h>
+#include <onpair/decoding/token_cursor.h>
+#include <onpair/encoding/parsing/bit_writer.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace onpair {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// encode
+// ─────────────────────────────────────────────────────────────────────────────
+
+FrontCodedColumn FrontCodedColumn::encode(const OnPairColumn& col,
+                                          size_t restart_interval)
+{
+    if (restart_interval == 0 || restart_interval > MAX_FRONT_CODING_RESTART)
+        throw std::invalid_argument("OnPair: front coding needs a restart interval "
+                                    "in [1, MAX_FRONT_CODING_RESTART]");
+
+    const OnPairColumnView v = col.view();
+    const StoreView        sv = v.store();
+    const size_t           n  = v.num_strings();
+
+    FrontCodedColumn fc;
+    fc.dict_     = col.shared_dictionary();
+    fc.restart_  = restart_interval;
+    fc.store_.bit_width = v.bits();
+    if (n == 0) return fc;
+
+    if (v.validity())  fc.validity_.assign(v.validity(),  v.validity()  + validity_words(n));
+    if (v.deletions()) fc.deleted_.assign(v.deletions(), v.deletions() + validity_words(n));
+    fc.shared_.reserve(n);
+    fc.store_.boundaries.reserve(n + 1);
+    fc.store_.boundaries.push_back(0);
+
+    constexpr size_t MAX_SHARED = std::numeric_limits<uint16_t>::max();
+    encoding::BitWriter writer(fc.store_);
+    dispatch_bits(v.bits(), [&](auto bits) {
+        decoding::TokenCursor<bits.value> cursor(sv.packed_data());
+        std::vector<Token> prev, cur;
+        for (size_t i = 0; i < n; ++i) {
+            cur.clear();
+            cursor.reset_to(sv.string_span(i));
+            while (cursor.has_more()) cur.push_back(cursor.next());
+
+            size_t s = 0;
+            if (i % restart_interval != 0) {
+                const size_t limit = std::min({prev.size(), cur.size(), MAX_SHARED});
+                while (s < limit && prev[s] == cur[s]) ++s;
+            }
+            fc.shared_.push_back(static_cast<uint16_t>(s));
+            fc.max_row_tokens_ = std::max(fc.max_row_tokens_, cur.size());
+            for (size_t k = s; k < cur.size(); ++k) writer.write(cur[k]);
+            fc.store_.boundaries.push_back(static_cast<uint32_t>(writer.tokens_written()));
+            std::swap(prev, cur);
+        }
+    });
+    writer.flush();
+    return fc;
+}
+
+} // namespace onpair
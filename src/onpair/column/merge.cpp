@@ -0,0 +1,246 @@
+#include <onpair/column/column.h>
+#include <onpair/decoding/detail/unpack.h>
+#include <onpair/decoding/token_cursor.h>
+#include <onpair/encoding/lpm.h>
+#include <onpair/encoding/parsing/bit_writer.h>
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace onpair {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// merge — concatenate columns by translating dictionaries
+// ─────────────────────────────────────────────────────────────────────────────
+// 1. Target dictionary: the sorted union of the source dictionaries when it
+//    fits 2^bits (bits = widest source), otherwise the single-byte tokens
+//    plus the multi-byte tokens that save the most bytes across the sources.
+// 2. Per source, a token → token remap table.  A source token is *stable*
+//    when it survives into the target and no target token absent from that
+//    source extends it.  A greedy longest-prefix parse under the target
+//    then picks exactly the tokens the source parse picked, so stable
+//    tokens are copied through the table.
+// 3. At a row's first unstable token the rest of the row is decoded.  The
+//    target matcher runs only at unstable tokens and wherever its parse has
+//    drifted off the source token boundaries; once back on a boundary,
+//    stable tokens are copied again.  Rows made of stable tokens — all of
+//    them when the sources share a dictionary — are never decoded.
+//
+// The output is therefore tokenized exactly as parse() would tokenize the
+// concatenated input under the target dictionary, which equality search
+// and row hashing rely on.
+
+namespace {
+
+constexpr uint32_t RETOKENIZE = uint32_t(1) << 16;   // flag in remap entries
+constexpr uint32_t COUNT_CHUNK_TOKENS = 4096;
+
+std::string_view token_bytes(DictionaryView dv, Token t) noexcept {
+    return {reinterpret_cast<const char*>(dv.data(t)), dv.token_size(t)};
+}
+
+// Occurrences of each token in a source's packed stream.
+std::vector<uint64_t> count_tokens(const OnPairColumnView& src) {
+    const auto sv = src.store();
+    std::vector<uint64_t> freq(src.dictionary().num_tokens(), 0);
+    const uint32_t total = static_cast<uint32_t>(sv.num_tokens());
+    dispatch_bits(sv.bits(), [&](auto bits) {
+        Token buf[COUNT_CHUNK_TOKENS];
+        for (uint32_t lo = 0; lo < total; lo += COUNT_CHUNK_TOKENS) {
+            const uint32_t cnt = std::min(COUNT_CHUNK_TOKENS, total - lo);
+            decoding::detail::unpack_tokens<bits.value>(sv.packed_data(), lo, cnt, buf);
+            for (uint32_t k = 0; k < cnt; ++k) ++freq[buf[k]];
+        }
+    });
+    return freq;
+}
+
+Dictionary build_target(std::span<const OnPairColumnView> sources, BitWidth bits) {
+    std::vector<std::string_view> tokens;
+    for (const auto& src : sources) {
+        const auto dv = src.dictionary();
+        for (size_t t = 0; t < dv.num_tokens(); ++t)
+            tokens.push_back(token_bytes(dv, Token(t)));
+    }
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+    if (tokens.size() > max_dict_size(bits)) {
+        // Keep the tokens that save the most bytes: occurrences × (len - 1).
+        boost::unordered_flat_map<std::string_view, uint64_t> saved;
+        for (const auto& src : sources) {
+            const auto dv   = src.dictionary();
+            const auto freq = count_tokens(src);
+            for (size_t t = 0; t < dv.num_tokens(); ++t) {
+                const auto b = token_bytes(dv, Token(t));
+                saved[b] += freq[t] * (b.size() - 1);
+            }
+        }
+        // Single-byte tokens always stay, so they rank first.
+        auto score = [&](std::string_view b) {
+            return b.size() == 1 ? UINT64_MAX : saved[b];
+        };
+        std::nth_element(tokens.begin(), tokens.begin() + max_dict_size(bits),
+                         tokens.end(), [&](std::string_view a, std::string_view b) {
+                             return score(a) > score(b);
+                         });
+        tokens.resize(max_dict_size(bits));
+        std::sort(tokens.begin(), tokens.end());
+    }
+
+    Dictionary dict;
+    dict.offsets.reserve(tokens.size() + 1);
+    dict.offsets.push_back(0);
+    for (auto b : tokens) {
+        dict.bytes.insert(dict.bytes.end(), b.begin(), b.end());
+        dict.offsets.push_back(static_cast<uint32_t>(dict.bytes.size()));
+    }
+    dict.pad_for_decoder();
+    return dict;
+}
+
+// remap[t] = target id of source token t, with RETOKENIZE set when t is not
+// stable (see above).  Both dictionaries are sorted, so one merge walk
+// aligns them, and the target tokens extending t are the run right after t.
+std::vector<uint32_t> build_remap(DictionaryView src, DictionaryView dst) {
+    const size_t ns = src.num_tokens(), nd = dst.num_tokens();
+    std::vector<uint32_t> remap(ns, RETOKENIZE);
+    std::vector<uint8_t>  in_source(nd, 0);
+
+    for (size_t s = 0, d = 0; s < ns && d < nd; ) {
+        const auto a = token_bytes(src, Token(s));
+        const auto b = token_bytes(dst, Token(d));
+        if (a < b)      ++s;
+        else if (b < a) ++d;
+        else { remap[s] = uint32_t(d); in_source[d] = 1; ++s; ++d; }
+    }
+
+    for (size_t s = 0; s < ns; ++s) {
+        if (remap[s] & RETOKENIZE) continue;
+        const auto a = token_bytes(src, Token(s));
+        for (size_t d = remap[s] + 1; d < nd; ++d) {
+            if (!token_bytes(dst, Token(d)).starts_with(a)) break;
+            if (!in_source[d]) { remap[s] |= RETOKENIZE; break; }
+        }
+    }
+    return remap;
+}
+
+template<BitWidth Bits>
+void transcode(const OnPairColumnView& src, const uint32_t* remap,
+               const encoding::LongestPrefixMatcher* lpm,
+               encoding::BitWriter& writer, std::vector<uint32_t>& bounds)
+{
+    const auto sv = src.store();
+    const auto dv = src.dictionary();
+    const auto* sb = sv.boundaries();
+    std::vector<uint8_t>  tail;     // bytes from the first unstable token on
+    std::vector<Token>    toks;     // their source tokens
+    std::vector<uint32_t> starts;   // byte offset of each in tail
+
+    decoding::TokenCursor<Bits> cursor(sv.packed_data());
+    for (size_t i = 0; i < sv.num_strings(); ++i) {
+        if (src.is_deleted(i)) continue;
+        cursor.reset_to(StreamSpan{sb[i], sb[i + 1]});
+        while (cursor.has_more()) {
+            Token t = cursor.next();
+            if (!(remap[t] & RETOKENIZE)) {
+                writer.write(Token(remap[t]));
+                continue;
+            }
+
+            // Slow path for the rest of the row.  Wherever the target parse
+            // sits on a source token boundary at a stable token, it copies
+            // that token; elsewhere it matches with the target matcher.
+            tail.clear(); toks.clear(); starts.clear();
+            for (;;) {
+                toks.push_back(t);
+                starts.push_back(static_cast<uint32_t>(tail.size()));
+                tail.insert(tail.end(), dv.data(t), dv.data(t) + dv.token_size(t));
+                if (!cursor.has_more()) break;
+                t = cursor.next();
+            }
+            starts.push_back(static_cast<uint32_t>(tail.size()));
+
+            size_t k = 0;
+            for (size_t pos = 0; pos < tail.size(); ) {
+                if (pos == starts[k] && !(remap[toks[k]] & RETOKENIZE)) {
+                    writer.write(Token(remap[toks[k]]));
+                    pos = starts[++k];
+                    continue;
+                }
+                const auto m = lpm->find_longest_match(tail.data() + pos,
+                                                       tail.size() - pos);
+                writer.write(m.first);
+                pos += m.second;
+                while (starts[k] < pos) ++k;
+            }
+            break;
+        }
+        bounds.push_back(static_cast<uint32_t>(writer.tokens_written()));
+    }
+}
+
+} // namespace
+
+OnPairColumn OnPairColumn::merge(std::span<const OnPairColumnView> sources) {
+    if (sources.empty())
+        throw std::invalid_argument("OnPair: merge needs at least one source");
+
+    BitWidth bits = sources.front().bits();
+    for (const auto& src : sources) bits = std::max(bits, src.bits());
+
+    OnPairColumn col;
+    col.dict_ = std::make_shared<const Dictionary>(build_target(sources, bits));
+    const DictionaryView target(*col.dict_);
+
+    std::vector<std::vector<uint32_t>> remaps;
+    bool need_lpm = false;
+    for (const auto& src : sources) {
+        remaps.push_back(build_remap(src.dictionary(), target));
+        for (uint32_t r : remaps.back()) need_lpm |= (r & RETOKENIZE) != 0;
+    }
+    std::optional<encoding::LongestPrefixMatcher> lpm;
+    if (need_lpm) lpm = encoding::LongestPrefixMatcher::from_dictionary(target);
+
+    size_t rows = 0;
+    bool   nulls = false;
+    for (const auto& src : sources) {
+        rows  += src.num_strings() - src.deleted_count();
+        nulls |= src.has_nulls();
+    }
+
+    col.store_.bit_width = bits;
+    col.store_.boundaries.reserve(rows + 1);
+    col.store_.boundaries.push_back(0);
+    {
+        encoding::BitWriter writer(col.store_);
+        for (size_t k = 0; k < sources.size(); ++k) {
+            dispatch_bits(sources[k].bits(), [&](auto b) {
+                transcode<b.value>(sources[k], remaps[k].data(),
+                                   lpm ? &*lpm : nullptr, writer,
+                                   col.store_.boundaries);
+            });
+        }
+    }
+
+    if (nulls) {
+        col.validity_.assign(validity_words(rows), 0);
+        size_t r = 0;
+        for (const auto& src : sources) {
+            for (size_t i = 0; i < src.num_strings(); ++i) {
+                if (src.is_deleted(i)) continue;
+                if (src.is_valid(i)) col.validity_[r >> 6] |= uint64_t(1) << (r & 63);
+                ++r;
+            }
+        }
+        if (count_nulls(col.validity_.data(), rows) == 0) col.validity_.clear();
+    }
+    return col;
+}
+
+} // namespace onpair
@@ -0,0 +1,250 @@
+#include <onpair/column/column.h>
+#include <onpair/encoding/lpm.h>
+#include <onpair/encoding/training/trainer.h>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace onpair {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// compress_table — concurrent compression of many columns
+// ─────────────────────────────────────────────────────────────────────────────
+// Jobs sit in a list ordered by estimated working set.  Each worker takes
+// the largest job that fits the memory budget next to the jobs in flight,
+// runs it unlocked, and hands back its budget.  A group's training job,
+// once done, queues one parse job per column of the group.  The workers,
+// the caller among them, return once no job is queued or running.
+
+namespace {
+
+enum class JobKind : uint8_t { Compress, Train, Encode };
+
+struct Job {
+    size_t  bytes;    // estimated working set
+    size_t  index;    // column index, or group index for Train
+    JobKind kind;
+};
+
+struct Group {
+    std::vector<size_t> members;   // column indices, ascending
+    std::shared_ptr<const Dictionary>                     dict;
+    std::shared_ptr<const encoding::LongestPrefixMatcher> lpm;
+};
+
+// Shared between the caller and every worker.  Late executor tasks may find
+// it after compress_table() has returned; they see no pending job and leave.
+struct TableRun {
+    std::mutex              m;
+    std::condition_variable cv;
+    std::vector<Job>        queue;            // ascending by bytes
+    size_t                  pending   = 0;    // queued or running
+    size_t                  in_flight = 0;    // bytes of running jobs
+    size_t                  budget    = 0;    // 0 = unbounded
+    std::exception_ptr      error;
+
+    // Does the work and returns the jobs it unlocks.  It refers to the
+    // caller's frame, which outlives every job.
+    std::function<std::vector<Job>(const Job&)> body;
+
+    void push(Job job) {
+        queue.insert(std::upper_bound(queue.begin(), queue.end(), job,
+                                      [](const Job& a, const Job& b) {
+                                          return a.bytes < b.bytes;
+                                      }),
+                     job);
+        ++pending;
+    }
+
+    // Largest queued job that fits next to the jobs in flight, or end().
+    std::vector<Job>::iterator pick() {
+        if (queue.empty()) return queue.end();
+        if (budget == 0 || in_flight == 0) return queue.end() - 1;
+        for (auto it = queue.end(); it != queue.begin();) {
+            --it;
+            if (in_flight + it->bytes <= budget) return it;
+        }
+        return queue.end();
+    }
+};
+
+// Run jobs until none is queued or running.
+void work(TableRun& r) {
+    std::unique_lock lk(r.m);
+    for (;;) {
+        auto it = r.queue.end();
+        r.cv.wait(lk, [&] { return r.pending == 0 || (it = r.pick()) != r.queue.end(); });
+        if (r.pending == 0) return;
+
+        const Job job = *it;
+        r.queue.erase(it);
+        r.in_flight += job.bytes;
+        lk.unlock();
+
+        std::vector<Job> next;
+        std::exception_ptr error;
+        try {
+            next = r.body(job);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lk.lock();
+        r.in_flight -= job.bytes;
+        --r.pending;
+        if (error) {
+            if (!r.error) r.error = error;
+            r.pending -= r.queue.size();   // abandon what has not started
+            r.queue.clear();
+        } else if (!r.error) {
+            for (const Job& j : next) r.push(j);
+        }
+        r.cv.notify_all();
+    }
+}
+
+size_t input_bytes(const TableColumn& c) {
+    return c.n ? size_t(c.offsets[c.n] - c.offsets[0]) : 0;
+}
+
+// Training state: dictionary plus matcher, about 64 bytes per slot.
+size_t training_bytes(BitWidth bits) { return max_dict_size(bits) * 64; }
+
+size_t encode_bytes(const TableColumn& c) {
+    return 2 * input_bytes(c) + (c.n + 1) * sizeof(uint32_t);
+}
+
+} // namespace
+
+std::vector<OnPairColumn>
+OnPairColumn::compress_table(std::span<const TableColumn> columns,
+                             std::span<const Config> cfgs,
+                             const TableOptions& opts)
+{
+    return compress_table(columns, cfgs, TableExecutor{}, opts);
+}
+
+std::vector<OnPairColumn>
+OnPairColumn::compress_table(std::span<const TableColumn> columns,
+                             std::span<const Config> cfgs,
+                             const TableExecutor& executor,
+                             const TableOptions& opts)
+{
+    if (cfgs.size() != 1 && cfgs.size() != columns.size())
+        throw std::invalid_argument(
+            "OnPair: compress_table needs one Config per column, or one for all");
+    auto cfg_of = [&](size_t i) -> const Config& {
+        return cfgs.size() == 1 ? cfgs[0] : cfgs[i];
+    };
+
+    std::vector<OnPairColumn> out(columns.size());
+    auto run = std::make_shared<TableRun>();
+    run->budget = opts.memory_budget;
+
+    // ── Initial jobs ──────────────────────────────────────────────────────────
+    std::vector<Group>    groups;
+    std::map<int, size_t> group_of;   // shared_group -> index into groups
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const TableColumn& c = columns[i];
+        if (c.shared_group == TableColumn::NO_GROUP) {
+            run->push({encode_bytes(c) + training_bytes(cfg_of(i).bits), i,
+                       JobKind::Compress});
+            continue;
+        }
+        auto [it, fresh] = group_of.try_emplace(c.shared_group, groups.size());
+        if (fresh) groups.emplace_back();
+        groups[it->second].members.push_back(i);
+    }
+    for (size_t g = 0; g < groups.size(); ++g) {
+        size_t bytes = 0;
+        for (size_t i : groups[g].members) bytes += input_bytes(columns[i]);
+        run->push({bytes + training_bytes(cfg_of(groups[g].members[0]).bits), g,
+                   JobKind::Train});
+    }
+    if (run->pending == 0) return out;
+
+    // ── Job bodies ────────────────────────────────────────────────────────────
+    run->body = [&](const Job& job) -> std::vector<Job> {
+        if (job.kind == JobKind::Compress) {
+            const TableColumn& c = columns[job.index];
+            out[job.index] = compress_raw(reinterpret_cast<const uint8_t*>(c.data),
+                                          c.offsets, c.n, cfg_of(job.index),
+                                          c.validity);
+            return {};
+        }
+
+        if (job.kind == JobKind::Encode) {
+            const TableColumn& c = columns[job.index];
+            const Group&       g = groups[group_of.at(c.shared_group)];
+            const Config&   gcfg = cfg_of(g.members[0]);
+            out[job.index] = encode_nullable(g.dict, *g.lpm, gcfg.bits,
+                                             reinterpret_cast<const uint8_t*>(c.data),
+                                             c.offsets, c.n, c.validity,
+                                             gcfg.collect_statistics);
+            return {};
+        }
+
+        // Train: one dictionary over the valid rows of every group column.
+        Group& g = groups[job.index];
+        std::vector<uint8_t>  data;
+        std::vector<uint32_t> offsets{0};
+        for (size_t i : g.members) {
+            const TableColumn& c = columns[i];
+            const auto* bytes = reinterpret_cast<const uint8_t*>(c.data);
+            for (size_t r = 0; r < c.n; ++r) {
+                if (c.validity && !((c.validity[r >> 3] >> (r & 7)) & 1u)) continue;
+                data.insert(data.end(), bytes + c.offsets[r], bytes + c.offsets[r + 1]);
+                offsets.push_back(static_cast<uint32_t>(data.size()));
+            }
+        }
+        encoding::TrainResult trained = encoding::train(
+            data.data(), offsets.data(), offsets.size() - 1, cfg_of(g.members[0]));
+        g.dict = std::make_shared<const Dictionary>(std::move(trained.dict));
+        g.lpm  = std::make_shared<const encoding::LongestPrefixMatcher>(
+            std::move(trained.lpm));
+
+        std::vector<Job> next;
+        for (size_t i : g.members)
+            next.push_back({encode_bytes(columns[i]), i, JobKind::Encode});
+        return next;
+    };
+
+    // ── Workers ───────────────────────────────────────────────────────────────
+    unsigned threads = opts.threads ? opts.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, threads);
+    const size_t jobs = columns.size() + groups.size();
+    const size_t extra = std::min<size_t>(threads, jobs) - 1;
+
+    // Helpers keep the run alive.  The caller's frame is reached only through
+    // jobs, and every job has finished before the caller's work() returns.
+    const std::function<void()> helper = [run] { work(*run); };
+    std::vector<std::jthread> own;
+    if (executor) {
+        for (size_t k = 0; k < extra; ++k) {
+            try {
+                executor(helper);
+            } catch (...) {
+                break;   // the caller's worker will do the rest
+            }
+        }
+    } else {
+        own.reserve(extra);
+        for (size_t k = 0; k < extra; ++k) own.emplace_back(helper);
+    }
+    work(*run);
+    own.clear();   // join
+
+    std::lock_guard lk(run->m);
+    run->body = nullptr;
+    if (run->error) std::rethrow_exception(run->error);
+    return out;
+}
+
+} // namespace onpair
@@ -0,0 +1,311 @@
+#include <onpair/column/template_column.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace onpair {
+
+namespace {
+
+uint64_t pow10(size_t e) noexcept {
+    uint64_t p = 1;
+    while (e--) p *= 10;
+    return p;
+}
+
+// Value intervals per field for rows of `tpl` starting with `prefix`, or
+// false when no such row can exist.  Fields the prefix does not reach stay
+// unconstrained.
+template<typename Filter>
+bool prefix_filter(const encoding::Template& tpl, std::string_view p, Filter& filter) {
+    for (size_t f = 0;; ++f) {
+        const std::string& lit = tpl.literals[f];
+        if (p.size() <= lit.size()) return std::string_view(lit).starts_with(p);
+        if (!p.starts_with(lit) || f == tpl.fields()) return false;
+        p.remove_prefix(lit.size());
+
+        size_t m = 0;
+        while (m < p.size() && encoding::is_digit(p[m])) ++m;
+        const bool   ends = m == p.size();
+        const size_t w    = tpl.widths[f];
+        if (m == 0 || m > encoding::MAX_FIELD_DIGITS) return false;
+        const uint64_t v = encoding::parse_digits(p.substr(0, m));
+
+        if (w) {
+            // Exactly w digits: a shorter prefix fixes the leading ones.
+            if (m > w || (m < w && !ends)) return false;
+            if (m < w) {
+                const uint64_t scale = pow10(w - m);
+                filter[f] = {{v * scale, (v + 1) * scale - 1}};
+                return true;
+            }
+        } else {
+            // No leading zero: a prefix ending here leaves any number of
+            // digits to follow, one interval per total length.
+            if (m > 1 && p[0] == '0') return false;
+            if (ends && v != 0) {
+                for (size_t len = m; len <= encoding::MAX_FIELD_DIGITS; ++len) {
+                    const uint64_t scale = pow10(len - m);
+                    filter[f].emplace_back(v * scale, (v + 1) * scale - 1);
+                }
+                return true;
+            }
+        }
+        filter[f] = {{v, v}};
+        if (ends) return true;
+        p.remove_prefix(m);
+    }
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// compress
+// ─────────────────────────────────────────────────────────────────────────────
+
+TemplateColumn TemplateColumn::compress(const char* data, const uint32_t* offsets,
+                                        size_t n, const Config& cfg,
+                                        const encoding::TemplateConfig& tcfg)
+{
+    return compress_raw(reinterpret_cast<const uint8_t*>(data), offsets, n, cfg, tcfg);
+}
+
+TemplateColumn TemplateColumn::compress_raw(const uint8_t* data, const uint32_t* offsets,
+                                            size_t n, const Config& cfg,
+                                            const encoding::TemplateConfig& tcfg)
+{
+    TemplateColumn col;
+    col.n_         = n;
+    col.templates_ = encoding::mine_templates(data, offsets, n, tcfg);
+    const size_t T = col.templates_.size();
+    col.tag_bits_  = T ? std::bit_ceil(unsigned(std::bit_width(T))) : 0;
+
+    // ── Route rows ────────────────────────────────────────────────────────────
+    std::vector<std::vector<std::vector<uint64_t>>> values(T);
+    for (uint32_t t = 0; t < T; ++t) values[t].resize(col.templates_[t].fields());
+    std::vector<uint8_t>  fb_data;
+    std::vector<uint32_t> fb_offsets{0};
+
+    col.tags_.assign((n * col.tag_bits_ + 63) / 64, 0);
+    col.rank_.reserve((n + RANK_BLOCK - 1) / RANK_BLOCK * (T + 1));
+    std::vector<uint32_t> seen(T + 1, 0);
+    uint64_t v[encoding::MAX_TEMPLATE_FIELDS];
+    for (size_t i = 0; i < n; ++i) {
+        if (i % RANK_BLOCK == 0) col.rank_.insert(col.rank_.end(), seen.begin(), seen.end());
+        const std::string_view row(reinterpret_cast<const char*>(data) + offsets[i],
+                                   offsets[i + 1] - offsets[i]);
+        const uint32_t t = col.templates_.match(row, v);
+        uint32_t tag = 0;
+        if (t == NO_TEMPLATE) {
+            fb_data.insert(fb_data.end(), row.begin(), row.end());
+            fb_offsets.push_back(static_cast<uint32_t>(fb_data.size()));
+        } else {
+            tag = t + 1;
+            for (size_t f = 0; f < values[t].size(); ++f) values[t][f].push_back(v[f]);
+        }
+        ++seen[tag];
+        if (col.tag_bits_) {
+            const size_t bit = i * col.tag_bits_;
+            col.tags_[bit >> 6] |= uint64_t(tag) << (bit & 63);
+        }
+    }
+
+    // ── Pack fields ───────────────────────────────────────────────────────────
+    col.fields_.resize(T);
+    for (uint32_t t = 0; t < T; ++t) {
+        for (const auto& vals : values[t]) {
+            Field fd;
+            if (!vals.empty()) {
+                const auto [lo, hi] = std::minmax_element(vals.begin(), vals.end());
+                fd.base = *lo;
+                fd.bits = unsigned(std::bit_width(*hi - *lo));
+            }
+            if (fd.bits) {
+                fd.packed.assign((vals.size() * fd.bits + 63) / 64, 0);
+                for (size_t j = 0; j < vals.size(); ++j) {
+                    const uint64_t x   = vals[j] - fd.base;
+                    const size_t   bit = j * fd.bits, w = bit >> 6, s = bit & 63;
+                    fd.packed[w] |= x << s;
+                    if (s + fd.bits > 64) fd.packed[w + 1] |= x >> (64 - s);
+                }
+            }
+            col.fields_[t].push_back(std::move(fd));
+        }
+    }
+
+    const size_t fb_rows = fb_offsets.size() - 1;
+    col.fallback_bytes_  = fb_data.size();
+    if (fb_rows)
+        col.fallback_ = OnPairColumn::compress(reinterpret_cast<const char*>(fb_data.data()),
+                                               fb_offsets.data(), fb_rows, cfg);
+    return col;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Metadata and decompression
+// ─────────────────────────────────────────────────────────────────────────────
+
+size_t TemplateColumn::bytes_used() const noexcept {
+    size_t bytes = tags_.size() * sizeof(uint64_t) + rank_.size() * sizeof(uint32_t);
+    for (uint32_t t = 0; t < templates_.size(); ++t) {
+        for (const auto& lit : templates_[t].literals) bytes += lit.size();
+        bytes += templates_[t].fields();                        // widths
+        for (const Field& fd : fields_[t])
+            bytes += fd.packed.size() * sizeof(uint64_t) + sizeof(uint64_t) + 1;
+    }
+    return bytes + fallback_.bytes_used();
+}
+
+size_t TemplateColumn::rank(uint32_t t, size_t i) const noexcept {
+    const size_t block = i / RANK_BLOCK;
+    size_t r = rank_[block * (templates_.size() + 1) + t];
+    for (size_t j = block * RANK_BLOCK; j < i; ++j) r += tag(j) == t;
+    return r;
+}
+
+size_t TemplateColumn::decompress(size_t idx, char* buf) const noexcept {
+    const uint32_t t = tag(idx);
+    const size_t   r = rank(t, idx);
+    if (t == 0) return fallback_.view().decompress(r, buf);
+
+    uint64_t v[encoding::MAX_TEMPLATE_FIELDS];
+    const auto& fs = fields_[t - 1];
+    for (size_t f = 0; f < fs.size(); ++f) v[f] = fs[f].get(r);
+    return templates_.format(t - 1, v, buf);
+}
+
+size_t TemplateColumn::decompress_all(char* buf, uint32_t* out_offsets) const {
+    // The fallback decodes in one pass; its rows are then copied into place.
+    const size_t fb_rows = fallback_.num_strings();
+    std::vector<char>     fb_buf;
+    std::vector<uint32_t> fb_offs(fb_rows + 1, 0);
+    if (fb_rows) {
+        const OnPairColumnView fv = fallback_.view();
+        fb_buf.resize(fallback_bytes_ + DECOMPRESS_BUFFER_PADDING);
+        fv.decompress_all(fb_buf.data(), fb_offs.data());
+    }
+
+    std::vector<size_t> seen(templates_.size() + 1, 0);
+    uint64_t v[encoding::MAX_TEMPLATE_FIELDS];
+    size_t pos = 0;
+    for (size_t i = 0; i < n_; ++i) {
+        out_offsets[i] = static_cast<uint32_t>(pos);
+        const uint32_t t = tag(i);
+        const size_t   r = seen[t]++;
+        if (t == 0) {
+            const uint32_t len = fb_offs[r + 1] - fb_offs[r];
+            std::memcpy(buf + pos, fb_buf.data() + fb_offs[r], len);
+            pos += len;
+            continue;
+        }
+        const auto& fs = fields_[t - 1];
+        for (size_t f = 0; f < fs.size(); ++f) v[f] = fs[f].get(r);
+        pos += templates_.format(t - 1, v, buf + pos);
+    }
+    out_offsets[n_] = static_cast<uint32_t>(pos);
+    return pos;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Search
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool TemplateColumn::fields_match(uint32_t t, const Filter& filter,
+                                  size_t r) const noexcept {
+    const auto& fs = fields_[t];
+    for (size_t f = 0; f < fs.size(); ++f) {
+        if (filter[f].empty()) continue;
+        const uint64_t x = fs[f].get(r);
+        if (std::none_of(filter[f].begin(), filter[f].end(),
+                         [x](const auto& iv) { return iv.first <= x && x <= iv.second; }))
+            return false;
+    }
+    return true;
+}
+
+void TemplateColumn::scan_template(uint32_t t, const Filter& filter,
+                                   std::vector<size_t>& out) const {
+    size_t j = 0;
+    for (size_t i = 0; i < n_; ++i) {
+        if (tag(i) != t + 1) continue;
+        if (fields_match(t, filter, j)) out.push_back(i);
+        ++j;
+    }
+}
+
+// Map fallback row ids (ascending) to column row ids.
+void TemplateColumn::add_fallback(const std::vector<size_t>& hits,
+                                  std::vector<size_t>& out) const {
+    size_t k = 0, h = 0;
+    for (size_t i = 0; i < n_ && h < hits.size(); ++i) {
+        if (tag(i) != 0) continue;
+        if (k++ == hits[h]) {
+            out.push_back(i);
+            ++h;
+        }
+    }
+}
+
+std::vector<size_t> TemplateColumn::equals(std::string_view value) const {
+    std::vector<size_t> out;
+    uint64_t v[encoding::MAX_TEMPLATE_FIELDS];
+    const uint32_t t = templates_.match(value, v);
+    if (t == NO_TEMPLATE) {
+        // Rows matching a template are never in the fallback, and vice versa.
+        if (fallback_.num_strings()) add_fallback(fallback_.view().equals(value), out);
+        return out;
+    }
+    Filter filter;
+    for (size_t f = 0; f < templates_[t].fields(); ++f) filter[f] = {{v[f], v[f]}};
+    scan_template(t, filter, out);
+    return out;
+}
+
+// One pass over the tags: each row is tested against the filter of its own
+// template, or looked up in the fallback's hits, so the output is ascending.
+std::vector<size_t> TemplateColumn::starts_with(std::string_view prefix) const {
+    const size_t tags = templates_.size() + 1;
+    std::vector<Filter>  filters(templates_.size());
+    std::vector<uint8_t> live(tags, 0);   // by tag; 0 = no row can match
+    for (uint32_t t = 0; t < templates_.size(); ++t)
+        live[t + 1] = prefix_filter(templates_[t], prefix, filters[t]);
+
+    std::vector<size_t> fallback_hits;
+    if (fallback_.num_strings()) fallback_hits = fallback_.view().starts_with(prefix);
+    live[0] = !fallback_hits.empty();
+
+    std::vector<size_t> out;
+    if (std::find(live.begin(), live.end(), 1) == live.end()) return out;
+
+    std::vector<size_t> seen(tags, 0);    // rows of each tag before i
+    size_t h = 0;
+    for (size_t i = 0; i < n_; ++i) {
+        const uint32_t t = tag(i);
+        const size_t   r = seen[t]++;
+        if (!live[t]) continue;
+        if (t == 0) {
+            if (h < fallback_hits.size() && fallback_hits[h] == r) {
+                out.push_back(i);
+                ++h;
+            }
+        } else if (fields_match(t - 1, filters[t - 1], r)) {
+            out.push_back(i);
+        }
+    }
+    return out;
+}
+
+std::vector<size_t> TemplateColumn::field_between(uint32_t t, size_t field,
+                                                  uint64_t lo, uint64_t hi) const {
+    if (t >= templates_.size() || field >= templates_[t].fields())
+        throw std::out_of_range("OnPair: no such template field");
+    std::vector<size_t> out;
+    if (lo > hi) return out;
+    Filter filter;
+    filter[field] = {{lo, hi}};
+    scan_template(t, filter, out);
+    return out;
+}
+
+} // namespace onpair
@@ -0,0 +1,370 @@
+#include <onpair/core/cold_store.h>
+#include <algorithm>
+#include <array>
+#include <istream>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace onpair {
+
+namespace {
+
+constexpr unsigned LUT_BITS = 12;
+
+Token token_at(const Store& s, size_t i) noexcept {
+    const size_t bit = i * s.bit_width, w = bit >> 6, sh = bit & 63;
+    uint64_t v = s.packed[w] >> sh;
+    if (sh) v |= s.packed[w + 1] << (64 - sh);
+    return Token(v & ((uint64_t(1) << s.bit_width) - 1));
+}
+
+uint64_t load_be64(const uint8_t* p) noexcept {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = v << 8 | p[i];
+    return v;
+}
+
+// Huffman code lengths for `freq`.  A tree deeper than MAX_COLD_CODE_LENGTH
+// is rebuilt from halved frequencies, which flattens it; all-equal
+// frequencies give depth log2(2^16) at most.
+std::vector<uint8_t> code_lengths(std::vector<uint64_t> freq) {
+    std::vector<uint8_t> len(freq.size(), 0);
+    std::vector<uint32_t> used;
+    for (uint32_t t = 0; t < freq.size(); ++t)
+        if (freq[t]) used.push_back(t);
+    if (used.size() == 1) len[used[0]] = 1;
+    if (used.size() <= 1) return len;
+
+    for (;;) {
+        // Leaves are 0..m-1, internal nodes m.. in creation order.
+        const size_t m = used.size();
+        std::vector<uint32_t> parent(2 * m - 1, 0);
+        using Node = std::pair<uint64_t, uint32_t>;
+        std::priority_queue<Node, std::vector<Node>, std::greater<>> heap;
+        for (uint32_t k = 0; k < m; ++k) heap.emplace(freq[used[k]], k);
+        for (uint32_t next = uint32_t(m); heap.size() > 1; ++next) {
+            const Node a = heap.top(); heap.pop();
+            const Node b = heap.top(); heap.pop();
+            parent[a.second] = parent[b.second] = next;
+            heap.emplace(a.first + b.first, next);
+        }
+        std::vector<uint8_t> depth(2 * m - 1, 0);
+        for (size_t k = 2 * m - 2; k-- > 0;) depth[k] = uint8_t(depth[parent[k]] + 1);
+
+        const uint8_t deepest = *std::max_element(depth.begin(), depth.begin() + m);
+        if (deepest <= MAX_COLD_CODE_LENGTH) {
+            for (size_t k = 0; k < m; ++k) len[used[k]] = depth[k];
+            return len;
+        }
+        for (uint32_t t : used) freq[t] = (freq[t] + 1) / 2;
+    }
+}
+
+// Canonical codes: shorter first, then by token id.
+std::vector<uint32_t> canonical_codes(const std::vector<uint8_t>& len,
+                                      std::array<uint32_t, MAX_COLD_CODE_LENGTH + 1>& first) {
+    std::array<uint32_t, MAX_COLD_CODE_LENGTH + 1> count{};
+    for (uint8_t l : len) ++count[l];
+    count[0] = 0;
+    uint32_t code = 0;
+    for (size_t l = 1; l <= MAX_COLD_CODE_LENGTH; ++l) {
+        code     = (code + count[l - 1]) << 1;
+        first[l] = code;
+    }
+    std::array<uint32_t, MAX_COLD_CODE_LENGTH + 1> next = first;
+    std::vector<uint32_t> codes(len.size(), 0);
+    for (size_t t = 0; t < len.size(); ++t)
+        if (len[t]) codes[t] = next[len[t]]++;
+    return codes;
+}
+
+struct Decoder {
+    struct Entry { Token token; uint8_t len; };
+
+    std::vector<Entry> lut = std::vector<Entry>(size_t(1) << LUT_BITS, Entry{0, 0});
+    std::array<uint32_t, MAX_COLD_CODE_LENGTH + 1> first{}, count{}, index{};
+    std::vector<Token> sorted;   // by (length, id)
+
+    explicit Decoder(const std::vector<uint8_t>& len) {
+        const std::vector<uint32_t> codes = canonical_codes(len, first);
+        for (uint8_t l : len) if (l) ++count[l];
+        for (size_t l = 1, at = 0; l <= MAX_COLD_CODE_LENGTH; at += count[l++]) index[l] = uint32_t(at);
+        sorted.resize(index[MAX_COLD_CODE_LENGTH] + count[MAX_COLD_CODE_LENGTH]);
+        std::array<uint32_t, MAX_COLD_CODE_LENGTH + 1> fill = index;
+        for (size_t t = 0; t < len.size(); ++t) {
+            if (!len[t]) continue;
+            sorted[fill[len[t]]++] = Token(t);
+            if (len[t] <= LUT_BITS) {
+                const uint32_t lo = codes[t] << (LUT_BITS - len[t]);
+                std::fill_n(lut.begin() + lo, size_t(1) << (LUT_BITS - len[t]),
+                            Entry{Token(t), len[t]});
+            }
+        }
+    }
+
+    // `top` holds the next MAX_COLD_CODE_LENGTH bits of the stream.
+    Entry slow(uint32_t top) const noexcept {
+        for (size_t l = LUT_BITS + 1; l <= MAX_COLD_CODE_LENGTH; ++l) {
+            const uint32_t off = (top >> (MAX_COLD_CODE_LENGTH - l)) - first[l];
+            if (off < count[l]) return {sorted[index[l] + off], uint8_t(l)};
+        }
+        return {0, uint8_t(MAX_COLD_CODE_LENGTH)};   // corrupt stream
+    }
+};
+
+// Decode `n` tokens from `p` and pack them at `bits` from out[0] bit 0.
+// Loads stay below end + 8; only a corrupt stream ever reaches `end`.
+void decode_block(const Decoder& d, const uint8_t* p, const uint8_t* end, size_t n,
+                  unsigned bits, uint64_t* out) noexcept {
+    static_assert(2 * MAX_COLD_CODE_LENGTH <= 56, "two codes per refill");
+    uint64_t buf = 0, acc = 0;
+    unsigned have = 0, fill = 0;
+
+    // Branchless refill to 56..63 buffered bits (MSB-first).
+    const auto refill = [&] {
+        buf  |= load_be64(p) >> have;
+        p     = std::min(p + ((63 - have) >> 3), end);
+        have |= 56;
+    };
+    const auto next = [&] {
+        Decoder::Entry e = d.lut[buf >> (64 - LUT_BITS)];
+        if (!e.len) e = d.slow(uint32_t(buf >> (64 - MAX_COLD_CODE_LENGTH)));
+        buf  <<= e.len;
+        have  -= e.len;
+
+        acc  |= uint64_t(e.token) << fill;
+        fill += bits;
+        if (fill >= 64) {
+            *out++ = acc;
+            fill  -= 64;
+            acc    = fill ? uint64_t(e.token) >> (bits - fill) : 0;
+        }
+    };
+
+    size_t k = 0;
+    for (; k + 2 <= n; k += 2) {
+        refill();
+        next();
+        next();
+    }
+    if (k < n) {
+        refill();
+        next();
+    }
+    if (fill) *out = acc;
+}
+
+template<typename T>
+void put(std::ostream& out, const T& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template<typename T>
+T get(std::istream& in) {
+    T v{};
+    in.read(reinterpret_cast<char*>(&v), sizeof(T));
+    if (!in) throw std::runtime_error("OnPair: truncated file");
+    return v;
+}
+
+template<typename T>
+void put_vec(std::ostream& out, const T* data, size_t n) {
+    put(out, static_cast<uint64_t>(n));
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(n * sizeof(T)));
+}
+
+template<typename T>
+std::vector<T> get_vec(std::istream& in, size_t limit) {
+    const uint64_t n = get<uint64_t>(in);
+    if (n > limit) throw std::runtime_error("OnPair: corrupt cold store");
+    std::vector<T> v(n);
+    in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(n * sizeof(T)));
+    if (!in) throw std::runtime_error("OnPair: truncated file");
+    return v;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// encode
+// ─────────────────────────────────────────────────────────────────────────────
+
+ColdStore ColdStore::encode(const Store& store, std::span<const uint32_t> frequency) {
+    ColdStore c;
+    c.bits_   = store.bit_width;
+    c.rows_   = store.num_strings();
+    c.tokens_ = store.num_tokens();
+    for (size_t i = 0; i < c.rows_; ++i) {
+        for (uint32_t v = store.boundaries[i + 1] - store.boundaries[i];; v >>= 7) {
+            c.row_lengths_.push_back(uint8_t(v & 127) | (v > 127 ? 128 : 0));
+            if (v <= 127) break;
+        }
+    }
+    if (c.tokens_ == 0) return c;
+
+    const size_t alphabet = max_dict_size(c.bits_);
+    std::vector<uint64_t> freq(alphabet, 0);
+    if (frequency.empty()) {
+        for (size_t i = 0; i < c.tokens_; ++i) ++freq[token_at(store, i)];
+    } else {
+        std::copy_n(frequency.begin(), std::min(frequency.size(), alphabet), freq.begin());
+    }
+
+    for (;;) {
+        c.lengths_ = code_lengths(freq);
+        std::array<uint32_t, MAX_COLD_CODE_LENGTH + 1> first{};
+        const std::vector<uint32_t> codes = canonical_codes(c.lengths_, first);
+
+        c.blocks_.clear();
+        c.payload_.clear();
+        bool missed = false;
+        uint64_t acc = 0;
+        unsigned have = 0;
+        for (size_t i = 0; i < c.tokens_ && !missed; ++i) {
+            if (i % COLD_BLOCK_TOKENS == 0) {
+                if (have) c.payload_.push_back(uint8_t(acc << (8 - have)));
+                have = 0;
+                c.blocks_.push_back(c.payload_.size());
+            }
+            const Token   t = token_at(store, i);
+            const uint8_t l = c.lengths_[t];
+            missed = l == 0;
+            acc   = acc << l | codes[t];
+            have += l;
+            for (; have >= 8; have -= 8) c.payload_.push_back(uint8_t(acc >> (have - 8)));
+        }
+        if (!missed) {
+            if (have) c.payload_.push_back(uint8_t(acc << (8 - have)));
+            break;
+        }
+        // The histogram missed a token that occurs: count them instead.
+        std::fill(freq.begin(), freq.end(), 0);
+        for (size_t i = 0; i < c.tokens_; ++i) ++freq[token_at(store, i)];
+    }
+
+    while (!c.lengths_.empty() && c.lengths_.back() == 0) c.lengths_.pop_back();
+    c.payload_.resize(c.payload_.size() + PAYLOAD_PADDING, 0);
+    return c;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// decode
+// ─────────────────────────────────────────────────────────────────────────────
+
+Store ColdStore::decode(unsigned threads) const {
+    Store s{bits_, {}, {}};
+    s.boundaries.reserve(rows_ + 1);
+    s.boundaries.push_back(0);
+    uint32_t total = 0;
+    for (size_t k = 0; k < row_lengths_.size();) {
+        uint32_t v = 0;
+        for (unsigned sh = 0;; sh += 7) {
+            const uint8_t b = row_lengths_[k++];
+            v |= uint32_t(b & 127) << sh;
+            if (!(b & 128)) break;
+        }
+        s.boundaries.push_back(total += v);
+    }
+    if (tokens_ == 0) return s;
+
+    s.packed.assign((tokens_ * bits_ + 63) / 64 + 1, 0);   // + sentinel word
+    const Decoder d(lengths_);
+    const auto run = [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            const size_t begin = b * COLD_BLOCK_TOKENS;
+            decode_block(d, payload_.data() + blocks_[b],
+                         payload_.data() + payload_.size() - PAYLOAD_PADDING,
+                         std::min(COLD_BLOCK_TOKENS, tokens_ - begin), bits_,
+                         s.packed.data() + begin * bits_ / 64);
+        }
+    };
+
+    const size_t nb = blocks_.size();
+    size_t t = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    t = std::min(t, nb);
+    if (t <= 1) {
+        run(0, nb);
+        return s;
+    }
+    // jthread: if a later thread fails to start, unwinding joins the
+    // ones already running instead of terminating.
+    std::vector<std::jthread> workers;
+    workers.reserve(t - 1);
+    for (size_t k = 1; k < t; ++k)
+        workers.emplace_back(run, k * nb / t, (k + 1) * nb / t);
+    run(0, nb / t);
+    for (auto& w : workers) w.join();
+    return s;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Serialisation
+// ─────────────────────────────────────────────────────────────────────────────
+//   bit_width u8 | rows u64 | tokens u64 | block tokens u32
+//   code lengths, row lengths, block offsets, payload: u64 count + data
+
+void ColdStore::write_to(std::ostream& out) const {
+    put(out, bits_);
+    put(out, static_cast<uint64_t>(rows_));
+    put(out, static_cast<uint64_t>(tokens_));
+    put(out, static_cast<uint32_t>(COLD_BLOCK_TOKENS));
+    put_vec(out, lengths_.data(), lengths_.size());
+    put_vec(out, row_lengths_.data(), row_lengths_.size());
+    put_vec(out, blocks_.data(), blocks_.size());
+    put_vec(out, payload_.data(), payload_.empty() ? 0 : payload_.size() - PAYLOAD_PADDING);
+}
+
+ColdStore ColdStore::read_from(std::istream& in) {
+    const auto corrupt = [] { return std::runtime_error("OnPair: corrupt cold store"); };
+    ColdStore c;
+    c.bits_   = get<BitWidth>(in);
+    c.rows_   = get<uint64_t>(in);
+    c.tokens_ = get<uint64_t>(in);
+    if (!is_valid_bits(c.bits_) || c.rows_ >= UINT32_MAX || c.tokens_ > UINT32_MAX ||
+        get<uint32_t>(in) != COLD_BLOCK_TOKENS)
+        throw corrupt();
+    c.lengths_     = get_vec<uint8_t>(in, max_dict_size(c.bits_));
+    c.row_lengths_ = get_vec<uint8_t>(in, c.rows_ * 5);
+    c.blocks_      = get_vec<uint64_t>(in, (c.tokens_ + COLD_BLOCK_TOKENS - 1) / COLD_BLOCK_TOKENS);
+    c.payload_     = get_vec<uint8_t>(in, c.tokens_ * MAX_COLD_CODE_LENGTH / 8 + c.blocks_.size());
+
+    // Everything decode() relies on: row lengths that sum to the tokens, a
+    // block per COLD_BLOCK_TOKENS tokens inside the payload, and code
+    // lengths that form a prefix code (Kraft sum at most 1).
+    size_t rows = 0, k = 0;
+    uint64_t total = 0;
+    while (k < c.row_lengths_.size()) {
+        uint64_t v = 0;
+        for (unsigned sh = 0;; sh += 7) {
+            if (k == c.row_lengths_.size() || sh > 28) throw corrupt();
+            const uint8_t b = c.row_lengths_[k++];
+            v |= uint64_t(b & 127) << sh;
+            if (!(b & 128)) break;
+        }
+        total += v;
+        ++rows;
+    }
+    if (rows != c.rows_ || total != c.tokens_) throw corrupt();
+
+    if (c.blocks_.size() != (c.tokens_ + COLD_BLOCK_TOKENS - 1) / COLD_BLOCK_TOKENS)
+        throw corrupt();
+    for (size_t b = 0; b < c.blocks_.size(); ++b)
+        if (c.blocks_[b] > c.payload_.size() || (b && c.blocks_[b] < c.blocks_[b - 1]))
+            throw corrupt();
+
+    uint64_t kraft = 0;
+    for (uint8_t l : c.lengths_) {
+        if (l > MAX_COLD_CODE_LENGTH) throw corrupt();
+        if (l) kraft += uint64_t(1) << (MAX_COLD_CODE_LENGTH - l);
+    }
+    if (kraft > (uint64_t(1) << MAX_COLD_CODE_LENGTH) || (c.tokens_ && kraft == 0))
+        throw corrupt();
+
+    if (c.tokens_) c.payload_.resize(c.payload_.size() + PAYLOAD_PADDING, 0);
+    return c;
+}
+
+} // namespace onpair
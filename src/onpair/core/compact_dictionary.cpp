@@ -0,0 +1,99 @@
+#include <onpair/core/compact_dictionary.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace onpair {
+
+CompactDictionary CompactDictionary::encode(const Dictionary& dict) {
+    CompactDictionary c;
+    c.n_ = dict.num_tokens();
+    c.blocks_.reserve((c.n_ + COMPACT_DICT_BLOCK - 1) / COMPACT_DICT_BLOCK);
+
+    const uint8_t* prev     = nullptr;
+    size_t         prev_len = 0;
+    for (size_t i = 0; i < c.n_; ++i) {
+        const uint8_t* tok = dict.bytes.data() + dict.offsets[i];
+        const size_t   len = dict.offsets[i + 1] - dict.offsets[i];
+        if (len == 0 || len > MAX_TOKEN_SIZE)
+            throw std::invalid_argument("OnPair: token length out of range");
+
+        size_t shared = 0;
+        if (i % COMPACT_DICT_BLOCK == 0) {
+            c.blocks_.push_back(static_cast<uint32_t>(c.bytes_.size()));
+        } else {
+            const size_t limit = std::min(prev_len, len - 1);
+            while (shared < limit && prev[shared] == tok[shared]) ++shared;
+        }
+        c.bytes_.push_back(static_cast<uint8_t>(shared << 4 | (len - shared - 1)));
+        c.bytes_.insert(c.bytes_.end(), tok + shared, tok + len);
+        prev     = tok;
+        prev_len = len;
+    }
+    return c;
+}
+
+CompactDictionary CompactDictionary::from_bytes(size_t num_tokens, std::vector<uint8_t> bytes) {
+    CompactDictionary c;
+    c.n_     = num_tokens;
+    c.bytes_ = std::move(bytes);
+    c.blocks_.reserve((num_tokens + COMPACT_DICT_BLOCK - 1) / COMPACT_DICT_BLOCK);
+
+    size_t pos = 0, prev_len = 0;
+    for (size_t i = 0; i < num_tokens; ++i) {
+        if (i % COMPACT_DICT_BLOCK == 0) c.blocks_.push_back(static_cast<uint32_t>(pos));
+        if (pos >= c.bytes_.size())
+            throw std::runtime_error("OnPair: corrupt compact dictionary");
+        const size_t shared = c.bytes_[pos] >> 4;
+        const size_t suffix = (c.bytes_[pos] & 15) + 1;
+        if ((i % COMPACT_DICT_BLOCK == 0 && shared) || shared > prev_len ||
+            shared + suffix > MAX_TOKEN_SIZE || c.bytes_.size() - pos - 1 < suffix)
+            throw std::runtime_error("OnPair: corrupt compact dictionary");
+        pos     += 1 + suffix;
+        prev_len = shared + suffix;
+    }
+    if (pos != c.bytes_.size())
+        throw std::runtime_error("OnPair: corrupt compact dictionary");
+    return c;
+}
+
+size_t CompactDictionary::token(Token id, uint8_t* out) const noexcept {
+    const uint8_t* p   = bytes_.data() + blocks_[id / COMPACT_DICT_BLOCK];
+    size_t         len = 0;
+    for (size_t k = 0; k <= id % COMPACT_DICT_BLOCK; ++k) {
+        const size_t shared = *p >> 4, suffix = (*p & 15) + 1;
+        std::memcpy(out + shared, p + 1, suffix);
+        p  += 1 + suffix;
+        len = shared + suffix;
+    }
+    return len;
+}
+
+Dictionary CompactDictionary::expand() const {
+    // Sizes first, so the bytes are written in place: each token copies its
+    // shared prefix from the one before it in the output.
+    Dictionary d;
+    if (n_ == 0) return d;
+    d.offsets.resize(n_ + 1);
+    d.offsets[0] = 0;
+    const uint8_t* p = bytes_.data();
+    for (size_t i = 0; i < n_; ++i) {
+        const size_t shared = *p >> 4, suffix = (*p & 15) + 1;
+        d.offsets[i + 1] = d.offsets[i] + static_cast<uint32_t>(shared + suffix);
+        p += 1 + suffix;
+    }
+
+    d.bytes.resize(d.offsets[n_]);
+    p = bytes_.data();
+    for (size_t i = 0; i < n_; ++i) {
+        const size_t shared = *p >> 4, suffix = (*p & 15) + 1;
+        uint8_t* out = d.bytes.data() + d.offsets[i];
+        if (shared) std::memcpy(out, d.bytes.data() + d.offsets[i - 1], shared);
+        std::memcpy(out + shared, p + 1, suffix);
+        p += 1 + suffix;
+    }
+    d.pad_for_decoder();
+    return d;
+}
+
+} // namespace onpair
@@ -1,38 +1,142 @@
 #include <onpair/encoding/parsing/parser.h>
 #include <onpair/encoding/parsing/bit_writer.h>
+#include <onpair/analytics/token_hasher.h>
+#include <algorithm>
+#include <cstring>
 
 namespace onpair::encoding {
 
-void parse(const uint8_t*              data,
-           const uint32_t*             offsets,
-           size_t                      n,
-           const LongestPrefixMatcher& lpm,
-           BitWidth                    bits,
-           Store&                store)
+namespace {
+
+// Byte-wise three-way comparison (unsigned, shorter-is-smaller).
+int compare_bytes(const uint8_t* a, size_t alen,
+                  const uint8_t* b, size_t blen) noexcept
 {
-    store.bit_width = bits;
-    store.packed.clear();
-    store.boundaries.clear();
-    store.boundaries.reserve(n + 1);
-    store.boundaries.push_back(0);
+    const int c = std::memcmp(a, b, std::min(alen, blen));
+    if (c != 0) return c;
+    return alen < blen ? -1 : (alen > blen ? 1 : 0);
+}
+
+// The parse loop, with statistics collection compiled in or out.  With a
+// RunControl the rows go in blocks with a stop check before each.  Returns
+// the number of rows parsed.
+template<bool Collect>
+size_t parse_impl(const uint8_t*              data,
+                  const uint32_t*             offsets,
+                  size_t                      n,
+                  const LongestPrefixMatcher& lpm,
+                  Store&                      store,
+                  ColumnStatistics*           stats,
+                  const RunControl*           ctl = nullptr)
+{
+    BitWriter writer(store, store.num_tokens());
+
+    [[maybe_unused]] const uint8_t* min_str = nullptr;
+    [[maybe_unused]] const uint8_t* max_str = nullptr;
+    [[maybe_unused]] size_t         min_len = 0, max_len = 0;
+    [[maybe_unused]] Token          head[STATS_PREFIX_TOKENS];
 
-    BitWriter writer(store);
+    if constexpr (Collect) {
+        *stats = ColumnStatistics{};
+        stats->num_strings = n;
+        stats->token_count_histogram.assign(STATS_HISTOGRAM_BUCKETS, 0);
+        stats->token_frequency.assign(max_dict_size(store.bit_width), 0);
+    }
 
-    for (size_t i = 0; i < n; ++i) {
+    auto parse_row = [&](size_t i) {
         const uint8_t* str = data + offsets[i];
         const size_t   len = offsets[i + 1] - offsets[i];
         size_t pos = 0;
 
+        [[maybe_unused]] analytics::TokenHasher hasher;
+        [[maybe_unused]] size_t ntok = 0;
+
         while (pos < len) {
             auto m = lpm.find_longest_match(str + pos, len - pos);
             writer.write(m.first);
             pos += m.second;
+
+            if constexpr (Collect) {
+                if (ntok < STATS_PREFIX_TOKENS) head[ntok] = m.first;
+                ++ntok;
+                ++stats->token_frequency[m.first];
+                hasher.add(m.first);
+            }
         }
 
         store.boundaries.push_back(static_cast<uint32_t>(writer.tokens_written()));
+
+        if constexpr (Collect) {
+            auto& s = *stats;
+            s.total_bytes += len;
+            s.empty_count += (len == 0);
+            ++s.token_count_histogram[std::min(ntok, STATS_HISTOGRAM_BUCKETS - 1)];
+            s.distinct.add(hasher.finish());
+
+            const size_t kept = std::min(ntok, STATS_PREFIX_TOKENS);
+            if (i == 0 || compare_bytes(str, len, min_str, min_len) < 0) {
+                min_str = str; min_len = len;
+                s.min_prefix.assign(head, head + kept);
+                s.min_exact = ntok <= STATS_PREFIX_TOKENS;
+            }
+            if (i == 0 || compare_bytes(str, len, max_str, max_len) > 0) {
+                max_str = str; max_len = len;
+                s.max_prefix.assign(head, head + kept);
+                s.max_exact = ntok <= STATS_PREFIX_TOKENS;
+            }
+            if (i == 0 || len < s.min_length) s.min_length = static_cast<uint32_t>(len);
+            if (len > s.max_length)           s.max_length = static_cast<uint32_t>(len);
+        }
+    };
+
+    size_t done = 0;
+    if (!ctl) {
+        for (; done < n; ++done) parse_row(done);
+    } else {
+        const size_t block = ctl->block();
+        while (done < n && !ctl->stop_requested()) {
+            const size_t end = std::min(n, done + block);
+            for (; done < end; ++done) parse_row(done);
+            ctl->report(done, n);
+        }
+        if constexpr (Collect) stats->num_strings = done;
     }
 
     writer.flush();
+    return done;
+}
+
+} // namespace
+
+size_t parse(const uint8_t*              data,
+             const uint32_t*             offsets,
+             size_t                      n,
+             const LongestPrefixMatcher& lpm,
+             BitWidth                    bits,
+             Store&                      store,
+             ColumnStatistics*           stats,
+             const RunControl*           ctl)
+{
+    store.bit_width = bits;
+    store.packed.clear();
+    store.boundaries.clear();
+    store.boundaries.reserve(n + 1);
+    store.boundaries.push_back(0);
+
+    if (stats) return parse_impl<true >(data, offsets, n, lpm, store, stats, ctl);
+    else       return parse_impl<false>(data, offsets, n, lpm, store, nullptr, ctl);
+}
+
+void parse_append(const uint8_t*              data,
+                  const uint32_t*             offsets,
+                  size_t                      n,
+                  const LongestPrefixMatcher& lpm,
+                  Store&                      store)
+{
+    // No reserve(): exact-size reserves on every small batch would defeat
+    // the vectors' geometric growth.
+    if (store.boundaries.empty()) store.boundaries.push_back(0);
+    parse_impl<false>(data, offsets, n, lpm, store, nullptr);
 }
 
 } // namespace onpair::encoding
@@ -0,0 +1,221 @@
+#include <onpair/encoding/training/templates.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace onpair::encoding {
+
+namespace {
+
+constexpr char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Exactly w digits of v, zero padded; two digits per division.
+void write_fixed(uint64_t v, size_t w, char* p) noexcept {
+    for (; w >= 2; w -= 2, v /= 100) std::memcpy(p + w - 2, DIGIT_PAIRS + 2 * (v % 100), 2);
+    if (w) p[0] = char('0' + v % 10);
+}
+
+// A row cut into literals and digit runs.  The key is the literals joined
+// by '0', which no literal can contain, so equal keys mean equal literals.
+struct Shape {
+    std::array<std::string_view, MAX_TEMPLATE_FIELDS + 1> literals;
+    std::array<std::string_view, MAX_TEMPLATE_FIELDS>     runs;
+    size_t fields = 0;
+};
+
+// False when the row has no digit run, more than MAX_TEMPLATE_FIELDS, or a
+// run longer than MAX_FIELD_DIGITS: such rows fit no template.
+bool split(std::string_view row, Shape& s) noexcept {
+    s.fields = 0;
+    size_t lit = 0, i = 0;
+    while (i < row.size()) {
+        if (!is_digit(row[i])) {
+            ++i;
+            continue;
+        }
+        size_t j = i;
+        while (j < row.size() && is_digit(row[j])) ++j;
+        if (s.fields == MAX_TEMPLATE_FIELDS || j - i > MAX_FIELD_DIGITS) return false;
+        s.literals[s.fields] = row.substr(lit, i - lit);
+        s.runs[s.fields++]   = row.substr(i, j - i);
+        lit = i = j;
+    }
+    s.literals[s.fields] = row.substr(lit);
+    return s.fields > 0;
+}
+
+void append_key(const Shape& s, std::string& key) {
+    key.clear();
+    for (size_t f = 0; f <= s.fields; ++f) {
+        if (f) key.push_back('0');
+        key.append(s.literals[f]);
+    }
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Template / TemplateSet
+// ─────────────────────────────────────────────────────────────────────────────
+
+std::string Template::pattern() const {
+    std::string out = literals[0];
+    for (size_t f = 0; f < fields(); ++f) {
+        out += '{';
+        if (widths[f]) out += std::to_string(widths[f]);
+        out += '}';
+        out += literals[f + 1];
+    }
+    return out;
+}
+
+TemplateSet::TemplateSet(std::vector<Template> templates)
+    : templates_(std::move(templates))
+{
+    std::string key;
+    for (uint32_t t = 0; t < templates_.size(); ++t) {
+        key.clear();
+        for (size_t f = 0; f < templates_[t].literals.size(); ++f) {
+            if (f) key.push_back('0');
+            key.append(templates_[t].literals[f]);
+        }
+        index_.emplace(key, t);
+
+        const Template& tpl = templates_[t];
+        Layout& lay = layouts_.emplace_back();
+        if (std::find(tpl.widths.begin(), tpl.widths.end(), 0) != tpl.widths.end()) continue;
+        for (size_t f = 0; f < tpl.fields(); ++f) {
+            lay.prototype += tpl.literals[f];
+            lay.starts.push_back(lay.prototype.size());
+            lay.prototype.append(tpl.widths[f], '0');
+        }
+        lay.prototype += tpl.literals.back();
+    }
+}
+
+uint32_t TemplateSet::match(std::string_view row, uint64_t* values) const {
+    if (templates_.empty()) return NO_MATCH;
+    Shape s;
+    if (!split(row, s)) return NO_MATCH;
+    std::string key;
+    append_key(s, key);
+    const auto it = index_.find(key);
+    if (it == index_.end()) return NO_MATCH;
+
+    const Template& tpl = templates_[it->second];
+    for (size_t f = 0; f < s.fields; ++f) {
+        const std::string_view run = s.runs[f];
+        if (tpl.widths[f] ? run.size() != tpl.widths[f]
+                          : run.size() > 1 && run[0] == '0')
+            return NO_MATCH;
+        values[f] = parse_digits(run);
+    }
+    return it->second;
+}
+
+size_t TemplateSet::format(uint32_t t, const uint64_t* values, char* out) const noexcept {
+    const Template& tpl = templates_[t];
+    const Layout&   lay = layouts_[t];
+    if (!lay.prototype.empty()) {
+        std::memcpy(out, lay.prototype.data(), lay.prototype.size());
+        for (size_t f = 0; f < lay.starts.size(); ++f)
+            write_fixed(values[f], tpl.widths[f], out + lay.starts[f]);
+        return lay.prototype.size();
+    }
+
+    char* p = out;
+    for (size_t f = 0;; ++f) {
+        const std::string& lit = tpl.literals[f];
+        std::memcpy(p, lit.data(), lit.size());
+        p += lit.size();
+        if (f == tpl.fields()) break;
+
+        if (const size_t w = tpl.widths[f]) {
+            write_fixed(values[f], w, p);
+            p += w;
+        } else {
+            p = std::to_chars(p, p + MAX_FIELD_DIGITS + 1, values[f]).ptr;
+        }
+    }
+    return size_t(p - out);
+}
+
+size_t TemplateSet::max_length(uint32_t t) const noexcept {
+    const Template& tpl = templates_[t];
+    size_t len = 0;
+    for (const auto& lit : tpl.literals) len += lit.size();
+    for (uint8_t w : tpl.widths) len += w ? w : MAX_FIELD_DIGITS + 1;
+    return len;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// mine_templates
+// ─────────────────────────────────────────────────────────────────────────────
+
+TemplateSet mine_templates(const uint8_t*        data,
+                           const uint32_t*       offsets,
+                           size_t                n,
+                           const TemplateConfig& cfg)
+{
+    struct Candidate {
+        Template tpl;
+        size_t   rows = 0;
+        std::array<std::array<size_t, MAX_FIELD_DIGITS + 1>, MAX_TEMPLATE_FIELDS> widths{};
+        std::array<bool, MAX_TEMPLATE_FIELDS> leading_zero{};
+    };
+    std::unordered_map<std::string, Candidate> shapes;
+
+    const size_t sampled = std::min(n, cfg.sample_rows);
+    Shape       s;
+    std::string key;
+    for (size_t k = 0; k < sampled; ++k) {
+        const size_t i = sampled == n ? k : k * n / sampled;
+        const std::string_view row(reinterpret_cast<const char*>(data) + offsets[i],
+                                   offsets[i + 1] - offsets[i]);
+        if (!split(row, s)) continue;
+        append_key(s, key);
+        auto [it, fresh] = shapes.try_emplace(key);
+        Candidate& c = it->second;
+        if (fresh)
+            for (size_t f = 0; f <= s.fields; ++f) c.tpl.literals.emplace_back(s.literals[f]);
+        ++c.rows;
+        for (size_t f = 0; f < s.fields; ++f) {
+            ++c.widths[f][s.runs[f].size()];
+            c.leading_zero[f] |= s.runs[f].size() > 1 && s.runs[f][0] == '0';
+        }
+    }
+
+    const size_t min_rows = std::max<size_t>(
+        2, size_t(std::ceil(cfg.min_fraction * double(sampled))));
+    std::vector<std::pair<const std::string*, Candidate*>> kept;
+    for (auto& [k, c] : shapes)
+        if (c.rows >= min_rows) kept.emplace_back(&k, &c);
+    std::sort(kept.begin(), kept.end(), [](const auto& a, const auto& b) {
+        return a.second->rows != b.second->rows ? a.second->rows > b.second->rows
+                                                : *a.first < *b.first;
+    });
+    kept.resize(std::min(kept.size(), std::min<size_t>(cfg.max_templates, 255)));
+
+    std::vector<Template> out;
+    for (auto& [k, c] : kept) {
+        Template tpl = std::move(c->tpl);
+        for (size_t f = 0; f + 1 < tpl.literals.size(); ++f) {
+            const auto& counts = c->widths[f];
+            const size_t distinct = size_t(std::count_if(counts.begin(), counts.end(),
+                                                         [](size_t x) { return x > 0; }));
+            const uint8_t modal = uint8_t(std::max_element(counts.begin(), counts.end())
+                                          - counts.begin());
+            tpl.widths.push_back(distinct > 1 && !c->leading_zero[f] ? 0 : modal);
+        }
+        out.push_back(std::move(tpl));
+    }
+    return TemplateSet(std::move(out));
+}
+
+} // namespace onpair::encoding
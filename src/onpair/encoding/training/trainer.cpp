@@ -7,6 +7,7 @@
 #include <cstring>
 #include <numeric>
 #include <random>
+#include <string>
 #include <variant>
 
 namespace onpair::encoding {
@@ -56,6 +57,146 @@ void sort_dictionary(TrainResult& result)
     result.lpm = LongestPrefixMatcher::from_dictionary(DictionaryView(result.dict));
 }
 
+// ─────────────────────────────────────────────────────────────────────────────
+// refine — internal helper
+//
+// Runs cfg.refine_passes usage-based replacement passes over the unsorted
+// training dictionary (base tokens at IDs 0–255).  Each pass greedily parses
+// up to REFINE_SAMPLE_BYTES of the rows, in training order, and scores:
+//
+//   merged token t   uses(t) · (split_cost(t) − 1): the extra tokens its
+//                    occurrences would take if t were gone
+//   candidate pair   occurrences of two adjacent tokens whose concatenation
+//                    (≤ MAX_TOKEN_SIZE bytes) is not a token yet: merging
+//                    saves one token each
+//
+// Free slots take the best candidates; then the lowest-scoring merged tokens
+// are swapped for better candidates, at most 1/REFINE_SWAP_DIVISOR of them
+// per pass so that overlapping candidates do not all land at once.  Scores
+// are per-occurrence estimates, which is why later passes re-measure rather
+// than trust them.
+// ─────────────────────────────────────────────────────────────────────────────
+
+constexpr size_t REFINE_SAMPLE_BYTES = size_t(1) << 22;
+constexpr size_t REFINE_SWAP_DIVISOR = 8;
+
+// Tokens the greedy parse spends on a token's own bytes without that token.
+size_t split_cost(const LongestPrefixMatcher& lpm, const uint8_t* str, size_t len)
+{
+    size_t pos   = lpm.find_longest_match(str, len - 1).second;
+    size_t count = 1;
+    for (; pos < len; ++count)
+        pos += lpm.find_longest_match(str + pos, len - pos).second;
+    return count;
+}
+
+void refine(TrainResult& result,
+            const uint8_t* data,
+            const uint32_t* offsets,
+            const std::vector<uint32_t>& order,
+            const TrainingConfig& cfg)
+{
+    const size_t capacity = max_dict_size(cfg.bits);
+
+    std::vector<uint32_t> sample;
+    for (size_t bytes = 0, i = 0; i < order.size() && bytes < REFINE_SAMPLE_BYTES; ++i) {
+        sample.push_back(order[i]);
+        bytes += offsets[order[i] + 1] - offsets[order[i]];
+    }
+
+    struct Candidate {
+        std::string bytes;
+        uint64_t    saved;
+    };
+
+    for (unsigned pass = 0; pass < cfg.refine_passes; ++pass) {
+        const DictionaryView dict(result.dict);
+        const size_t N = dict.num_tokens();
+
+        // ── Parse the sample ──────────────────────────────────────────────
+        std::vector<uint64_t> uses(N, 0);
+        boost::unordered_flat_map<uint32_t, uint32_t> pairs;
+        for (uint32_t idx : sample) {
+            const uint8_t* str = data + offsets[idx];
+            const size_t   len = offsets[idx + 1] - offsets[idx];
+            Token  prev_id  = 0;
+            size_t prev_len = 0;
+            for (size_t pos = 0; pos < len;) {
+                const auto [id, mlen] = result.lpm.find_longest_match(str + pos, len - pos);
+                ++uses[id];
+                if (prev_len != 0 && prev_len + mlen <= MAX_TOKEN_SIZE)
+                    ++pairs[(uint32_t(prev_id) << 16) | uint32_t(id)];
+                prev_id  = id;
+                prev_len = mlen;
+                pos += mlen;
+            }
+        }
+
+        // ── Score merged tokens, least useful first ───────────────────────
+        std::vector<std::pair<uint64_t, Token>> merged;
+        merged.reserve(N - 256);
+        for (size_t t = 256; t < N; ++t) {
+            const Token id = Token(t);
+            merged.emplace_back(
+                uses[t] * (split_cost(result.lpm, dict.data(id), dict.token_size(id)) - 1), id);
+        }
+        std::sort(merged.begin(), merged.end());
+
+        // ── Gather candidates, most useful first ──────────────────────────
+        // Different token pairs can spell the same bytes; their counts add up.
+        boost::unordered_flat_map<std::string, uint64_t> by_bytes;
+        for (const auto& [key, count] : pairs) {
+            if (count < 2) continue;
+            const Token a = Token(key >> 16), b = Token(key & 0xFFFF);
+            std::string s(reinterpret_cast<const char*>(dict.data(a)), dict.token_size(a));
+            s.append(reinterpret_cast<const char*>(dict.data(b)), dict.token_size(b));
+            const auto* p = reinterpret_cast<const uint8_t*>(s.data());
+            if (result.lpm.find_longest_match(p, s.size()).second == s.size()) continue;
+            by_bytes[std::move(s)] += count;
+        }
+        std::vector<Candidate> candidates;
+        candidates.reserve(by_bytes.size());
+        for (auto& [s, saved] : by_bytes) candidates.push_back({s, saved});
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate& x, const Candidate& y) {
+                      return x.saved != y.saved ? x.saved > y.saved : x.bytes < y.bytes;
+                  });
+
+        // ── Fill free slots, then swap ────────────────────────────────────
+        size_t added = std::min(candidates.size(), capacity - N);
+
+        std::vector<bool> evicted(N, false);
+        const size_t max_swaps = merged.size() / REFINE_SWAP_DIVISOR;
+        size_t swaps = 0;
+        while (added < candidates.size() && swaps < max_swaps
+               && candidates[added].saved > merged[swaps].first) {
+            evicted[merged[swaps].second] = true;
+            ++swaps;
+            ++added;
+        }
+        if (added == 0) break;
+
+        // ── Rebuild: surviving tokens in place order, then the new ones ───
+        Dictionary next;
+        next.offsets.reserve(N - swaps + added + 1);
+        next.offsets.push_back(0);
+        for (size_t t = 0; t < N; ++t) {
+            if (evicted[t]) continue;
+            const ByteSpan sp = dict.span(Token(t));
+            next.bytes.insert(next.bytes.end(), dict.raw_bytes() + sp.begin,
+                              dict.raw_bytes() + sp.end);
+            next.offsets.push_back(uint32_t(next.bytes.size()));
+        }
+        for (size_t c = 0; c < added; ++c) {
+            next.bytes.insert(next.bytes.end(), candidates[c].bytes.begin(),
+                              candidates[c].bytes.end());
+            next.offsets.push_back(uint32_t(next.bytes.size()));
+        }
+        result.dict = std::move(next);
+        result.lpm  = LongestPrefixMatcher::from_dictionary(DictionaryView(result.dict));
+    }
+}
+
 } // anonymous namespace
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -187,6 +328,10 @@ TrainResult train(const uint8_t* data,
         }
     }
 
+    // ── Usage-based refinement ────────────────────────────────────────────
+    if (cfg.refine_passes > 0)
+        refine(result, data, offsets, order, cfg);
+
     // ── Sort lexicographically before returning ───────────────────────────
     sort_dictionary(result);
 
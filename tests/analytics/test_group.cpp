@@ -0,0 +1,166 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace analytics = onpair::analytics;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::string row(const op::OnPairColumnView& v, size_t i) {
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    return std::string(buf.data(), v.decompress(i, buf.data()));
+}
+
+class GroupBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, GroupBitsTest,
+    testing::Values(9, 12, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(GroupBitsTest, MatchesStringGroupBy) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto base = make_user_strings(150);
+    auto mixed = make_mixed_length_strings(60, 40, 2);
+    base.insert(base.end(), mixed.begin(), mixed.end());
+
+    std::vector<std::string> data;
+    for (int i = 0; i < 4000; ++i) data.push_back(base[(i * 31 + i / 7) % base.size()]);
+
+    auto col = make_column(data, bits);
+    auto v = col.view();
+    const auto g = analytics::group_rows(v);
+
+    std::map<std::string, std::vector<size_t>> expected;
+    for (size_t i = 0; i < data.size(); ++i) expected[data[i]].push_back(i);
+
+    ASSERT_EQ(g.num_groups(), expected.size());
+    ASSERT_EQ(g.group_of.size(), data.size());
+    for (size_t k = 0; k < g.num_groups(); ++k) {
+        const auto key = row(v, g.representative[k]);
+        const auto& rows = expected.at(key);
+        EXPECT_EQ(g.representative[k], rows.front());
+        EXPECT_EQ(g.count[k], rows.size());
+        for (size_t r : rows) EXPECT_EQ(g.group_of[r], k);
+    }
+}
+
+TEST(GroupTest, IdsFollowFirstAppearance) {
+    std::vector<std::string> data = {"b", "a", "b", "c", "a", "b"};
+    auto col = make_column(data);
+    const auto g = analytics::group_rows(col.view());
+    EXPECT_EQ(g.group_of, (std::vector<uint32_t>{0, 1, 0, 2, 1, 0}));
+    EXPECT_EQ(g.representative, (std::vector<size_t>{0, 1, 3}));
+    EXPECT_EQ(g.count, (std::vector<uint64_t>{3, 2, 1}));
+}
+
+TEST(GroupTest, DistinctRows) {
+    std::vector<std::string> data = {"", "x", "", "y", "x", ""};
+    auto col = make_column(data);
+    EXPECT_EQ(analytics::distinct_rows(col.view()), (std::vector<size_t>{0, 1, 3}));
+}
+
+TEST(GroupTest, EmptyColumn) {
+    std::vector<std::string> data;
+    auto col = make_column(data);
+    const auto g = analytics::group_rows(col.view());
+    EXPECT_EQ(g.num_groups(), 0u);
+    EXPECT_TRUE(g.group_of.empty());
+}
+
+TEST(GroupTest, AllRowsDistinct) {
+    auto data = make_user_strings(3000);
+    auto col = make_column(data);
+    const auto g = analytics::group_rows(col.view());
+    EXPECT_EQ(g.num_groups(), data.size());
+    for (auto c : g.count) EXPECT_EQ(c, 1u);
+}
+
+// ── NULL rows ─────────────────────────────────────────────────────────────────
+
+static op::OnPairColumn make_nullable(const std::vector<std::string>& strings,
+                                      const std::vector<bool>& valid)
+{
+    const auto raw = make_raw(strings);
+    std::vector<uint8_t> bitmap((strings.size() + 7) / 8, 0);
+    for (size_t i = 0; i < valid.size(); ++i)
+        if (valid[i]) bitmap[i / 8] |= uint8_t(1u << (i % 8));
+    op::encoding::TrainingConfig cfg;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(reinterpret_cast<const char*>(raw.data.data()),
+                                      raw.offsets.data(), strings.size(),
+                                      bitmap.data(), cfg);
+}
+
+TEST(GroupTest, NullRowsJoinNoGroup) {
+    // Rows 2 and 5 are NULL; row 0 is a real "" and must not absorb them.
+    const std::vector<std::string> data = {"", "x", "", "y", "x", ""};
+    auto col = make_nullable(data, {true, true, false, true, true, false});
+    const auto g = analytics::group_rows(col.view());
+
+    constexpr uint32_t N = analytics::NO_GROUP;
+    EXPECT_EQ(g.group_of, (std::vector<uint32_t>{0, 1, N, 2, 1, N}));
+    EXPECT_EQ(g.count, (std::vector<uint64_t>{1, 2, 1}));
+    EXPECT_EQ(g.null_count, 2u);
+    EXPECT_EQ(analytics::distinct_rows(col.view()), (std::vector<size_t>{0, 1, 3}));
+}
+
+TEST(GroupTest, NullRowsHashAsSkipped) {
+    const std::vector<std::string> data = {"a", "", "b"};
+    auto col = make_nullable(data, {true, false, true});
+    std::vector<uint64_t> h(3);
+    analytics::hash_rows(col.view(), h.data());
+    EXPECT_EQ(h[1], analytics::SKIPPED_ROW_HASH);
+    EXPECT_NE(h[0], analytics::SKIPPED_ROW_HASH);
+    EXPECT_NE(h[2], analytics::SKIPPED_ROW_HASH);
+}
+
+// ── Deleted rows ──────────────────────────────────────────────────────────────
+
+TEST(GroupTest, DeletedRowsCountNowhere) {
+    // "c" survives only in deleted rows; row 0 (the first "a") is deleted too.
+    std::vector<std::string> data;
+    for (int i = 0; i < 300; ++i) data.push_back(std::string(1, char('a' + i % 3)));
+    auto col = make_column(data);
+    std::vector<size_t> gone = {0};
+    for (size_t i = 2; i < data.size(); i += 3) gone.push_back(i);
+    col.erase(gone);
+    auto v = col.view();
+
+    const auto g = analytics::group_rows(v);
+    ASSERT_EQ(g.num_groups(), 2u);
+    EXPECT_EQ(g.representative, (std::vector<size_t>{1, 3}));   // "b", then "a"
+    EXPECT_EQ(g.count, (std::vector<uint64_t>{100, 99}));
+    EXPECT_EQ(g.null_count, 0u);
+    for (size_t r : gone) EXPECT_EQ(g.group_of[r], analytics::NO_GROUP) << r;
+    EXPECT_EQ(analytics::distinct_rows(v), (std::vector<size_t>{1, 3}));
+
+    EXPECT_NEAR(analytics::build_hll(v).estimate(), 2.0, 0.5);
+    const auto s = analytics::build_space_saving(v, 8);
+    ASSERT_EQ(s.size(), 2u);
+    for (const auto& c : s.counters()) EXPECT_FALSE(c.row == 0 || c.row % 3 == 2) << c.row;
+}
+
+TEST(GroupTest, DeletedNullRowsAreNotCounted) {
+    const std::vector<std::string> data = {"a", "", "", "a"};
+    auto col = make_nullable(data, {true, false, false, true});
+    col.erase(2);
+    const auto g = analytics::group_rows(col.view());
+    EXPECT_EQ(g.null_count, 1u);
+    EXPECT_EQ(g.count, (std::vector<uint64_t>{2}));
+
+    std::vector<uint64_t> h(4);
+    analytics::hash_rows(col.view(), h.data());
+    EXPECT_EQ(h[2], analytics::SKIPPED_ROW_HASH);
+}
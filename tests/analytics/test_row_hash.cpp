@@ -0,0 +1,152 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace op = onpair;
+namespace analytics = onpair::analytics;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::vector<uint64_t> hashes_of(const op::OnPairColumnView& v) {
+    std::vector<uint64_t> h(v.num_strings());
+    analytics::hash_rows(v, h.data());
+    return h;
+}
+
+// ── TokenHasher ───────────────────────────────────────────────────────────────
+
+TEST(TokenHasherTest, AddSpanMatchesAdd) {
+    std::vector<op::Token> toks;
+    for (int i = 0; i < 37; ++i) toks.push_back(op::Token(i * 977 + 5));
+    for (size_t len = 0; len <= toks.size(); ++len) {
+        analytics::TokenHasher a, b, c;
+        for (size_t i = 0; i < len; ++i) a.add(toks[i]);
+        b.add_span(toks.data(), len);
+        // Split at an unaligned point: the span path must resume correctly.
+        const size_t cut = len / 3;
+        for (size_t i = 0; i < cut; ++i) c.add(toks[i]);
+        c.add_span(toks.data() + cut, len - cut);
+        EXPECT_EQ(a.finish(), b.finish()) << len;
+        EXPECT_EQ(a.finish(), c.finish()) << len;
+    }
+}
+
+TEST(TokenHasherTest, LengthAndOrderMatter) {
+    auto h = [](std::vector<op::Token> t) {
+        analytics::TokenHasher x;
+        x.add_span(t.data(), t.size());
+        return x.finish();
+    };
+    EXPECT_NE(h({}), h({0}));
+    EXPECT_NE(h({0}), h({0, 0}));
+    EXPECT_NE(h({1, 2}), h({2, 1}));
+    EXPECT_NE(h({1, 2, 3, 4}), h({1, 2, 3, 4, 0}));
+}
+
+// ── hash_rows ─────────────────────────────────────────────────────────────────
+
+class RowHashBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, RowHashBitsTest,
+    testing::Values(9, 10, 11, 12, 13, 14, 15, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(RowHashBitsTest, EqualStringsHashEqual) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto base = make_mixed_length_strings(400, 60, 13);
+    std::vector<std::string> data;
+    for (int rep = 0; rep < 3; ++rep)
+        for (size_t i = rep; i < base.size(); i += 1 + rep) data.push_back(base[i]);
+
+    auto col = make_column(data, bits);
+    const auto h = hashes_of(col.view());
+
+    std::unordered_map<std::string, uint64_t> seen;
+    std::unordered_set<uint64_t> distinct_hashes;
+    for (size_t i = 0; i < data.size(); ++i) {
+        auto [it, inserted] = seen.try_emplace(data[i], h[i]);
+        if (!inserted) EXPECT_EQ(it->second, h[i]) << i;
+        distinct_hashes.insert(h[i]);
+    }
+    // No collisions expected among a few hundred distinct values.
+    EXPECT_EQ(distinct_hashes.size(), seen.size());
+}
+
+TEST(RowHashTest, RangesMatchWholeColumn) {
+    auto data = make_user_strings(5000);
+    auto col = make_column(data);
+    auto v = col.view();
+    const auto all = hashes_of(v);
+
+    std::vector<uint64_t> part(1234);
+    analytics::hash_rows(v, 1000, 2234, part.data());
+    EXPECT_TRUE(std::equal(part.begin(), part.end(), all.begin() + 1000));
+}
+
+TEST(RowHashTest, RowLongerThanBlock) {
+    std::string big(50000, 'k');
+    big[777] = 'x';
+    std::vector<std::string> data = {"a", big, "b", big};
+    auto col = make_column(data);
+    auto v = col.view();
+    EXPECT_GT(v.store().num_tokens(), onpair::search::detail::SCAN_BLOCK_TOKENS);
+
+    const auto h = hashes_of(v);
+    EXPECT_EQ(h[1], h[3]);
+    EXPECT_NE(h[0], h[2]);
+
+    analytics::TokenHasher ref;
+    for (auto t : onpair::search::detail::tokenize(big, v.dictionary())) ref.add(t);
+    EXPECT_EQ(h[1], ref.finish());
+}
+
+TEST(RowHashTest, EmptyRowsHashEqual) {
+    std::vector<std::string> data = {"", "x", ""};
+    auto col = make_column(data);
+    const auto h = hashes_of(col.view());
+    EXPECT_EQ(h[0], h[2]);
+    EXPECT_NE(h[0], h[1]);
+}
+
+// ── rows_equal ────────────────────────────────────────────────────────────────
+
+TEST(RowHashTest, RowsEqualComparesTokenSequences) {
+    std::vector<std::string> data = {"hello", "world", "hello", "hell", ""};
+    auto col = make_column(data);
+    auto v = col.view();
+    EXPECT_TRUE(analytics::rows_equal(v, 0, v, 2));
+    EXPECT_FALSE(analytics::rows_equal(v, 0, v, 1));
+    EXPECT_FALSE(analytics::rows_equal(v, 0, v, 3));
+    EXPECT_TRUE(analytics::rows_equal(v, 4, v, 4));
+}
+
+TEST(RowHashTest, RowsEqualRejectsNullAndDeletedRows) {
+    // Rows 1 and 2 are NULL, row 0 is a real ""; all three hold no tokens.
+    const std::vector<std::string> data = {"", "", "", "", "x"};
+    const auto raw = make_raw(data);
+    const uint8_t validity = 0b11001;
+    op::encoding::TrainingConfig cfg;
+    cfg.seed = 42;
+    auto col = op::OnPairColumn::compress(reinterpret_cast<const char*>(raw.data.data()),
+                                          raw.offsets.data(), data.size(), &validity, cfg);
+    col.erase(3);
+    auto v = col.view();
+    EXPECT_TRUE(analytics::rows_equal(v, 0, v, 0));
+    EXPECT_FALSE(analytics::rows_equal(v, 0, v, 1));
+    EXPECT_FALSE(analytics::rows_equal(v, 1, v, 0));
+    EXPECT_FALSE(analytics::rows_equal(v, 1, v, 2));
+    EXPECT_FALSE(analytics::rows_equal(v, 1, v, 1));
+    EXPECT_FALSE(analytics::rows_equal(v, 0, v, 3));
+}
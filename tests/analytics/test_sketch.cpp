@@ -0,0 +1,207 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace op = onpair;
+namespace analytics = onpair::analytics;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+// Zipf-like column: value k appears about n / (k + 1) times.
+static std::vector<std::string> skewed(size_t distinct, size_t rows, uint64_t seed) {
+    auto values = make_user_strings(int(distinct));
+    std::vector<double> w(distinct);
+    for (size_t k = 0; k < distinct; ++k) w[k] = 1.0 / double(k + 1);
+    std::discrete_distribution<size_t> pick(w.begin(), w.end());
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> out;
+    for (size_t i = 0; i < rows; ++i) out.push_back(values[pick(rng)]);
+    return out;
+}
+
+// ── HyperLogLog ───────────────────────────────────────────────────────────────
+
+TEST(HyperLogLogTest, EstimateWithinErrorBound) {
+    for (int distinct : {10, 1000, 20000}) {
+        auto base = make_user_strings(distinct);
+        std::vector<std::string> data;
+        for (int rep = 0; rep < 3; ++rep) data.insert(data.end(), base.begin(), base.end());
+        auto col = make_column(data);
+
+        const auto h = analytics::build_hll(col.view());
+        EXPECT_NEAR(h.estimate(), double(distinct), 0.05 * distinct + 1) << distinct;
+    }
+}
+
+TEST(HyperLogLogTest, EmptyColumnEstimatesZero) {
+    std::vector<std::string> data;
+    auto col = make_column(data);
+    EXPECT_EQ(analytics::build_hll(col.view()).estimate(), 0.0);
+}
+
+TEST(HyperLogLogTest, MergeOfRangesEqualsWholeColumn) {
+    auto data = skewed(5000, 30000, 1);
+    auto col = make_column(data);
+    auto v = col.view();
+
+    const auto whole = analytics::build_hll(v);
+    auto a = analytics::build_hll(v, 0, 12345);
+    const auto b = analytics::build_hll(v, 12345, v.num_strings());
+    a.merge(b);
+    EXPECT_TRUE(std::ranges::equal(a.registers(), whole.registers()));
+}
+
+TEST(HyperLogLogTest, RegistersRoundTrip) {
+    auto col = make_column(make_user_strings(777));
+    const auto h = analytics::build_hll(col.view(), 10);
+    std::vector<uint8_t> saved(h.registers().begin(), h.registers().end());
+    const auto r = analytics::HyperLogLog::from_registers(10, saved);
+    EXPECT_EQ(r.estimate(), h.estimate());
+    EXPECT_THROW(analytics::HyperLogLog::from_registers(11, saved), std::invalid_argument);
+}
+
+TEST(HyperLogLogTest, RejectsBadPrecisionAndMismatchedMerge) {
+    EXPECT_THROW(analytics::HyperLogLog(3), std::invalid_argument);
+    EXPECT_THROW(analytics::HyperLogLog(19), std::invalid_argument);
+    analytics::HyperLogLog a(10), b(12);
+    EXPECT_THROW(a.merge(b), std::invalid_argument);
+}
+
+// ── SpaceSaving ───────────────────────────────────────────────────────────────
+
+static std::map<std::string, uint64_t> exact_counts(const std::vector<std::string>& d) {
+    std::map<std::string, uint64_t> m;
+    for (const auto& s : d) ++m[s];
+    return m;
+}
+
+static std::string row(const op::OnPairColumnView& v, size_t i) {
+    std::vector<char> buf(256 + op::DECOMPRESS_BUFFER_PADDING);
+    return std::string(buf.data(), v.decompress(i, buf.data()));
+}
+
+TEST(SpaceSavingTest, ExactWhenCapacityCoversAllValues) {
+    std::vector<std::string> data = {"a", "b", "a", "c", "a", "b"};
+    auto col = make_column(data);
+    auto v = col.view();
+    const auto top = analytics::build_space_saving(v, 8).top(3);
+    ASSERT_EQ(top.size(), 3u);
+    EXPECT_EQ(row(v, top[0].row), "a"); EXPECT_EQ(top[0].count, 3u);
+    EXPECT_EQ(row(v, top[1].row), "b"); EXPECT_EQ(top[1].count, 2u);
+    EXPECT_EQ(row(v, top[2].row), "c"); EXPECT_EQ(top[2].count, 1u);
+    for (const auto& c : top) EXPECT_EQ(c.error, 0u);
+}
+
+TEST(SpaceSavingTest, HeavyHittersWithinGuarantees) {
+    auto data = skewed(2000, 50000, 7);
+    auto col = make_column(data);
+    auto v = col.view();
+    const auto exact = exact_counts(data);
+
+    const size_t capacity = 200;
+    const auto s = analytics::build_space_saving(v, capacity);
+    EXPECT_EQ(s.size(), capacity);
+
+    const auto top = s.top(10);
+    for (const auto& c : top) {
+        const uint64_t truth = exact.at(row(v, c.row));
+        EXPECT_GE(c.count, truth);
+        EXPECT_LE(c.count - c.error, truth);
+    }
+    // Every value above rows / capacity must be tracked.
+    std::unordered_set<std::string> tracked;
+    for (const auto& c : s.counters()) tracked.insert(row(v, c.row));
+    for (const auto& [value, count] : exact)
+        if (count > data.size() / capacity) EXPECT_TRUE(tracked.contains(value)) << value;
+}
+
+TEST(SpaceSavingTest, ParallelRangesMergeAndKeepGuarantees) {
+    auto data = skewed(3000, 60000, 11);
+    auto col = make_column(data);
+    auto v = col.view();
+    const auto exact = exact_counts(data);
+
+    const size_t capacity = 300, parts = 4;
+    std::vector<analytics::SpaceSaving> partial(parts, analytics::SpaceSaving(capacity));
+    std::vector<analytics::HyperLogLog> hll(parts);
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < parts; ++p) {
+        threads.emplace_back([&, p] {
+            const size_t lo = v.num_strings() * p / parts;
+            const size_t hi = v.num_strings() * (p + 1) / parts;
+            partial[p] = analytics::build_space_saving(v, lo, hi, capacity);
+            hll[p]     = analytics::build_hll(v, lo, hi);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    for (size_t p = 1; p < parts; ++p) {
+        partial[0].merge(partial[p]);
+        hll[0].merge(hll[p]);
+    }
+    EXPECT_TRUE(std::ranges::equal(hll[0].registers(),
+                                   analytics::build_hll(v).registers()));
+
+    for (const auto& c : partial[0].top(10)) {
+        const uint64_t truth = exact.at(row(v, c.row));
+        EXPECT_GE(c.count, truth);
+        EXPECT_LE(c.count - c.error, truth);
+    }
+    // The single most frequent value is unambiguous on this distribution.
+    EXPECT_EQ(row(v, partial[0].top(1)[0].row), "user_000000");
+}
+
+TEST(SpaceSavingTest, CountersRoundTrip) {
+    auto data = skewed(100, 2000, 3);
+    auto col = make_column(data);
+    const auto s = analytics::build_space_saving(col.view(), 16);
+    std::vector<analytics::SpaceSaving::Counter> saved(s.counters().begin(), s.counters().end());
+    const auto r = analytics::SpaceSaving::from_counters(16, saved);
+    const auto a = s.top(16), b = r.top(16);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].hash, b[i].hash);
+        EXPECT_EQ(a[i].count, b[i].count);
+    }
+    EXPECT_THROW(analytics::SpaceSaving::from_counters(4, saved), std::invalid_argument);
+    EXPECT_THROW(analytics::SpaceSaving(0), std::invalid_argument);
+}
+
+// ── NULL rows ─────────────────────────────────────────────────────────────────
+
+TEST(SketchNullTest, NullRowsAreNotAValue) {
+    // Three values among mostly NULL rows, which are stored as "".
+    std::vector<std::string> data;
+    std::vector<uint8_t> bitmap((3000 + 7) / 8, 0);
+    for (size_t i = 0; i < 3000; ++i) {
+        const bool valid = i % 10 == 0;
+        data.push_back(valid ? "v" + std::to_string(i % 3) : "");
+        if (valid) bitmap[i / 8] |= uint8_t(1u << (i % 8));
+    }
+    const auto raw = make_raw(data);
+    op::encoding::TrainingConfig cfg;
+    cfg.seed = 42;
+    auto col = op::OnPairColumn::compress(reinterpret_cast<const char*>(raw.data.data()),
+                                          raw.offsets.data(), data.size(), bitmap.data(), cfg);
+    auto v = col.view();
+
+    EXPECT_NEAR(analytics::build_hll(v).estimate(), 3.0, 0.5);
+    const auto s = analytics::build_space_saving(v, 8);
+    ASSERT_EQ(s.size(), 3u);
+    for (const auto& c : s.counters()) EXPECT_TRUE(v.is_valid(c.row)) << c.row;
+}
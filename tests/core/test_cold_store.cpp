@@ -0,0 +1,132 @@
+#include <onpair/core/cold_store.h>
+#include <onpair/encoding/parsing/bit_writer.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace onpair;
+
+namespace {
+
+// `rows` rows of 0..2*avg tokens drawn from a Zipf-like distribution over
+// 2^bits ids, packed as the encoder packs them.
+Store make_store(BitWidth bits, size_t rows, size_t avg, double skew, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<double> w(max_dict_size(bits));
+    for (size_t t = 0; t < w.size(); ++t) w[t] = 1.0 / std::pow(double(t + 1), skew);
+    std::discrete_distribution<uint32_t> token(w.begin(), w.end());
+    std::uniform_int_distribution<size_t> length(0, 2 * avg);
+
+    Store s{bits, {}, {0}};
+    {
+        encoding::BitWriter writer(s);
+        for (size_t r = 0; r < rows; ++r) {
+            for (size_t k = length(rng); k > 0; --k) writer.write(Token(token(rng)));
+            s.boundaries.push_back(uint32_t(writer.tokens_written()));
+        }
+    }
+    return s;
+}
+
+void expect_same(const Store& a, const Store& b) {
+    EXPECT_EQ(a.bit_width, b.bit_width);
+    EXPECT_EQ(a.boundaries, b.boundaries);
+    EXPECT_EQ(a.packed, b.packed);
+}
+
+} // namespace
+
+// ── Round trip ────────────────────────────────────────────────────────────────
+
+TEST(ColdStoreTest, DecodeRestoresTheStoreAtEveryBitWidth) {
+    for (BitWidth bits = 9; bits <= 16; ++bits) {
+        const Store s = make_store(bits, 2000, 8, 1.1, bits);
+        expect_same(ColdStore::encode(s).decode(1), s);
+    }
+}
+
+TEST(ColdStoreTest, SkewedTokensTakeFewerBits) {
+    const Store     s = make_store(16, 20000, 10, 1.2, 3);
+    const ColdStore c = ColdStore::encode(s);
+    EXPECT_LT(c.bytes_used() * 10, s.bytes_used() * 7);
+}
+
+TEST(ColdStoreTest, ThreadedDecodeMatchesSerial) {
+    const Store     s = make_store(12, 40000, 10, 1.0, 5);   // several blocks
+    const ColdStore c = ColdStore::encode(s);
+    ASSERT_GT(c.num_blocks(), 4u);
+    expect_same(c.decode(1), s);
+    expect_same(c.decode(4), s);
+    expect_same(c.decode(64), s);
+}
+
+TEST(ColdStoreTest, LongCodesAreLengthLimited) {
+    // Exponentially skewed counts would give codes far longer than the limit.
+    Store s{16, {}, {0}};
+    {
+        encoding::BitWriter writer(s);
+        for (uint32_t t = 0; t < 40; ++t)
+            for (uint64_t k = 0; k < (uint64_t(1) << (t < 20 ? 20 - t : 0)); ++k)
+                writer.write(Token(t * 1000));
+        s.boundaries.push_back(uint32_t(writer.tokens_written()));
+    }
+    expect_same(ColdStore::encode(s).decode(2), s);
+}
+
+TEST(ColdStoreTest, SingleTokenAndEmptyRows) {
+    Store one{10, {}, {0}};
+    {
+        encoding::BitWriter writer(one);
+        for (int k = 0; k < 100; ++k) writer.write(7);
+        one.boundaries = {0, 0, 100, 100};
+    }
+    expect_same(ColdStore::encode(one).decode(), one);
+
+    const Store empty{10, {}, {0, 0, 0}};
+    const ColdStore c = ColdStore::encode(empty);
+    EXPECT_EQ(c.num_strings(), 2u);
+    expect_same(c.decode(), empty);
+}
+
+TEST(ColdStoreTest, WrongHistogramFallsBackToCounting) {
+    const Store s = make_store(11, 500, 6, 1.0, 9);
+    const std::vector<uint32_t> partial(10, 1);   // misses most tokens
+    expect_same(ColdStore::encode(s, partial).decode(), s);
+}
+
+// ── Serialisation ─────────────────────────────────────────────────────────────
+
+TEST(ColdStoreTest, WriteReadRoundTrip) {
+    const Store s = make_store(14, 3000, 12, 1.1, 11);
+    std::stringstream io;
+    ColdStore::encode(s).write_to(io);
+    const ColdStore c = ColdStore::read_from(io);
+    EXPECT_EQ(c.num_tokens(), s.num_tokens());
+    expect_same(c.decode(), s);
+}
+
+TEST(ColdStoreTest, ReadRejectsCorruptStreams) {
+    const Store s = make_store(9, 300, 5, 1.0, 13);
+    std::ostringstream out;
+    ColdStore::encode(s).write_to(out);
+    const std::string blob = out.str();
+
+    const auto read = [](std::string bytes) {
+        std::istringstream in(bytes);
+        return ColdStore::read_from(in);
+    };
+    EXPECT_THROW(read(blob.substr(0, blob.size() - 1)), std::runtime_error);
+
+    std::string bad_bits = blob;
+    bad_bits[0] = 3;
+    EXPECT_THROW(read(bad_bits), std::runtime_error);
+
+    // First code length (after bits, rows, tokens, block size and count).
+    std::string bad_length = blob;
+    bad_length[1 + 8 + 8 + 4 + 8] = char(MAX_COLD_CODE_LENGTH + 1);
+    EXPECT_THROW(read(bad_length), std::runtime_error);
+}
@@ -0,0 +1,135 @@
+#include <onpair/core/compact_dictionary.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace onpair;
+
+namespace {
+
+Dictionary make_dictionary(std::vector<std::string> tokens) {
+    std::sort(tokens.begin(), tokens.end());
+    Dictionary d;
+    d.offsets.push_back(0);
+    for (const auto& t : tokens) {
+        d.bytes.insert(d.bytes.end(), t.begin(), t.end());
+        d.offsets.push_back(static_cast<uint32_t>(d.bytes.size()));
+    }
+    d.pad_for_decoder();
+    return d;
+}
+
+// All single bytes plus multi-byte tokens with long shared prefixes, as a
+// trained dictionary has.
+Dictionary sample_dictionary() {
+    std::vector<std::string> tokens;
+    for (int b = 0; b < 256; ++b) tokens.emplace_back(1, char(b));
+    for (int i = 0; i < 500; ++i) {
+        tokens.push_back("user_" + std::to_string(i));
+        tokens.push_back("https://www." + std::to_string(i % 97).substr(0, 2));
+    }
+    tokens.push_back(std::string(MAX_TOKEN_SIZE, 'z'));
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    return make_dictionary(tokens);
+}
+
+std::string token_of(const Dictionary& d, size_t i) {
+    return std::string(d.bytes.begin() + d.offsets[i], d.bytes.begin() + d.offsets[i + 1]);
+}
+
+} // namespace
+
+// ── encode / expand ───────────────────────────────────────────────────────────
+
+TEST(CompactDictionaryTest, ExpandRestoresTheDictionary) {
+    const Dictionary d = sample_dictionary();
+    const Dictionary e = CompactDictionary::encode(d).expand();
+    EXPECT_EQ(e.offsets, d.offsets);
+    EXPECT_EQ(e.bytes, d.bytes);   // decoder padding included
+}
+
+TEST(CompactDictionaryTest, IsSmallerThanTheFlatLayout) {
+    const Dictionary        d = sample_dictionary();
+    const CompactDictionary c = CompactDictionary::encode(d);
+    EXPECT_EQ(c.num_tokens(), d.num_tokens());
+    EXPECT_LT(c.bytes_used() * 2, d.bytes_used());
+}
+
+TEST(CompactDictionaryTest, TokenDecodesOneTokenInPlace) {
+    const Dictionary        d = sample_dictionary();
+    const CompactDictionary c = CompactDictionary::encode(d);
+    uint8_t out[MAX_TOKEN_SIZE];
+    for (size_t i = 0; i < d.num_tokens(); ++i) {
+        const size_t len = c.token(static_cast<Token>(i), out);
+        ASSERT_EQ(std::string(reinterpret_cast<char*>(out), len), token_of(d, i)) << i;
+    }
+}
+
+TEST(CompactDictionaryTest, PrefixAndDuplicateTokensKeepANonEmptySuffix) {
+    const Dictionary d = make_dictionary({"a", "a", "ab", "ab", "abc", std::string(16, 'q'),
+                                          std::string(16, 'q')});
+    const Dictionary e = CompactDictionary::encode(d).expand();
+    EXPECT_EQ(e.offsets, d.offsets);
+    EXPECT_EQ(e.bytes, d.bytes);
+}
+
+TEST(CompactDictionaryTest, EmptyDictionary) {
+    const CompactDictionary c = CompactDictionary::encode(Dictionary{});
+    EXPECT_EQ(c.num_tokens(), 0u);
+    EXPECT_EQ(c.expand().num_tokens(), 0u);
+}
+
+TEST(CompactDictionaryTest, EncodeRejectsTokensOutOfRange) {
+    EXPECT_THROW(CompactDictionary::encode(make_dictionary({"a", ""})), std::invalid_argument);
+    EXPECT_THROW(CompactDictionary::encode(make_dictionary({std::string(17, 'x')})),
+                 std::invalid_argument);
+}
+
+// ── from_bytes ────────────────────────────────────────────────────────────────
+
+TEST(CompactDictionaryTest, FromBytesRoundTrips) {
+    const Dictionary        d = sample_dictionary();
+    const CompactDictionary c = CompactDictionary::encode(d);
+    const CompactDictionary r = CompactDictionary::from_bytes(c.num_tokens(), c.bytes());
+    EXPECT_EQ(r.bytes_used(), c.bytes_used());
+    EXPECT_EQ(r.expand().bytes, d.bytes);
+}
+
+TEST(CompactDictionaryTest, FromBytesRejectsCorruptInput) {
+    const CompactDictionary c = CompactDictionary::encode(sample_dictionary());
+    std::vector<uint8_t> bytes = c.bytes();
+
+    EXPECT_THROW(CompactDictionary::from_bytes(c.num_tokens() + 1, bytes), std::runtime_error);
+    EXPECT_THROW(CompactDictionary::from_bytes(c.num_tokens() - 1, bytes), std::runtime_error);
+
+    std::vector<uint8_t> shared_at_start = bytes;
+    shared_at_start[0] |= 0x10;
+    EXPECT_THROW(CompactDictionary::from_bytes(c.num_tokens(), shared_at_start),
+                 std::runtime_error);
+
+    bytes.pop_back();
+    EXPECT_THROW(CompactDictionary::from_bytes(c.num_tokens(), bytes), std::runtime_error);
+}
+
+// ── LazyDictionary ────────────────────────────────────────────────────────────
+
+TEST(LazyDictionaryTest, ExpandsOnceOnFirstUse) {
+    const Dictionary d = sample_dictionary();
+    const LazyDictionary lazy(std::make_shared<const CompactDictionary>(
+        CompactDictionary::encode(d)));
+    EXPECT_FALSE(lazy.expanded());
+
+    std::vector<const Dictionary*> seen(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < seen.size(); ++t)
+        threads.emplace_back([&, t] { seen[t] = lazy.get().get(); });
+    for (auto& th : threads) th.join();
+
+    EXPECT_TRUE(lazy.expanded());
+    for (const Dictionary* p : seen) EXPECT_EQ(p, lazy.get().get());
+    EXPECT_EQ(lazy.get()->bytes, d.bytes);
+}
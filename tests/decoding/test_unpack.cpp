@@ -0,0 +1,101 @@
+#include <onpair/core/store.h>
+#include <onpair/encoding/parsing/bit_writer.h>
+#include <onpair/decoding/detail/unpack.h>
+#include <onpair/decoding/token_cursor.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace onpair;
+using namespace onpair::encoding;
+using namespace onpair::decoding;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static Store make_packed(BitWidth bits, const std::vector<Token>& tokens)
+{
+    Store store;
+    store.bit_width = bits;
+    {
+        BitWriter writer(store);
+        for (Token t : tokens) writer.write(t);
+    }
+    return store;
+}
+
+static std::vector<Token> random_tokens(BitWidth bits, size_t n, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<uint32_t> dist(0, (1u << bits) - 1);
+    std::vector<Token> v(n);
+    for (auto& t : v) t = Token(dist(rng));
+    return v;
+}
+
+static std::vector<Token> unpack_dispatch(const Store& store,
+                                          uint32_t first, uint32_t count)
+{
+    std::vector<Token> out(count + 1, 0xBEEF);
+    dispatch_bits(store.bit_width, [&](auto bw) {
+        detail::unpack_tokens<bw.value>(store.packed.data(), first, count,
+                                        out.data());
+    });
+    EXPECT_EQ(out[count], 0xBEEF) << "wrote past count";
+    out.pop_back();
+    return out;
+}
+
+// ── Tests ─────────────────────────────────────────────────────────────────────
+
+class UnpackTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, UnpackTest,
+    testing::Values(9, 10, 11, 12, 13, 14, 15, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+// Whole stream from token 0 (group-aligned start).
+TEST_P(UnpackTest, WholeStream) {
+    const BitWidth bw = static_cast<BitWidth>(GetParam());
+    auto tokens = random_tokens(bw, 1000, 1);
+    auto store = make_packed(bw, tokens);
+    EXPECT_EQ(unpack_dispatch(store, 0, 1000), tokens);
+}
+
+// Every start offset within the first two groups, with lengths that cover
+// head-only, head+body and head+body+tail splits.
+TEST_P(UnpackTest, EveryStartAndLength) {
+    const BitWidth bw = static_cast<BitWidth>(GetParam());
+    auto tokens = random_tokens(bw, 400, 2);
+    auto store = make_packed(bw, tokens);
+
+    for (uint32_t first = 0; first < 130; ++first) {
+        for (uint32_t count : {0u, 1u, 15u, 16u, 17u, 63u, 64u, 65u, 200u}) {
+            if (first + count > tokens.size()) continue;
+            std::vector<Token> expected(tokens.begin() + first,
+                                        tokens.begin() + first + count);
+            ASSERT_EQ(unpack_dispatch(store, first, count), expected)
+                << "first=" << first << " count=" << count;
+        }
+    }
+}
+
+// Agrees with TokenCursor on the final tokens (sentinel over-read path).
+TEST_P(UnpackTest, TailMatchesCursor) {
+    const BitWidth bw = static_cast<BitWidth>(GetParam());
+    auto tokens = random_tokens(bw, 77, 3);
+    auto store = make_packed(bw, tokens);
+
+    auto got = unpack_dispatch(store, 70, 7);
+    dispatch_bits(bw, [&](auto b) {
+        TokenCursor<b.value> cur(store.packed.data(), StreamSpan{70, 77});
+        for (Token t : got) EXPECT_EQ(cur.next(), t);
+    });
+}
+
+// Max-value tokens exercise every mask bit.
+TEST_P(UnpackTest, AllOnes) {
+    const BitWidth bw = static_cast<BitWidth>(GetParam());
+    std::vector<Token> tokens(150, Token((1u << bw) - 1));
+    auto store = make_packed(bw, tokens);
+    EXPECT_EQ(unpack_dispatch(store, 3, 140),
+              std::vector<Token>(140, Token((1u << bw) - 1)));
+}
@@ -212,3 +212,41 @@ TEST(BitWriterTest_Manual, StradlingBitLayoutAt12Bits) {
 
     EXPECT_EQ(roundtrip(12, tokens), tokens);
 }
+
+// ── write_run ─────────────────────────────────────────────────────────────────
+
+// Copy arbitrary runs out of one stream into another, interleaved with single
+// writes, and compare with writing the same tokens one by one.
+TEST_P(BitWriterTest, WriteRunMatchesTokenWrites) {
+    const BitWidth bits = GetParam();
+    std::vector<Token> src_tokens(500);
+    for (size_t i = 0; i < src_tokens.size(); ++i)
+        src_tokens[i] = Token((i * 2654435761u) & max_token(bits));
+
+    Store src;
+    src.bit_width = bits;
+    { BitWriter w(src); for (Token t : src_tokens) w.write(t); }
+
+    const std::vector<std::pair<size_t, size_t>> runs = {
+        {0, 7}, {3, 0}, {13, 64}, {100, 1}, {101, 250}, {499, 1}, {200, 33},
+    };
+    std::vector<Token> expected;
+    Store dst;
+    dst.bit_width = bits;
+    {
+        BitWriter w(dst);
+        for (auto [first, count] : runs) {
+            w.write(max_token(bits));
+            expected.push_back(max_token(bits));
+            w.write_run(src.packed.data(), first, count);
+            expected.insert(expected.end(), src_tokens.begin() + first,
+                            src_tokens.begin() + first + count);
+        }
+        EXPECT_EQ(w.tokens_written(), expected.size());
+    }
+
+    Store ref;
+    ref.bit_width = bits;
+    { BitWriter w(ref); for (Token t : expected) w.write(t); }
+    EXPECT_EQ(dst.packed, ref.packed);
+}
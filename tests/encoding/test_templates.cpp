@@ -0,0 +1,92 @@
+#include <onpair/encoding/training/templates.h>
+#include <onpair/core/dictionary.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace onpair;
+using namespace onpair::encoding;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static TemplateSet mine(const std::vector<std::string>& strings,
+                        const TemplateConfig& cfg = {})
+{
+    auto raw = make_raw(strings);
+    return mine_templates(raw.data.data(), raw.offsets.data(), raw.n, cfg);
+}
+
+static std::string format(const TemplateSet& ts, uint32_t t, const uint64_t* v) {
+    std::string out(ts.max_length(t), '\0');
+    out.resize(ts.format(t, v, out.data()));
+    return out;
+}
+
+// ── Mining ────────────────────────────────────────────────────────────────────
+
+TEST(TemplatesTest, MinesFixedAndVariableFields) {
+    std::vector<std::string> rows;
+    for (int i = 0; i < 600; ++i) {
+        char buf[32];
+        std::snprintf(buf, sizeof buf, "ORD-%d-%07d", 2020 + i % 5, i * 37);
+        rows.push_back(buf);
+        rows.push_back("item_" + std::to_string(i * 13));
+        rows.push_back("free text without digits");
+    }
+    const TemplateSet ts = mine(rows);
+    ASSERT_EQ(ts.size(), 2u);
+    EXPECT_EQ(ts[0].pattern(), "ORD-{4}-{7}");   // ties break on the literal key
+    EXPECT_EQ(ts[1].pattern(), "item_{}");
+}
+
+TEST(TemplatesTest, MinFractionAndMaxTemplates) {
+    std::vector<std::string> rows;
+    for (int i = 0; i < 1000; ++i) rows.push_back("a" + std::to_string(i));
+    for (int i = 0; i < 5; ++i)    rows.push_back("rare" + std::to_string(i));
+    for (int i = 0; i < 100; ++i)  rows.push_back("b" + std::to_string(i) + "c");
+
+    EXPECT_EQ(mine(rows).size(), 2u);
+    TemplateConfig one;
+    one.max_templates = 1;
+    const TemplateSet ts = mine(rows, one);
+    ASSERT_EQ(ts.size(), 1u);
+    EXPECT_EQ(ts[0].pattern(), "a{}");
+    TemplateConfig none;
+    none.max_templates = 0;
+    EXPECT_TRUE(mine(rows, none).empty());
+}
+
+TEST(TemplatesTest, LeadingZerosFixTheModalWidth) {
+    std::vector<std::string> rows;
+    for (int i = 0; i < 100; ++i) rows.push_back("k" + std::string(i % 10 ? "0" : "") + "12");
+    const TemplateSet ts = mine(rows);
+    ASSERT_EQ(ts.size(), 1u);
+    EXPECT_EQ(ts[0].pattern(), "k{3}");
+}
+
+// ── Matching ──────────────────────────────────────────────────────────────────
+
+TEST(TemplatesTest, MatchFormatRoundTrip) {
+    TemplateSet ts({Template{{"user_", ""}, {6}},
+                    Template{{"v", ".", ".", ""}, {0, 0, 0}}});
+    uint64_t v[MAX_TEMPLATE_FIELDS];
+
+    ASSERT_EQ(ts.match("user_000042", v), 0u);
+    EXPECT_EQ(v[0], 42u);
+    EXPECT_EQ(format(ts, 0, v), "user_000042");
+
+    ASSERT_EQ(ts.match("v1.20.3", v), 1u);
+    EXPECT_EQ(format(ts, 1, v), "v1.20.3");
+    ASSERT_EQ(ts.match("v0.0.9999999999999999999", v), 1u);
+    EXPECT_EQ(v[2], 9999999999999999999u);
+    EXPECT_EQ(format(ts, 1, v), "v0.0.9999999999999999999");
+
+    EXPECT_EQ(ts.match("user_42", v),      TemplateSet::NO_MATCH);   // wrong width
+    EXPECT_EQ(ts.match("v01.2.3", v),      TemplateSet::NO_MATCH);   // leading zero
+    EXPECT_EQ(ts.match("v1.2", v),         TemplateSet::NO_MATCH);   // other literals
+    EXPECT_EQ(ts.match("user_", v),        TemplateSet::NO_MATCH);
+    EXPECT_EQ(ts.match("v1.2.99999999999999999999", v), TemplateSet::NO_MATCH);
+}
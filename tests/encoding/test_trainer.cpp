@@ -4,6 +4,8 @@
 #include "corpus.h"
 #include <algorithm>
 #include <cstring>
+#include <random>
+#include <string>
 
 using namespace onpair;
 using namespace onpair::encoding;
@@ -336,3 +338,103 @@ TEST(TrainerTest, AllBitWidthsProduceValidDictionary) {
             << "overflow for bits=" << b;
     }
 }
+
+// ── Refinement passes ─────────────────────────────────────────────────────────
+
+// Greedy parse of every string with the trained matcher; the tokens must
+// spell the input back.
+static size_t parse_tokens(const TrainResult& r, const std::vector<std::string>& strings)
+{
+    size_t tokens = 0;
+    for (const auto& s : strings) {
+        const auto* p = reinterpret_cast<const uint8_t*>(s.data());
+        std::string back;
+        for (size_t pos = 0; pos < s.size(); ++tokens) {
+            const auto [id, len] = r.lpm.find_longest_match(p + pos, s.size() - pos);
+            back.append(reinterpret_cast<const char*>(r.dict.bytes.data()) + r.dict.offsets[id],
+                        r.dict.offsets[id + 1] - r.dict.offsets[id]);
+            pos += len;
+        }
+        EXPECT_EQ(back, s);
+    }
+    return tokens;
+}
+
+// Short path-like strings built from a small vocabulary: the merge scan
+// leaves many half-formed tokens for refinement to replace.
+static std::vector<std::string> make_path_strings(int n, uint64_t seed)
+{
+    static const char* words[] = {"https://", "www.", "example", ".com/", "user",
+                                  "?id=", "&q=", "index", ".html", "api/v2/"};
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> out;
+    for (int i = 0; i < n; ++i) {
+        std::string s;
+        for (int k = 2 + int(rng() % 4); k > 0; --k) {
+            s += words[rng() % 10];
+            s += std::to_string(rng() % 1000);
+        }
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+TEST(TrainerTest, RefinementKeepsDictionaryValid) {
+    for (int b : {9, 12, 16}) {
+        TrainingConfig cfg;
+        cfg.bits          = static_cast<BitWidth>(b);
+        cfg.seed          = 42;
+        cfg.refine_passes = 3;
+        const auto corpus = make_path_strings(3000, 1);
+        auto result = train_strings(corpus, cfg);
+        check_base_tokens(result.dict);
+        EXPECT_TRUE(is_lex_sorted(result.dict)) << "bits=" << b;
+        EXPECT_LE(result.dict.num_tokens(), max_dict_size(cfg.bits)) << "bits=" << b;
+        for (size_t i = 1; i < result.dict.num_tokens(); ++i) {
+            const size_t la = result.dict.offsets[i] - result.dict.offsets[i - 1];
+            const size_t lb = result.dict.offsets[i + 1] - result.dict.offsets[i];
+            ASSERT_LE(lb, MAX_TOKEN_SIZE);
+            ASSERT_FALSE(la == lb && std::memcmp(result.dict.bytes.data() + result.dict.offsets[i - 1],
+                                                 result.dict.bytes.data() + result.dict.offsets[i],
+                                                 la) == 0)
+                << "duplicate token at " << i;
+        }
+        parse_tokens(result, corpus);
+    }
+}
+
+TEST(TrainerTest, RefinementDoesNotAddTokensPerRow) {
+    const auto corpus = make_path_strings(20000, 3);
+    TrainingConfig cfg;
+    cfg.bits = 12;
+    cfg.seed = 42;
+    const size_t single = parse_tokens(train_strings(corpus, cfg), corpus);
+    cfg.refine_passes = 2;
+    const size_t refined = parse_tokens(train_strings(corpus, cfg), corpus);
+    EXPECT_LE(refined, single);
+}
+
+TEST(TrainerTest, RefinementFillsFreeSlots) {
+    // A high fixed threshold leaves most of the dictionary empty.
+    const auto corpus = make_path_strings(2000, 5);
+    TrainingConfig cfg;
+    cfg.threshold = FixedThreshold{200};
+    cfg.seed      = 42;
+    const size_t before = train_strings(corpus, cfg).dict.num_tokens();
+    cfg.refine_passes = 1;
+    const TrainResult after = train_strings(corpus, cfg);
+    EXPECT_GT(after.dict.num_tokens(), before);
+    parse_tokens(after, corpus);
+}
+
+TEST(TrainerTest, RefinementIsReproducibleWithSeed) {
+    const auto corpus = make_path_strings(3000, 7);
+    TrainingConfig cfg;
+    cfg.bits          = 11;
+    cfg.seed          = 9;
+    cfg.refine_passes = 2;
+    const auto a = train_strings(corpus, cfg);
+    const auto b = train_strings(corpus, cfg);
+    EXPECT_EQ(a.dict.bytes, b.dict.bytes);
+    EXPECT_EQ(a.dict.offsets, b.dict.offsets);
+}
@@ -0,0 +1,149 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::vector<std::string> decode_rows(const op::OnPairColumnView& v) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < v.num_strings(); ++i)
+        out.emplace_back(buf.data(), v.decompress(i, buf.data()));
+    return out;
+}
+
+using Order = op::ColumnBuilder::Order;
+
+// ── Relaxed order ─────────────────────────────────────────────────────────────
+
+TEST(ColumnBuilderTest, SingleProducerMatchesCompressWith) {
+    const auto train = make_random_strings(3000, 40, 1);
+    const auto rows  = make_random_strings(20000, 40, 2);   // several stages
+    const auto ref   = make_column(train);
+
+    op::ColumnBuilder b(ref, Order::Relaxed);
+    auto p = b.producer();
+    for (const auto& r : rows) p.add(r);
+    const auto col = b.seal();
+
+    const auto expect = op::OnPairColumn::compress_with(ref, rows);
+    EXPECT_TRUE(col.shares_dictionary_with(ref));
+    EXPECT_EQ(col.bytes_used(), expect.bytes_used());
+    EXPECT_EQ(decode_rows(col.view()), rows);
+    EXPECT_FALSE(col.has_nulls());
+    EXPECT_DOUBLE_EQ(col.drift().baseline().rows, double(rows.size()));
+}
+
+TEST(ColumnBuilderTest, RelaxedKeepsEachProducersRowsTogether) {
+    const auto ref = make_column(make_user_strings(2000));
+    op::ColumnBuilder b(ref, Order::Relaxed);
+
+    constexpr int T = 4, N = 5000;
+    std::vector<op::ColumnBuilder::Producer> producers;
+    for (int t = 0; t < T; ++t) producers.push_back(b.producer());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < T; ++t)
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < N; ++i)
+                producers[t].add("t" + std::to_string(t) + "_user_" + std::to_string(i));
+        });
+    for (auto& th : threads) th.join();
+
+    const auto got = decode_rows(b.seal().view());
+    ASSERT_EQ(got.size(), size_t(T * N));
+    for (int t = 0; t < T; ++t)
+        for (int i = 0; i < N; ++i)
+            ASSERT_EQ(got[size_t(t * N + i)],
+                      "t" + std::to_string(t) + "_user_" + std::to_string(i));
+}
+
+// ── Preserved order ───────────────────────────────────────────────────────────
+
+TEST(ColumnBuilderTest, SequenceNumbersRestoreOrder) {
+    const auto rows = make_mixed_length_strings(30000, 200, 3);
+    const auto ref  = make_column(make_mixed_length_strings(2000, 200, 4));
+    op::ColumnBuilder b(ref);
+    EXPECT_EQ(b.order(), Order::Preserve);
+
+    // Rows are dealt round-robin in chunks of 7, so runs are short.
+    constexpr size_t T = 4;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < T; ++t)
+        threads.emplace_back([&, t] {
+            auto p = b.producer();
+            for (size_t i = 0; i < rows.size(); ++i)
+                if ((i / 7) % T == t) p.add(i, rows[i]);
+        });
+    for (auto& th : threads) th.join();
+
+    const auto col = b.seal();
+    EXPECT_EQ(decode_rows(col.view()), rows);
+    EXPECT_EQ(col.bytes_used(), op::OnPairColumn::compress_with(ref, rows).bytes_used());
+}
+
+TEST(ColumnBuilderTest, NullsAndGapsInSequence) {
+    const auto ref = make_column(make_user_strings(500));
+    op::ColumnBuilder b(ref);
+    auto p = b.producer();
+    auto q = b.producer();
+    p.add(100, "user_000100");
+    q.add_null(50);
+    q.add(10, "user_000010");
+    p.add_null(1000);
+    p.add(500, "");
+
+    auto col = b.seal();
+    ASSERT_EQ(col.num_strings(), 5u);
+    EXPECT_EQ(col.null_count(), 2u);
+    const auto v = col.view();
+    EXPECT_EQ(decode_rows(v), (std::vector<std::string>{"user_000010", "", "user_000100", "", ""}));
+    EXPECT_TRUE(v.is_valid(0));
+    EXPECT_FALSE(v.is_valid(1));
+    EXPECT_TRUE(v.is_valid(3));
+    EXPECT_FALSE(v.is_valid(4));
+    EXPECT_EQ(v.starts_with("user_0001"), (std::vector<size_t>{2}));
+
+    // The sealed column appends with the builder's matcher.
+    col.append(std::vector<std::string>{"user_000007"});
+    EXPECT_EQ(decode_rows(col.view()).back(), "user_000007");
+}
+
+// ── Misuse ────────────────────────────────────────────────────────────────────
+
+TEST(ColumnBuilderTest, Misuse) {
+    EXPECT_THROW(op::ColumnBuilder(op::OnPairColumn()), std::logic_error);
+
+    const auto ref = make_column(make_user_strings(100));
+    op::ColumnBuilder ordered(ref, Order::Preserve);
+    op::ColumnBuilder relaxed(ref, Order::Relaxed);
+    auto po = ordered.producer();
+    auto pr = relaxed.producer();
+    EXPECT_THROW(po.add("x"), std::logic_error);
+    EXPECT_THROW(po.add_null(), std::logic_error);
+    EXPECT_THROW(pr.add(1, "x"), std::logic_error);
+    EXPECT_THROW(pr.add_null(1), std::logic_error);
+
+    po.add(3, "a");
+    po.add(3, "b");
+    EXPECT_THROW(ordered.seal(), std::invalid_argument);
+    EXPECT_EQ(ordered.seal().num_strings(), 0u);   // reset by the failed seal
+    EXPECT_EQ(relaxed.seal().num_strings(), 0u);
+}
@@ -0,0 +1,113 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+#include "assertions.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+namespace {
+
+std::string serialize(const op::OnPairColumn& col) {
+    std::ostringstream oss;
+    col.write_to(oss);
+    return oss.str();
+}
+
+op::OnPairColumn deserialize(const std::string& data,
+                             const std::shared_ptr<const op::Dictionary>& shared = nullptr) {
+    std::istringstream iss(data);
+    return op::OnPairColumn::read_from(iss, shared);
+}
+
+} // namespace
+
+TEST(CompactDictionaryColumnTest, MetadataDoesNotExpand) {
+    auto strings = make_random_strings(400, 40, 7);
+    auto col = op::OnPairColumn::compress(strings);
+    const size_t   before = col.bytes_used();
+    const op::BitWidth bits = col.bits();
+
+    col.compact_dictionary();
+    EXPECT_TRUE(col.has_compact_dictionary());
+    EXPECT_FALSE(col.dictionary_expanded());
+    EXPECT_EQ(col.num_strings(), strings.size());
+    EXPECT_EQ(col.bits(), bits);
+    EXPECT_EQ(col.null_count(), 0u);
+    EXPECT_EQ(col.deleted_count(), 0u);
+    EXPECT_LT(col.bytes_used(), before);
+    EXPECT_FALSE(col.dictionary_expanded());
+}
+
+TEST(CompactDictionaryColumnTest, DecodingExpandsAndRecompactingDrops) {
+    auto strings = make_user_strings(300);
+    auto col = op::OnPairColumn::compress(strings);
+    col.compact_dictionary();
+
+    EXPECT_ROUNDTRIP_OK(strings, col);
+    EXPECT_TRUE(col.dictionary_expanded());
+    EXPECT_EQ(col.view().equals(strings[42]), std::vector<size_t>{42});
+
+    col.compact_dictionary();
+    EXPECT_FALSE(col.dictionary_expanded());
+    EXPECT_ROUNDTRIP_OK(strings, col);
+}
+
+TEST(CompactDictionaryColumnTest, AppendAfterCompacting) {
+    auto strings = make_user_strings(200);
+    auto col = op::OnPairColumn::compress(strings);
+    col.compact_dictionary();
+
+    const std::vector<std::string> more = {"user_000200", "user_000201"};
+    col.append(more);
+    strings.insert(strings.end(), more.begin(), more.end());
+    EXPECT_TRUE(col.has_compact_dictionary());
+    EXPECT_ROUNDTRIP_OK(strings, col);
+}
+
+TEST(CompactDictionaryColumnTest, WritesAndLoadsCompact) {
+    auto strings = make_random_strings(300, 30, 11);
+    auto col = op::OnPairColumn::compress(strings);
+    const std::string flat = serialize(col);
+
+    col.compact_dictionary();
+    col.erase(3);
+    const std::string blob = serialize(col);
+    EXPECT_EQ(blob.substr(0, 8), "ONPAIR03");
+    EXPECT_LT(blob.size(), flat.size());
+    EXPECT_FALSE(col.dictionary_expanded());
+
+    auto loaded = deserialize(blob);
+    EXPECT_TRUE(loaded.has_compact_dictionary());
+    EXPECT_FALSE(loaded.dictionary_expanded());
+    EXPECT_EQ(loaded.deleted_count(), 1u);
+    EXPECT_EQ(loaded.bytes_used(), col.bytes_used());
+
+    std::vector<char> buf(16 + op::DECOMPRESS_BUFFER_PADDING + 64);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        if (i == 3) continue;
+        const size_t len = loaded.view().decompress(i, buf.data());
+        ASSERT_EQ(std::string(buf.data(), len), strings[i]) << i;
+    }
+}
+
+TEST(CompactDictionaryColumnTest, LoadingCompactFileSharesAnEqualDictionary) {
+    auto cols = op::OnPairColumn::compress_shared(
+        std::vector<std::vector<std::string>>{make_user_strings(100), make_user_strings(50)});
+    const auto shared = cols[0].shared_dictionary();
+    cols[1].compact_dictionary();
+
+    auto loaded = deserialize(serialize(cols[1]), shared);
+    EXPECT_FALSE(loaded.has_compact_dictionary());
+    EXPECT_TRUE(loaded.shares_dictionary_with(cols[0]));
+}
+
+TEST(CompactDictionaryColumnTest, DefaultColumnIsUnaffected) {
+    op::OnPairColumn col;
+    col.compact_dictionary();
+    EXPECT_FALSE(col.has_compact_dictionary());
+    EXPECT_EQ(col.num_strings(), 0u);
+}
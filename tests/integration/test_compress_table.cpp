@@ -0,0 +1,168 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::encoding::TrainingConfig make_config(op::BitWidth bits = 14) {
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return cfg;
+}
+
+static std::vector<std::string> decode_rows(const op::OnPairColumnView& v) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < v.num_strings(); ++i)
+        out.emplace_back(buf.data(), v.decompress(i, buf.data()));
+    return out;
+}
+
+// Owns the Arrow buffers behind a set of TableColumns.  Moving a RawStrings
+// keeps its buffers, so earlier columns stay valid as more are added.
+struct Table {
+    std::vector<std::vector<std::string>> values;
+    std::vector<RawStrings>               raw;
+    std::vector<op::TableColumn>          columns;
+
+    void add(std::vector<std::string> v, int group = op::TableColumn::NO_GROUP) {
+        values.push_back(std::move(v));
+        raw.push_back(make_raw(values.back()));
+        columns.push_back({reinterpret_cast<const char*>(raw.back().data.data()),
+                           raw.back().offsets.data(), values.back().size(), nullptr,
+                           group});
+    }
+};
+
+static Table mixed_table() {
+    Table t;
+    t.add(make_user_strings(20000));
+    t.add(make_random_strings(300, 20, 1));
+    t.add(make_mixed_length_strings(5000, 300, 2));
+    t.add({});
+    t.add(make_random_strings(8000, 40, 3));
+    return t;
+}
+
+// ── Tests ─────────────────────────────────────────────────────────────────────
+
+TEST(CompressTableTest, MatchesSerialCompress) {
+    const Table t = mixed_table();
+    std::vector<op::encoding::TrainingConfig> cfgs;
+    for (size_t k = 0; k < t.columns.size(); ++k) cfgs.push_back(make_config(10 + k));
+
+    op::TableOptions opts;
+    opts.threads = 4;
+    const auto cols = op::OnPairColumn::compress_table(t.columns, cfgs, opts);
+    ASSERT_EQ(cols.size(), t.columns.size());
+    for (size_t k = 0; k < cols.size(); ++k) {
+        const auto serial = op::OnPairColumn::compress(t.values[k], cfgs[k]);
+        EXPECT_EQ(cols[k].bits(), cfgs[k].bits) << k;
+        EXPECT_EQ(cols[k].bytes_used(), serial.bytes_used()) << k;
+        EXPECT_EQ(decode_rows(cols[k].view()), t.values[k]) << k;
+    }
+}
+
+TEST(CompressTableTest, OneConfigForAllAndValidity) {
+    Table t = mixed_table();
+    std::vector<uint8_t> validity((t.values[0].size() + 7) / 8, 0xFF);
+    validity[3] = 0x00;                                   // rows 24..31 null
+    t.columns[0].validity = validity.data();
+
+    const auto cfg  = make_config();
+    const auto cols = op::OnPairColumn::compress_table(
+        t.columns, std::span<const op::encoding::TrainingConfig>(&cfg, 1));
+    EXPECT_EQ(cols[0].null_count(), 8u);
+    for (size_t k = 0; k < cols.size(); ++k) {
+        EXPECT_EQ(cols[k].bits(), 14);
+        const auto rows = decode_rows(cols[k].view());
+        for (size_t i = 0; i < rows.size(); ++i)
+            EXPECT_EQ(rows[i], cols[k].view().is_valid(i) ? t.values[k][i] : "");
+    }
+}
+
+TEST(CompressTableTest, SharedGroupsTrainOnce) {
+    Table t;
+    t.add(make_user_strings(3000), 7);
+    t.add(make_random_strings(1000, 30, 4));
+    t.add(make_user_strings(500), 7);
+    t.add(make_random_strings(2000, 30, 5), 2);
+    t.add(make_random_strings(2000, 30, 6), 2);
+
+    const auto cfg  = make_config(12);
+    const auto cols = op::OnPairColumn::compress_table(
+        t.columns, std::span<const op::encoding::TrainingConfig>(&cfg, 1));
+    EXPECT_TRUE(cols[0].shares_dictionary_with(cols[2]));
+    EXPECT_TRUE(cols[3].shares_dictionary_with(cols[4]));
+    EXPECT_FALSE(cols[0].shares_dictionary_with(cols[3]));
+    EXPECT_FALSE(cols[1].shares_dictionary_with(cols[0]));
+    for (size_t k = 0; k < cols.size(); ++k)
+        EXPECT_EQ(decode_rows(cols[k].view()), t.values[k]) << k;
+
+    const auto shared = op::OnPairColumn::compress_shared(
+        std::vector<std::vector<std::string>>{t.values[0], t.values[2]}, cfg);
+    EXPECT_EQ(cols[0].bytes_used(), shared[0].bytes_used());
+    EXPECT_EQ(cols[2].bytes_used(), shared[1].bytes_used());
+}
+
+TEST(CompressTableTest, RunsOnExecutor) {
+    const Table t = mixed_table();
+    const auto  cfg = make_config();
+    std::vector<std::thread> pool;
+    std::atomic<size_t> submitted{0};
+    const op::TableExecutor executor = [&](std::function<void()> task) {
+        ++submitted;
+        pool.emplace_back(std::move(task));
+    };
+
+    op::TableOptions opts;
+    opts.threads = 3;
+    const auto cols = op::OnPairColumn::compress_table(
+        t.columns, std::span<const op::encoding::TrainingConfig>(&cfg, 1), executor, opts);
+    for (auto& th : pool) th.join();
+    EXPECT_EQ(submitted.load(), 2u);
+    for (size_t k = 0; k < cols.size(); ++k)
+        EXPECT_EQ(decode_rows(cols[k].view()), t.values[k]) << k;
+}
+
+// An executor that refuses work leaves everything to the calling thread.
+TEST(CompressTableTest, RefusingExecutorAndTightBudget) {
+    const Table t = mixed_table();
+    const auto  cfg = make_config();
+    const op::TableExecutor refuse = [](std::function<void()>) {
+        throw std::runtime_error("full");
+    };
+    op::TableOptions opts;
+    opts.threads       = 8;
+    opts.memory_budget = 1;   // every job runs alone
+    const auto cols = op::OnPairColumn::compress_table(
+        t.columns, std::span<const op::encoding::TrainingConfig>(&cfg, 1), refuse, opts);
+    for (size_t k = 0; k < cols.size(); ++k)
+        EXPECT_EQ(decode_rows(cols[k].view()), t.values[k]) << k;
+
+    const auto own = op::OnPairColumn::compress_table(
+        t.columns, std::span<const op::encoding::TrainingConfig>(&cfg, 1), opts);
+    for (size_t k = 0; k < own.size(); ++k)
+        EXPECT_EQ(own[k].bytes_used(), cols[k].bytes_used()) << k;
+}
+
+TEST(CompressTableTest, EmptyTableAndConfigCount) {
+    const auto cfg = make_config();
+    const std::span<const op::encoding::TrainingConfig> one(&cfg, 1);
+    EXPECT_TRUE(op::OnPairColumn::compress_table({}, one).empty());
+
+    const Table t = mixed_table();
+    const std::vector<op::encoding::TrainingConfig> two(2, cfg);
+    EXPECT_THROW(op::OnPairColumn::compress_table(t.columns, two), std::invalid_argument);
+}
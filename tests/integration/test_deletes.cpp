@@ -0,0 +1,228 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::vector<std::string> decode_rows(const op::OnPairColumnView& v) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < v.num_strings(); ++i)
+        out.emplace_back(buf.data(), v.decompress(i, buf.data()));
+    return out;
+}
+
+// Rows 0, 5, 10, ... plus a block of 70 consecutive rows (a whole word).
+static std::vector<size_t> victims(size_t n) {
+    std::vector<size_t> rows;
+    for (size_t i = 0; i < n; i += 5) rows.push_back(i);
+    for (size_t i = 128; i < std::min<size_t>(n, 198); ++i) rows.push_back(i);
+    return rows;
+}
+
+static std::vector<size_t> matching(const std::vector<std::string>& data,
+                                    const std::set<size_t>& gone,
+                                    std::string_view needle)
+{
+    std::vector<size_t> out;
+    for (size_t i = 0; i < data.size(); ++i)
+        if (!gone.count(i) && data[i].find(needle) != std::string::npos)
+            out.push_back(i);
+    return out;
+}
+
+// ── Erase ─────────────────────────────────────────────────────────────────────
+
+TEST(DeletesTest, EraseMarksRows) {
+    auto col = make_column(make_user_strings(100));
+    EXPECT_FALSE(col.has_deletions());
+    col.erase(3);
+    const std::vector<size_t> more = {7, 3, 99};
+    col.erase(more);
+    EXPECT_TRUE(col.has_deletions());
+    EXPECT_EQ(col.deleted_count(), 3u);
+    EXPECT_TRUE(col.view().is_deleted(99));
+    EXPECT_FALSE(col.view().is_deleted(98));
+    EXPECT_THROW(col.erase(100), std::out_of_range);
+}
+
+class DeletesScanTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, DeletesScanTest,
+    testing::Values(9, 12, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(DeletesScanTest, ScansSkipDeletedRows) {
+    auto data = make_random_strings(600, 30, 17);
+    auto col = make_column(data, static_cast<op::BitWidth>(GetParam()));
+    const auto rows = victims(data.size());
+    col.erase(rows);
+    const std::set<size_t> gone(rows.begin(), rows.end());
+    auto v = col.view();
+    const auto dv = v.dictionary();
+
+    EXPECT_EQ(v.contains("ab"), matching(data, gone, "ab"));
+    EXPECT_EQ(v.contains("a"), matching(data, gone, "a"));
+    EXPECT_EQ(v.contains_bytes("ab"), matching(data, gone, "ab"));
+    EXPECT_EQ(v.starts_with(""), matching(data, gone, ""));
+    EXPECT_EQ(v.scan_blocked(search::KmpAutomaton("ab", dv)), matching(data, gone, "ab"));
+    EXPECT_EQ(v.scan_interleaved(search::KmpAutomaton("ab", dv)), matching(data, gone, "ab"));
+    EXPECT_TRUE(v.equals(data[0]).empty() ||
+                std::ranges::none_of(v.equals(data[0]), [&](size_t i) { return gone.count(i); }));
+}
+
+TEST(DeletesTest, DecodersHideDeletedRows) {
+    auto data = make_user_strings(300);
+    auto col = make_column(data);
+    const auto rows = victims(data.size());
+    col.erase(rows);
+    const std::set<size_t> gone(rows.begin(), rows.end());
+    auto v = col.view();
+
+    const auto decoded = decode_rows(v);
+    for (size_t i = 0; i < data.size(); ++i)
+        EXPECT_EQ(decoded[i], gone.count(i) ? "" : data[i]) << i;
+
+    // One slot per row, deleted slots empty and marked null.
+    std::vector<char>     buf(300 * 16 + op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offsets(301);
+    std::vector<uint8_t>  validity((300 + 7) / 8);
+    const size_t total = v.decompress_all(buf.data(), offsets.data(), validity.data());
+    std::string flat;
+    for (size_t i = 0; i < data.size(); ++i) {
+        const std::string got(buf.data() + offsets[i], offsets[i + 1] - offsets[i]);
+        EXPECT_EQ(got, gone.count(i) ? "" : data[i]) << i;
+        EXPECT_EQ(bool((validity[i / 8] >> (i % 8)) & 1), !gone.count(i)) << i;
+        if (!gone.count(i)) flat += data[i];
+    }
+    EXPECT_EQ(total, flat.size());
+
+    // Flat output without offsets simply omits deleted rows.
+    std::vector<char> flat_buf(300 * 16 + op::DECOMPRESS_BUFFER_PADDING);
+    const size_t len = v.decompress_all(flat_buf.data());
+    EXPECT_EQ(std::string(flat_buf.data(), len), flat);
+}
+
+// ── Compaction ────────────────────────────────────────────────────────────────
+
+TEST_P(DeletesScanTest, CompactDropsRowsWithoutReencoding) {
+    auto data = make_mixed_length_strings(700, 300, 4);
+    auto col = make_column(data, static_cast<op::BitWidth>(GetParam()));
+    const auto dict_tokens = col.view().dictionary().num_tokens();
+    const auto rows = victims(data.size());
+    col.erase(rows);
+    const std::set<size_t> gone(rows.begin(), rows.end());
+
+    // Token sequences of the surviving rows, before compaction.
+    auto tokens_of = [](const op::OnPairColumnView& v, size_t i) {
+        std::vector<op::Token> out;
+        op::dispatch_bits(v.bits(), [&](auto b) {
+            op::decoding::TokenCursor<b.value> cur(v.store().packed_data(),
+                                                   v.store().string_span(i));
+            while (cur.has_more()) out.push_back(cur.next());
+        });
+        return out;
+    };
+    std::vector<std::vector<op::Token>> before;
+    std::vector<std::string> survivors;
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (gone.count(i)) continue;
+        before.push_back(tokens_of(col.view(), i));
+        survivors.push_back(data[i]);
+    }
+
+    col.compact();
+    auto v = col.view();
+    EXPECT_FALSE(col.has_deletions());
+    EXPECT_EQ(v.num_strings(), survivors.size());
+    EXPECT_EQ(v.dictionary().num_tokens(), dict_tokens);
+    EXPECT_EQ(decode_rows(v), survivors);
+    for (size_t i = 0; i < survivors.size(); ++i)
+        ASSERT_EQ(tokens_of(v, i), before[i]) << i;
+    EXPECT_EQ(v.equals(survivors[3]).front(), 3u);
+}
+
+TEST(DeletesTest, CompactKeepsValidityAndDropsStatistics) {
+    const std::string bytes = "aabbccddee";
+    const uint32_t offsets[6] = {0, 2, 4, 6, 8, 10};
+    const uint8_t  valid = 0b11011;   // row 2 null
+    op::encoding::TrainingConfig cfg;
+    cfg.collect_statistics = true;
+    auto col = op::OnPairColumn::compress(bytes.data(), offsets, 5, &valid, cfg);
+    col.erase(0);
+    col.compact();
+
+    EXPECT_EQ(col.statistics(), nullptr);
+    EXPECT_EQ(col.num_strings(), 4u);
+    EXPECT_EQ(col.null_count(), 1u);
+    EXPECT_FALSE(col.view().is_valid(1));
+    EXPECT_EQ(decode_rows(col.view()), (std::vector<std::string>{"bb", "", "dd", "ee"}));
+
+    // Erasing the only null row drops the bitmap altogether.
+    col.erase(1);
+    col.compact();
+    EXPECT_FALSE(col.has_nulls());
+}
+
+TEST(DeletesTest, CompactEverythingAndNothing) {
+    auto data = make_user_strings(40);
+    auto col = make_column(data);
+    col.compact();                              // no deletions: no-op
+    EXPECT_EQ(decode_rows(col.view()), data);
+
+    std::vector<size_t> all(40);
+    for (size_t i = 0; i < 40; ++i) all[i] = i;
+    col.erase(all);
+    EXPECT_TRUE(col.view().contains("user").empty());
+    col.compact();
+    EXPECT_EQ(col.num_strings(), 0u);
+    EXPECT_TRUE(col.view().contains("user").empty());
+}
+
+// ── Persistence and merging ───────────────────────────────────────────────────
+
+TEST(DeletesTest, DeletionsSurviveSerialization) {
+    auto data = make_user_strings(200);
+    auto col = make_column(data);
+    col.erase(victims(data.size()));
+
+    std::stringstream ss;
+    col.write_to(ss);
+    auto back = op::OnPairColumn::read_from(ss);
+    EXPECT_EQ(back.deleted_count(), col.deleted_count());
+    EXPECT_EQ(back.view().contains("user"), col.view().contains("user"));
+}
+
+TEST(DeletesTest, MergeDropsDeletedRows) {
+    auto a = make_user_strings(50);
+    auto b = make_random_strings(50, 20, 6);
+    auto ca = make_column(a), cb = make_column(b);
+    ca.erase(0);
+    cb.erase(49);
+    const std::vector<op::OnPairColumnView> sources = {ca.view(), cb.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+
+    std::vector<std::string> expected(a.begin() + 1, a.end());
+    expected.insert(expected.end(), b.begin(), b.end() - 1);
+    EXPECT_EQ(decode_rows(merged.view()), expected);
+    EXPECT_FALSE(merged.has_deletions());
+}
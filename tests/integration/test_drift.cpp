@@ -0,0 +1,354 @@
+#include <onpair/api.h>
+#include <onpair/encoding/parsing/parser.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::encoding::TrainingConfig make_config(op::BitWidth bits = 14) {
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return cfg;
+}
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    return op::OnPairColumn::compress(strings, make_config(bits));
+}
+
+static std::vector<std::string> decode_rows(const op::OnPairColumnView& v) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < v.num_strings(); ++i)
+        out.emplace_back(buf.data(), v.decompress(i, buf.data()));
+    return out;
+}
+
+static std::vector<std::string> concat(std::vector<std::string> a,
+                                       const std::vector<std::string>& b)
+{
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+// The store parse() produces for `strings` under `v`'s dictionary.
+static op::Store reparse(const op::OnPairColumnView& v,
+                         const std::vector<std::string>& strings)
+{
+    const auto raw = make_raw(strings);
+    const auto lpm = op::encoding::LongestPrefixMatcher::from_dictionary(v.dictionary());
+    op::Store store;
+    op::encoding::parse(raw.data.data(), raw.offsets.data(), strings.size(),
+                        lpm, v.bits(), store);
+    return store;
+}
+
+static void expect_same_tokens(const op::OnPairColumnView& v, const op::Store& ref) {
+    const auto sv = v.store();
+    ASSERT_EQ(sv.num_tokens(), ref.num_tokens());
+    ASSERT_EQ(sv.num_strings(), ref.num_strings());
+    for (size_t i = 0; i <= ref.num_strings(); ++i)
+        ASSERT_EQ(sv.boundaries()[i], ref.boundaries[i]) << "row " << i;
+    const size_t bits = ref.num_tokens() * ref.bit_width;
+    for (size_t w = 0; w < bits / 64; ++w)
+        ASSERT_EQ(sv.packed_data()[w], ref.packed[w]) << "word " << w;
+    if (bits % 64) {
+        const uint64_t mask = (uint64_t(1) << (bits % 64)) - 1;
+        EXPECT_EQ(sv.packed_data()[bits / 64] & mask, ref.packed[bits / 64] & mask);
+    }
+}
+
+// Rows drawn from `pool` in a scrambled order.
+static std::vector<std::string> resample(const std::vector<std::string>& pool,
+                                         size_t n, size_t seed)
+{
+    std::vector<std::string> out;
+    for (size_t i = 0; i < n; ++i)
+        out.push_back(pool[(i * 7919 + seed) % pool.size()]);
+    return out;
+}
+
+// ── DriftMonitor ──────────────────────────────────────────────────────────────
+
+TEST(DriftMonitorTest, DefaultHasNoBaseline) {
+    op::DriftMonitor m;
+    EXPECT_FALSE(m.has_baseline());
+    m.observe(100000, 100000, 100000);
+    EXPECT_FALSE(m.retrain_recommended());
+    EXPECT_DOUBLE_EQ(m.bytes_per_token_ratio(), 1.0);
+}
+
+TEST(DriftMonitorTest, RatiosAgainstBaseline) {
+    op::DriftMonitor m({1000, 8000, 2000});          // 4 bytes/token, 2 tokens/row
+    EXPECT_DOUBLE_EQ(m.baseline().bytes_per_token(), 4.0);
+    EXPECT_DOUBLE_EQ(m.baseline().tokens_per_row(), 2.0);
+    EXPECT_DOUBLE_EQ(m.bytes_per_token_ratio(), 1.0);   // nothing observed yet
+
+    m.observe(10, 60, 30);                           // 2 bytes/token, 3 tokens/row
+    EXPECT_DOUBLE_EQ(m.bytes_per_token_ratio(), 0.5);
+    EXPECT_DOUBLE_EQ(m.tokens_per_row_ratio(), 1.5);
+    EXPECT_EQ(m.observed_rows(), 10u);
+}
+
+TEST(DriftMonitorTest, RecommendationNeedsMinRows) {
+    op::DriftPolicy p;
+    p.min_rows = 100;
+    op::DriftMonitor m({1000, 8000, 2000}, p);
+    m.observe(99, 99, 99);
+    EXPECT_FALSE(m.retrain_recommended());
+    m.observe(1, 1, 1);
+    EXPECT_TRUE(m.retrain_recommended());
+}
+
+TEST(DriftMonitorTest, TokensPerRowCheckIsOptIn) {
+    op::DriftPolicy p;
+    p.min_rows = 1;
+    op::DriftMonitor m({1000, 8000, 2000}, p);
+    m.observe(100, 1600, 400);                       // same bytes/token, 2x longer rows
+    EXPECT_FALSE(m.retrain_recommended());
+
+    p.max_tokens_per_row_ratio = 1.5;
+    m.set_policy(p);
+    EXPECT_TRUE(m.retrain_recommended());
+}
+
+TEST(DriftMonitorTest, WindowForgetsOldRows) {
+    op::DriftPolicy p;
+    p.min_rows    = 1;
+    p.window_rows = 1000;
+    op::DriftMonitor m({1000, 4000, 1000}, p);       // 4 bytes/token
+    m.observe(100000, 400000, 100000);               // long stable stretch
+    EXPECT_FALSE(m.retrain_recommended());
+
+    // A few windows of shifted rows outweigh everything before them.
+    for (int k = 0; k < 25; ++k) m.observe(200, 200, 200);
+    EXPECT_TRUE(m.retrain_recommended());
+    EXPECT_LT(m.bytes_per_token_ratio(), 0.6);
+}
+
+// ── Append ────────────────────────────────────────────────────────────────────
+
+TEST(AppendTest, RowsFollowAndTokenizeLikeParse) {
+    const auto first  = make_user_strings(2000);
+    const auto second = make_random_strings(700, 40, 7);
+    auto col = make_column(first);
+    col.append(second);
+
+    const auto all = concat(first, second);
+    EXPECT_EQ(decode_rows(col.view()), all);
+    expect_same_tokens(col.view(), reparse(col.view(), all));
+    EXPECT_EQ(col.view().equals(second[5]).size(), 1u);
+}
+
+TEST(AppendTest, ManySmallBatchesMatchOneParse) {
+    const auto first = make_user_strings(300);
+    const auto more  = make_mixed_length_strings(200, 300, 9);
+    for (op::BitWidth bits : {9, 13, 16}) {
+        auto col = make_column(first, bits);
+        for (const auto& s : more) col.append(std::vector<std::string>{s});
+        const auto all = concat(first, more);
+        EXPECT_EQ(decode_rows(col.view()), all);
+        expect_same_tokens(col.view(), reparse(col.view(), all));
+    }
+}
+
+TEST(AppendTest, ArrowOverloadAndEmptyBatch) {
+    const auto first  = make_user_strings(100);
+    const auto second = make_random_strings(50, 20, 3);
+    auto col = make_column(first);
+    const auto raw = make_raw(second);
+    col.append(reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+               second.size());
+    col.append(std::vector<std::string>{});
+    EXPECT_EQ(decode_rows(col.view()), concat(first, second));
+}
+
+TEST(AppendTest, ValidityIsExtended) {
+    const auto first = make_user_strings(70);
+    auto col = make_column(first);
+    ASSERT_FALSE(col.has_nulls());
+
+    // Row 1 is null and holds garbage bytes, which must not be stored.
+    const std::vector<std::string> batch = {"alpha", "garbage", "", "omega"};
+    const auto raw = make_raw(batch);
+    const uint8_t validity = 0b1101;
+    col.append(reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+               batch.size(), &validity);
+
+    const auto v = col.view();
+    EXPECT_EQ(col.null_count(), 1u);
+    for (size_t i = 0; i < 70; ++i) EXPECT_TRUE(v.is_valid(i)) << i;
+    EXPECT_TRUE(v.is_valid(70));
+    EXPECT_FALSE(v.is_valid(71));
+    EXPECT_TRUE(v.is_valid(72));
+    EXPECT_TRUE(v.is_valid(73));
+    EXPECT_EQ(decode_rows(v)[71], "");
+
+    // A later batch without nulls marks its rows valid.
+    col.append(std::vector<std::string>{"x", "y"});
+    EXPECT_EQ(col.null_count(), 1u);
+    EXPECT_TRUE(col.view().is_valid(75));
+}
+
+TEST(AppendTest, DeletionsAreExtendedAndStatisticsDropped) {
+    auto cfg = make_config();
+    cfg.collect_statistics = true;
+    auto col = op::OnPairColumn::compress(make_user_strings(100), cfg);
+    col.erase(10);
+    ASSERT_NE(col.statistics(), nullptr);
+
+    col.append(std::vector<std::string>{"new_row"});
+    EXPECT_EQ(col.statistics(), nullptr);
+    EXPECT_EQ(col.deleted_count(), 1u);
+    EXPECT_TRUE(col.view().is_deleted(10));
+    EXPECT_FALSE(col.view().is_deleted(100));
+    EXPECT_EQ(col.view().equals("new_row"), std::vector<size_t>{100});
+}
+
+TEST(AppendTest, DefaultColumnThrows) {
+    op::OnPairColumn col;
+    EXPECT_THROW(col.append(std::vector<std::string>{"a"}), std::logic_error);
+}
+
+// ── Drift ─────────────────────────────────────────────────────────────────────
+
+TEST(DriftTest, BaselineFromTraining) {
+    const auto data = make_user_strings(5000);
+    auto col = make_column(data);
+    const auto& d = col.drift();
+    ASSERT_TRUE(d.has_baseline());
+    EXPECT_DOUBLE_EQ(d.baseline().rows, 5000.0);
+    EXPECT_DOUBLE_EQ(d.baseline().bytes, 5000.0 * 11);
+    EXPECT_DOUBLE_EQ(d.baseline().tokens, double(col.view().store().num_tokens()));
+    EXPECT_EQ(d.observed_rows(), 0u);
+}
+
+TEST(DriftTest, SameDistributionIsNotFlagged) {
+    const auto data = make_user_strings(20000);
+    auto col = make_column(data);
+    for (size_t k = 0; k < 4; ++k) col.append(resample(data, 5000, k));
+    EXPECT_EQ(col.drift().observed_rows(), 20000u);
+    EXPECT_NEAR(col.drift().bytes_per_token_ratio(), 1.0, 0.05);
+    EXPECT_FALSE(col.drift().retrain_recommended());
+}
+
+TEST(DriftTest, ShiftedDistributionIsFlagged) {
+    auto col = make_column(make_user_strings(20000));
+    col.append(make_random_strings(2000, 30, 11));
+    EXPECT_LT(col.drift().bytes_per_token_ratio(), 0.85);
+    EXPECT_FALSE(col.drift().retrain_recommended());   // below min_rows
+
+    col.append(make_random_strings(3000, 30, 12));
+    EXPECT_TRUE(col.drift().retrain_recommended());
+}
+
+TEST(DriftTest, LoadedColumnTakesBaselineFromContents) {
+    auto col = make_column(make_user_strings(3000));
+    const auto base = col.drift().baseline();
+
+    std::stringstream ss;
+    col.write_to(ss);
+    auto loaded = op::OnPairColumn::read_from(ss);
+    EXPECT_FALSE(loaded.drift().has_baseline());
+
+    loaded.append(std::vector<std::string>{"user_999999"});
+    ASSERT_TRUE(loaded.drift().has_baseline());
+    EXPECT_DOUBLE_EQ(loaded.drift().baseline().rows,   base.rows);
+    EXPECT_DOUBLE_EQ(loaded.drift().baseline().bytes,  base.bytes);
+    EXPECT_DOUBLE_EQ(loaded.drift().baseline().tokens, base.tokens);
+}
+
+TEST(DriftTest, StateSurvivesSerialization) {
+    auto col = make_column(make_user_strings(3000));
+    op::DriftPolicy p;
+    p.min_rows = 10;
+    p.max_tokens_per_row_ratio = 2.5;
+    col.set_drift_policy(p);
+    col.append(make_random_strings(500, 30, 5));
+
+    std::stringstream ss;
+    col.write_to(ss);
+    auto loaded = op::OnPairColumn::read_from(ss);
+    EXPECT_TRUE(loaded.drift().policy() == p);
+    EXPECT_EQ(loaded.drift().observed_rows(), 500u);
+    EXPECT_DOUBLE_EQ(loaded.drift().recent().bytes,   col.drift().recent().bytes);
+    EXPECT_DOUBLE_EQ(loaded.drift().baseline().tokens, col.drift().baseline().tokens);
+    EXPECT_EQ(loaded.drift().retrain_recommended(), col.drift().retrain_recommended());
+    EXPECT_EQ(decode_rows(loaded.view()), decode_rows(col.view()));
+}
+
+// ── Retrain ───────────────────────────────────────────────────────────────────
+
+TEST(RetrainTest, KeepsRowsNullsAndDeletions) {
+    const auto first  = make_user_strings(3000);
+    const auto second = make_random_strings(3000, 30, 21);
+    auto col = make_column(first);
+    col.append(second);
+    const std::vector<size_t> gone = {0, 64, 4000};
+    col.erase(gone);
+
+    // One null row in a later batch.
+    const std::vector<std::string> tail = {"a", "b"};
+    const auto raw = make_raw(tail);
+    const uint8_t validity = 0b01;
+    col.append(reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+               tail.size(), &validity);
+
+    op::DriftPolicy p;
+    p.min_rows = 123;
+    col.set_drift_policy(p);
+
+    const auto fresh = col.retrain(make_config());
+    EXPECT_EQ(fresh.num_strings(), col.num_strings());
+    EXPECT_EQ(decode_rows(fresh.view()), decode_rows(col.view()));
+    EXPECT_EQ(fresh.deleted_count(), 3u);
+    for (size_t r : gone) EXPECT_TRUE(fresh.view().is_deleted(r));
+    EXPECT_EQ(fresh.null_count(), 1u);
+    EXPECT_FALSE(fresh.view().is_valid(6001));
+    EXPECT_EQ(fresh.drift().observed_rows(), 0u);
+    EXPECT_EQ(fresh.drift().policy().min_rows, 123u);
+    EXPECT_LT(fresh.bytes_used(), col.bytes_used());
+    expect_same_tokens(fresh.view(), reparse(fresh.view(), decode_rows(fresh.view())));
+}
+
+TEST(RetrainTest, AsyncWhileReadersUseSnapshot) {
+    auto live = std::make_shared<op::OnPairColumn>(make_column(make_user_strings(20000)));
+    live->append(make_random_strings(20000, 30, 31));
+    std::shared_ptr<const op::OnPairColumn> snapshot = live;
+    const auto expected = decode_rows(snapshot->view());
+    const auto probe    = expected[25000];
+
+    auto pending = op::OnPairColumn::retrain_async(snapshot, make_config());
+    live.reset();   // the task keeps the snapshot alive
+
+    std::atomic<bool> stop{false};
+    std::thread reader([&] {
+        const auto v = snapshot->view();
+        while (!stop.load()) ASSERT_EQ(v.equals(probe), std::vector<size_t>{25000});
+    });
+    auto fresh = pending.get();
+    stop = true;
+    reader.join();
+
+    EXPECT_EQ(decode_rows(fresh.view()), expected);
+    EXPECT_EQ(decode_rows(snapshot->view()), expected);
+    EXPECT_LT(fresh.bytes_used(), snapshot->bytes_used());
+}
+
+TEST(RetrainTest, AsyncRejectsNull) {
+    EXPECT_THROW(op::OnPairColumn::retrain_async(nullptr), std::invalid_argument);
+}
@@ -0,0 +1,94 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::encoding::TrainingConfig make_config(op::BitWidth bits = 14) {
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return cfg;
+}
+
+// Log lines with a handful of recurring shapes.
+static std::vector<std::string> log_lines(size_t n) {
+    static const char* level[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    static const char* path[]  = {"/api/v1/users", "/api/v1/orders", "/static/app.js",
+                                  "/healthz", "/api/v2/search?q="};
+    std::vector<std::string> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        out.push_back(std::string(level[i % 4]) + " 2024-05-" +
+                      std::to_string(10 + i % 20) + " GET " + path[(i * 7) % 5] +
+                      std::to_string(i * 2654435761u % 100000) + " status=" +
+                      std::to_string(200 + (i % 3) * 100));
+    return out;
+}
+
+static op::CompressionEstimate estimate(const std::vector<std::string>& data,
+                                        const op::encoding::TrainingConfig& cfg,
+                                        size_t sample_bytes = op::ESTIMATE_SAMPLE_BYTES)
+{
+    const auto raw = make_raw(data);
+    return op::OnPairColumn::estimate(reinterpret_cast<const char*>(raw.data.data()),
+                                      raw.offsets.data(), data.size(), cfg,
+                                      sample_bytes);
+}
+
+// ── Tests ─────────────────────────────────────────────────────────────────────
+
+// Below twice the sample size the whole input is both samples, so the
+// projection is exactly what compress() produces.
+TEST(EstimateTest, SmallInputIsExact) {
+    const auto data = make_random_strings(2000, 40, 6);
+    const auto cfg  = make_config();
+    const auto e    = estimate(data, cfg);
+    const auto col  = op::OnPairColumn::compress(data, cfg);
+
+    EXPECT_EQ(e.rows, data.size());
+    EXPECT_EQ(e.train_rows, data.size());
+    EXPECT_EQ(e.parse_rows, data.size());
+    EXPECT_EQ(e.dictionary_tokens, col.view().dictionary().num_tokens());
+    EXPECT_EQ(e.bytes_used, col.bytes_used());
+    EXPECT_DOUBLE_EQ(e.tokens_per_row,
+                     double(col.view().store().num_tokens()) / double(data.size()));
+    EXPECT_GT(e.decode_bytes_per_second, 0);
+    EXPECT_GT(e.scan_bytes_per_second, 0);
+}
+
+TEST(EstimateTest, SampledProjectionIsClose) {
+    const auto data = log_lines(60000);
+    const auto cfg  = make_config(12);
+    const auto e    = estimate(data, cfg, 128 << 10);
+    const auto col  = op::OnPairColumn::compress(data, cfg);
+
+    EXPECT_LT(e.train_rows + e.parse_rows, data.size() / 4);
+    EXPECT_GT(e.parse_rows, 0u);
+    EXPECT_NEAR(double(e.bytes_used) / double(col.bytes_used()), 1.0, 0.15);
+    EXPECT_NEAR(e.compression_ratio,
+                double(e.input_bytes) / double(col.bytes_used()),
+                0.15 * e.compression_ratio);
+    EXPECT_GT(e.bytes_per_token, 1.0);
+}
+
+TEST(EstimateTest, EmptyInput) {
+    const auto e = estimate({}, make_config());
+    EXPECT_EQ(e.rows, 0u);
+    EXPECT_EQ(e.input_bytes, 0u);
+    EXPECT_EQ(e.tokens_per_row, 0);
+    EXPECT_EQ(e.decode_bytes_per_second, 0);
+}
+
+TEST(EstimateTest, ZeroSampleThrows) {
+    EXPECT_THROW(estimate(make_user_strings(10), make_config(), 0),
+                 std::invalid_argument);
+}
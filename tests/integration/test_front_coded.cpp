@@ -0,0 +1,163 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+#include <onpair/search/automata/aho_corasick_lazy_automaton.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::OnPairColumn::Config make_config(op::BitWidth bits = 14) {
+    op::OnPairColumn::Config cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return cfg;
+}
+
+// Sorted file paths: long shared prefixes, some repeated rows.
+static std::vector<std::string> make_sorted_paths(int n) {
+    std::vector<std::string> out;
+    for (int i = 0; i < n; ++i)
+        out.push_back("/srv/data/project_" + std::to_string(i / 400) + "/module_" +
+                      std::to_string(i / 20 % 20) + "/file_" + std::to_string(i % 20 / 2) +
+                      ".txt");
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+static std::vector<std::string> decode_rows(const op::FrontCodedColumn& fc) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < fc.num_strings(); ++i)
+        out.emplace_back(buf.data(), fc.decompress(i, buf.data()));
+    return out;
+}
+
+static std::vector<std::string> decode_all(const op::FrontCodedColumn& fc,
+                                           size_t total_bytes) {
+    std::vector<char>     buf(total_bytes + op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offs(fc.num_strings() + 1);
+    const size_t len = fc.decompress_all(buf.data(), offs.data());
+    EXPECT_EQ(offs.back(), len);
+    std::vector<std::string> out;
+    for (size_t i = 0; i < fc.num_strings(); ++i)
+        out.emplace_back(buf.data() + offs[i], offs[i + 1] - offs[i]);
+    return out;
+}
+
+static size_t total_bytes(const std::vector<std::string>& rows) {
+    size_t n = 0;
+    for (const auto& r : rows) n += r.size();
+    return n;
+}
+
+// ── Round trip ────────────────────────────────────────────────────────────────
+
+TEST(FrontCodedTest, RoundTripAcrossRestartIntervals) {
+    const auto rows = make_sorted_paths(5000);
+    const auto col  = op::OnPairColumn::compress(rows, make_config());
+    for (size_t k : {size_t(1), size_t(2), size_t(16), size_t(1024)}) {
+        const auto fc = op::FrontCodedColumn::encode(col, k);
+        EXPECT_EQ(fc.restart_interval(), k);
+        EXPECT_EQ(decode_rows(fc), rows) << "restart " << k;
+        EXPECT_EQ(decode_all(fc, total_bytes(rows)), rows) << "restart " << k;
+        for (size_t i = 0; i < rows.size(); i += k)
+            EXPECT_EQ(fc.shared_tokens(i), 0u);
+    }
+}
+
+TEST(FrontCodedTest, PrefixHeavyRowsShrink) {
+    const auto rows = make_sorted_paths(20000);
+    const auto col  = op::OnPairColumn::compress(rows, make_config());
+    const auto fc   = op::FrontCodedColumn::encode(col);
+    EXPECT_TRUE(fc.shared_dictionary() == col.shared_dictionary());
+    EXPECT_LT(fc.num_tokens(), col.view().store().num_tokens() / 2);
+    EXPECT_LT(fc.bytes_used(), col.bytes_used());
+}
+
+TEST(FrontCodedTest, UnsortedRowsRoundTrip) {
+    const auto rows = make_mixed_length_strings(3000, 300, 7);
+    const auto fc   = op::FrontCodedColumn::compress(rows, make_config(12), 8);
+    EXPECT_EQ(fc.bits(), 12);
+    EXPECT_EQ(decode_rows(fc), rows);
+    EXPECT_EQ(decode_all(fc, total_bytes(rows)), rows);
+}
+
+TEST(FrontCodedTest, EmptyAndInvalidInterval) {
+    const op::OnPairColumn empty{};
+    const auto fc = op::FrontCodedColumn::encode(empty);
+    EXPECT_EQ(fc.num_strings(), 0u);
+    EXPECT_TRUE(fc.contains("x").empty());
+
+    const auto col = op::OnPairColumn::compress(make_user_strings(10), make_config());
+    EXPECT_THROW(op::FrontCodedColumn::encode(col, 0), std::invalid_argument);
+    EXPECT_THROW(op::FrontCodedColumn::encode(col, op::MAX_FRONT_CODING_RESTART + 1),
+                 std::invalid_argument);
+}
+
+// ── Search ────────────────────────────────────────────────────────────────────
+
+TEST(FrontCodedTest, SearchesMatchPlainColumn) {
+    const auto rows = make_sorted_paths(8000);
+    const auto col  = op::OnPairColumn::compress(rows, make_config());
+    const auto v    = col.view();
+    const auto fc   = op::FrontCodedColumn::encode(col);
+
+    for (std::string_view p : {"module_7/", "file_3", "project_1", "/", "x", "t"})
+        EXPECT_EQ(fc.contains(p), v.contains(p)) << p;
+    for (std::string_view p : {"/srv/data/project_1", "/srv/data/project_12/module_3",
+                               "", "/srv/x"})
+        EXPECT_EQ(fc.starts_with(p), v.starts_with(p)) << p;
+    EXPECT_EQ(fc.equals(rows[1234]), v.equals(rows[1234]));
+}
+
+TEST(FrontCodedTest, CombinatorsAndNonResumableAutomata) {
+    const auto rows = make_sorted_paths(4000);
+    const auto col  = op::OnPairColumn::compress(rows, make_config());
+    const auto v    = col.view();
+    const auto fc   = op::FrontCodedColumn::encode(col);
+    const auto dv   = fc.dictionary();
+
+    op::search::PrefixAutomaton pre("/srv/data/project_3", dv);
+    op::search::KmpAutomaton    kmp("file_4", dv);
+    static_assert(op::search::Resumable<decltype(pre && !kmp)>);
+    EXPECT_EQ(fc.scan(pre && !kmp), v.scan(pre && !kmp));
+
+    std::vector<std::string_view> pats{"module_5/file_1", "project_9"};
+    op::search::AhoCorasickLazyAutomaton lazy(pats, dv);
+    static_assert(!op::search::Resumable<op::search::AhoCorasickLazyAutomaton>);
+    EXPECT_EQ(fc.scan(lazy), v.scan(lazy));
+    op::search::AhoCorasickAutomaton ac(pats, dv);
+    EXPECT_EQ(fc.scan(ac), v.scan(ac));
+}
+
+TEST(FrontCodedTest, NullsAndDeletions) {
+    auto rows = make_sorted_paths(1000);
+    std::vector<uint8_t> validity((rows.size() + 7) / 8, 0xff);
+    for (size_t i = 5; i < rows.size(); i += 37) validity[i / 8] &= uint8_t(~(1u << (i % 8)));
+    const auto raw = make_raw(rows);
+    auto col = op::OnPairColumn::compress(reinterpret_cast<const char*>(raw.data.data()),
+                                          raw.offsets.data(), raw.n, validity.data(),
+                                          make_config());
+    col.erase(std::vector<size_t>{10, 11, 12, 500});
+
+    const auto v  = col.view();
+    const auto fc = op::FrontCodedColumn::encode(col);
+    std::vector<std::string> expect;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(fc.is_valid(i), v.is_valid(i));
+        EXPECT_EQ(fc.is_deleted(i), v.is_deleted(i));
+        expect.push_back(v.is_valid(i) && !v.is_deleted(i) ? rows[i] : "");
+    }
+    EXPECT_EQ(decode_rows(fc), expect);
+    EXPECT_EQ(decode_all(fc, total_bytes(rows)), expect);
+    EXPECT_EQ(fc.starts_with("/srv/data/project_0/module_0"),
+              v.starts_with("/srv/data/project_0/module_0"));
+    EXPECT_EQ(fc.contains("file_1"), v.contains("file_1"));
+}
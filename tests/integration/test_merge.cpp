@@ -0,0 +1,191 @@
+#include <onpair/api.h>
+#include <onpair/encoding/lpm.h>
+#include <onpair/encoding/parsing/parser.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14, uint64_t seed = 42)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = seed;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::vector<std::string> decode_all(const op::OnPairColumnView& v) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < v.num_strings(); ++i)
+        out.emplace_back(buf.data(), v.decompress(i, buf.data()));
+    return out;
+}
+
+static std::vector<op::Token> tokens_of(const op::OnPairColumnView& v) {
+    std::vector<op::Token> out;
+    const auto sv = v.store();
+    if (sv.num_tokens() == 0) return out;
+    op::dispatch_bits(sv.bits(), [&](auto b) {
+        op::decoding::TokenCursor<b.value> cur(
+            sv.packed_data(), op::StreamSpan{0, uint32_t(sv.num_tokens())});
+        while (cur.has_more()) out.push_back(cur.next());
+    });
+    return out;
+}
+
+static std::vector<uint32_t> bounds_of(const op::OnPairColumnView& v) {
+    const auto* b = v.store().boundaries();
+    return {b, b + v.num_strings() + 1};
+}
+
+// The merged stream must be exactly what parse() produces for the
+// concatenated input under the merged dictionary.
+static void expect_canonical(const op::OnPairColumn& merged,
+                             const std::vector<std::string>& all)
+{
+    std::vector<uint8_t>  data;
+    std::vector<uint32_t> offsets{0};
+    for (const auto& s : all) {
+        data.insert(data.end(), s.begin(), s.end());
+        offsets.push_back(uint32_t(data.size()));
+    }
+    const auto v = merged.view();
+    auto lpm = op::encoding::LongestPrefixMatcher::from_dictionary(v.dictionary());
+    op::Store store;
+    op::encoding::parse(data.data(), offsets.data(), all.size(), lpm, v.bits(), store);
+
+    const op::OnPairColumnView ref(store, v.dictionary());
+    EXPECT_EQ(bounds_of(v), bounds_of(ref));
+    EXPECT_EQ(tokens_of(v), tokens_of(ref));
+}
+
+template<typename T, typename... V>
+static std::vector<T> concat(const std::vector<T>& first, const V&... parts) {
+    std::vector<T> out = first;
+    (out.insert(out.end(), parts.begin(), parts.end()), ...);
+    return out;
+}
+
+// ── Tests ─────────────────────────────────────────────────────────────────────
+
+TEST(MergeTest, EmptySourceListThrows) {
+    EXPECT_THROW(op::OnPairColumn::merge({}), std::invalid_argument);
+}
+
+TEST(MergeTest, SharedDictionaryIsCopiedThrough) {
+    auto data = make_user_strings(400);
+    auto col = make_column(data);
+    const std::vector<op::OnPairColumnView> sources = {col.view(), col.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+
+    EXPECT_EQ(merged.view().dictionary().num_tokens(),
+              col.view().dictionary().num_tokens());
+    auto once = tokens_of(col.view());
+    auto twice = concat(once, once);
+    EXPECT_EQ(tokens_of(merged.view()), twice);
+    EXPECT_EQ(decode_all(merged.view()), concat(data, data));
+}
+
+TEST(MergeTest, DifferentDictionariesRoundTrip) {
+    auto a = make_user_strings(500);
+    auto b = make_random_strings(400, 40, 3);
+    auto c = make_mixed_length_strings(300, 200, 9);
+    auto ca = make_column(a, 12), cb = make_column(b, 12), cc = make_column(c, 12);
+    const std::vector<op::OnPairColumnView> sources = {ca.view(), cb.view(), cc.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+
+    const auto all = concat(a, b, c);
+    EXPECT_EQ(merged.num_strings(), all.size());
+    EXPECT_EQ(decode_all(merged.view()), all);
+    expect_canonical(merged, all);
+}
+
+TEST(MergeTest, SearchesMatchAfterMerge) {
+    auto a = make_user_strings(300);
+    auto b = make_random_strings(300, 30, 11);
+    b[5] = "user_000017";
+    auto ca = make_column(a), cb = make_column(b, 10);
+    const std::vector<op::OnPairColumnView> sources = {ca.view(), cb.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+    auto v = merged.view();
+
+    EXPECT_EQ(v.bits(), op::BitWidth(14));
+    EXPECT_EQ(v.equals("user_000017"), (std::vector<size_t>{17, 305}));
+    const auto all = concat(a, b);
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < all.size(); ++i)
+        if (all[i].find("00") != std::string::npos) expected.push_back(i);
+    EXPECT_EQ(v.contains("00"), expected);
+
+    // Equal strings from different sources share a token sequence.
+    auto g = op::analytics::group_rows(v);
+    EXPECT_EQ(g.group_of[17], g.group_of[305]);
+}
+
+TEST(MergeTest, OverflowingUnionIsTrimmed) {
+    auto a = make_random_strings(2000, 40, 1);
+    auto b = make_user_strings(2000);
+    auto ca = make_column(a, 9, 1), cb = make_column(b, 9, 2);
+    const std::vector<op::OnPairColumnView> sources = {ca.view(), cb.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+
+    EXPECT_EQ(merged.view().dictionary().num_tokens(), op::max_dict_size(9));
+    const auto all = concat(a, b);
+    EXPECT_EQ(decode_all(merged.view()), all);
+    expect_canonical(merged, all);
+}
+
+TEST(MergeTest, EmptyAndBinaryRows) {
+    auto a = make_empty_strings(10);
+    auto b = make_binary_strings(200, 50, 5);
+    std::vector<std::string> none;
+    auto ca = make_column(a), cb = make_column(b, 16), cn = make_column(none);
+    const std::vector<op::OnPairColumnView> sources = {ca.view(), cn.view(), cb.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+
+    EXPECT_EQ(merged.bits(), op::BitWidth(16));
+    const auto all = concat(a, b);
+    EXPECT_EQ(decode_all(merged.view()), all);
+    expect_canonical(merged, all);
+}
+
+TEST(MergeTest, ValidityIsConcatenated) {
+    const std::string bytes = "abcdef";
+    const uint32_t offsets[4] = {0, 2, 4, 6};
+    const uint8_t  valid_a = 0b101;
+    auto ca = op::OnPairColumn::compress(bytes.data(), offsets, 3, &valid_a);
+    auto cb = make_column({"x", "y"});
+    const std::vector<op::OnPairColumnView> sources = {ca.view(), cb.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+    auto v = merged.view();
+
+    ASSERT_TRUE(merged.has_nulls());
+    EXPECT_EQ(merged.null_count(), 1u);
+    const std::vector<bool> expected = {true, false, true, true, true};
+    for (size_t i = 0; i < expected.size(); ++i)
+        EXPECT_EQ(v.is_valid(i), expected[i]) << i;
+    EXPECT_EQ(v.starts_with(""), (std::vector<size_t>{0, 2, 3, 4}));
+}
+
+TEST(MergeTest, MergedColumnSerializes) {
+    auto ca = make_column(make_user_strings(100));
+    auto cb = make_column(make_random_strings(100, 20, 8));
+    const std::vector<op::OnPairColumnView> sources = {ca.view(), cb.view()};
+    auto merged = op::OnPairColumn::merge(sources);
+
+    std::stringstream ss;
+    merged.write_to(ss);
+    auto back = op::OnPairColumn::read_from(ss);
+    EXPECT_EQ(decode_all(back.view()), decode_all(merged.view()));
+}
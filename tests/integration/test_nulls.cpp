@@ -0,0 +1,235 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+// An Arrow-style string array: flat bytes, n+1 offsets, byte validity bitmap.
+struct ArrowStrings {
+    std::string           data;
+    std::vector<uint32_t> offsets{0};
+    std::vector<uint8_t>  validity;
+    size_t                n = 0;
+
+    // Null slots get `garbage` bytes, which Arrow permits.
+    void append(std::optional<std::string_view> v, std::string_view garbage = {}) {
+        if (validity.size() * 8 <= n) validity.push_back(0);
+        if (v) {
+            data.append(*v);
+            validity[n / 8] |= uint8_t(1u << (n % 8));
+        } else {
+            data.append(garbage);
+        }
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+        ++n;
+    }
+};
+
+static op::OnPairColumn compress(const ArrowStrings& a, op::BitWidth bits = 14) {
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(a.data.data(), a.offsets.data(), a.n,
+                                      a.validity.data(), cfg);
+}
+
+// Every third row null; a third of the nulls carry garbage bytes.
+static ArrowStrings make_nullable(const std::vector<std::string>& values) {
+    ArrowStrings a;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i % 3 == 1) a.append(std::nullopt, i % 9 == 1 ? "garbage_needle" : "");
+        else            a.append(values[i]);
+    }
+    return a;
+}
+
+template<typename Pred>
+static std::vector<size_t> brute(const std::vector<std::string>& values, Pred pred) {
+    std::vector<size_t> out;
+    for (size_t i = 0; i < values.size(); ++i)
+        if (i % 3 != 1 && pred(values[i])) out.push_back(i);
+    return out;
+}
+
+// ── Validity bitmap helpers ───────────────────────────────────────────────────
+
+TEST(ValidityTest, PackClearsTrailingBits) {
+    const uint8_t bytes[2] = {0xFF, 0xFF};
+    auto words = op::pack_validity(bytes, 10);
+    ASSERT_EQ(words.size(), 1u);
+    EXPECT_EQ(words[0], 0x3FFu);
+    EXPECT_EQ(op::count_nulls(words.data(), 10), 0u);
+}
+
+TEST(ValidityTest, ForEachValidVisitsSetBitsInOrder) {
+    std::vector<uint64_t> words(3, 0);
+    const std::vector<size_t> rows = {0, 5, 63, 64, 130, 191};
+    for (size_t r : rows) words[r / 64] |= uint64_t(1) << (r % 64);
+    std::vector<size_t> seen;
+    op::for_each_valid(words.data(), 192, [&](size_t i) { seen.push_back(i); });
+    EXPECT_EQ(seen, rows);
+    EXPECT_EQ(op::count_nulls(words.data(), 192), 192 - rows.size());
+}
+
+TEST(ValidityTest, NullptrMeansAllValid) {
+    size_t count = 0;
+    op::for_each_valid(nullptr, 70, [&](size_t) { ++count; });
+    EXPECT_EQ(count, 70u);
+    EXPECT_TRUE(op::is_valid_row(nullptr, 3));
+    uint8_t out[2] = {};
+    op::unpack_validity(nullptr, 9, out);
+    EXPECT_EQ(out[0], 0xFF);
+    EXPECT_EQ(out[1], 0xFF);
+}
+
+// ── Compression ───────────────────────────────────────────────────────────────
+
+TEST(NullsTest, ValidityIsReported) {
+    auto values = make_user_strings(100);
+    auto a = make_nullable(values);
+    auto col = compress(a);
+    auto v = col.view();
+
+    ASSERT_TRUE(col.has_nulls());
+    EXPECT_EQ(col.null_count(), 33u);
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(v.is_valid(i), i % 3 != 1) << i;
+}
+
+TEST(NullsTest, NullSlotsDecompressEmptyAndSkipGarbage) {
+    auto values = make_user_strings(90);
+    auto a = make_nullable(values);
+    auto col = compress(a);
+    auto v = col.view();
+
+    std::vector<char> buf(64 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const size_t len = v.decompress(i, buf.data());
+        EXPECT_EQ(std::string(buf.data(), len), i % 3 == 1 ? "" : values[i]) << i;
+    }
+}
+
+TEST(NullsTest, AllValidBitmapIsDropped) {
+    ArrowStrings a;
+    for (const auto& s : make_user_strings(20)) a.append(s);
+    auto col = compress(a);
+    EXPECT_FALSE(col.has_nulls());
+    EXPECT_EQ(col.view().validity(), nullptr);
+    EXPECT_EQ(col.null_count(), 0u);
+}
+
+TEST(NullsTest, AllNullColumn) {
+    ArrowStrings a;
+    for (int i = 0; i < 70; ++i) a.append(std::nullopt, "xyz");
+    auto col = compress(a);
+    EXPECT_EQ(col.null_count(), 70u);
+    EXPECT_TRUE(col.view().scan(!search::KmpAutomaton("q", col.view().dictionary())).empty());
+}
+
+// ── Scans ─────────────────────────────────────────────────────────────────────
+
+class NullScanTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, NullScanTest,
+    testing::Values(9, 12, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(NullScanTest, SearchesNeverMatchNulls) {
+    auto values = make_random_strings(1000, 30, 7);
+    values[4] = values[7] = "garbage_needle";
+    auto a = make_nullable(values);
+    auto col = compress(a, static_cast<op::BitWidth>(GetParam()));
+    auto v = col.view();
+    const auto dv = v.dictionary();
+
+    auto has = [](std::string_view needle) {
+        return [needle](const std::string& s) { return s.find(needle) != std::string::npos; };
+    };
+    EXPECT_EQ(v.contains("needle"), brute(values, has("needle")));
+    EXPECT_EQ(v.contains("a"), brute(values, has("a")));
+    EXPECT_EQ(v.contains_bytes("ab"), brute(values, has("ab")));
+    EXPECT_EQ(v.starts_with(""), brute(values, [](const auto&) { return true; }));
+    EXPECT_EQ(v.equals(""), brute(values, [](const auto& s) { return s.empty(); }));
+    EXPECT_EQ(v.contains_byte_if([](uint8_t c) { return c == 'z'; }), brute(values, has("z")));
+
+    const std::vector<std::string_view> prefixes = {"a", "gar"};
+    EXPECT_EQ(v.starts_with_any(prefixes), brute(values, [](const std::string& s) {
+        return s.starts_with("a") || s.starts_with("gar");
+    }));
+
+    // NOT contains: the complement of the valid rows only.
+    search::KmpAutomaton kmp("e", dv);
+    const auto expected = brute(values, [](const std::string& s) {
+        return s.find('e') == std::string::npos;
+    });
+    EXPECT_EQ(v.scan(!kmp), expected);
+    EXPECT_EQ(v.scan_blocked(!kmp), expected);
+    EXPECT_EQ(v.scan_interleaved(search::KmpAutomaton("e", dv)),
+              brute(values, has("e")));
+}
+
+TEST(NullsTest, ColumnWithoutNullsScansAsBefore) {
+    auto values = make_user_strings(200);
+    ArrowStrings a;
+    for (const auto& s : values) a.append(s);
+    auto col = compress(a);
+    auto plain = op::OnPairColumn::compress(values);
+    EXPECT_EQ(col.view().contains("_00"), plain.view().contains("_00"));
+}
+
+// ── Bulk decompression ────────────────────────────────────────────────────────
+
+TEST(NullsTest, DecompressAllEmitsValidity) {
+    auto values = make_user_strings(77);
+    auto a = make_nullable(values);
+    auto col = compress(a);
+    auto v = col.view();
+
+    std::vector<char>     buf(77 * 16 + op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offsets(78);
+    std::vector<uint8_t>  validity((77 + 7) / 8, 0);
+    v.decompress_all(buf.data(), offsets.data(), validity.data());
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        const bool valid = (validity[i / 8] >> (i % 8)) & 1;
+        EXPECT_EQ(valid, i % 3 != 1) << i;
+        const std::string got(buf.data() + offsets[i], offsets[i + 1] - offsets[i]);
+        EXPECT_EQ(got, valid ? values[i] : "") << i;
+    }
+}
+
+TEST(NullsTest, DecompressAllWithoutNullsReportsAllValid) {
+    auto col = op::OnPairColumn::compress(make_user_strings(12));
+    std::vector<char>     buf(12 * 16 + op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offsets(13);
+    std::vector<uint8_t>  validity(2, 0);
+    col.view().decompress_all(buf.data(), offsets.data(), validity.data());
+    EXPECT_EQ(validity[0], 0xFF);
+    EXPECT_EQ(validity[1] & 0x0F, 0x0F);
+}
+
+// ── Serialization ─────────────────────────────────────────────────────────────
+
+TEST(NullsTest, ValiditySurvivesSerialization) {
+    auto values = make_user_strings(300);
+    auto col = compress(make_nullable(values));
+
+    std::stringstream ss;
+    col.write_to(ss);
+    EXPECT_EQ(ss.str().substr(0, 8), "ONPAIR02");
+    auto back = op::OnPairColumn::read_from(ss);
+
+    EXPECT_EQ(back.null_count(), col.null_count());
+    EXPECT_EQ(back.view().contains("user"), col.view().contains("user"));
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(back.view().is_valid(i), col.view().is_valid(i)) << i;
+}
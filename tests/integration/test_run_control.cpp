@@ -0,0 +1,235 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::encoding::TrainingConfig make_config(op::BitWidth bits = 14) {
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return cfg;
+}
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    return op::OnPairColumn::compress(strings, make_config(bits));
+}
+
+static std::vector<std::string> decode_rows(const op::OnPairColumnView& v) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < v.num_strings(); ++i)
+        out.emplace_back(buf.data(), v.decompress(i, buf.data()));
+    return out;
+}
+
+// A control that requests a stop from its progress callback once `stop_after`
+// rows are done, recording every report.
+struct StopAfter {
+    std::stop_source    src;
+    std::vector<size_t> reports;
+    op::RunControl      ctl;
+
+    StopAfter(size_t stop_after, size_t block_rows) {
+        ctl.stop       = src.get_token();
+        ctl.block_rows = block_rows;
+        ctl.progress   = [this, stop_after](size_t done, size_t) {
+            reports.push_back(done);
+            if (done >= stop_after) src.request_stop();
+        };
+    }
+};
+
+// ── RunControl ────────────────────────────────────────────────────────────────
+
+TEST(RunControlTest, BlockRoundsUpToWholeWords) {
+    op::RunControl ctl;
+    EXPECT_EQ(ctl.block(), op::RUN_BLOCK_ROWS);
+    ctl.block_rows = 0;   EXPECT_EQ(ctl.block(), 64u);
+    ctl.block_rows = 64;  EXPECT_EQ(ctl.block(), 64u);
+    ctl.block_rows = 65;  EXPECT_EQ(ctl.block(), 128u);
+    EXPECT_FALSE(ctl.stop_requested());
+    ctl.report(1, 2);     // no callback: no-op
+}
+
+// ── scan ──────────────────────────────────────────────────────────────────────
+
+TEST(RunControlTest, ScanToCompletionMatchesScan) {
+    const auto data = make_random_strings(3000, 30, 5);
+    const auto col  = make_column(data);
+    const auto v    = col.view();
+    search::KmpAutomaton kmp("a", v.dictionary());
+
+    StopAfter s(size_t(-1), 1000);
+    std::vector<size_t> rows;
+    const auto r = v.scan(kmp, [&](size_t i) { rows.push_back(i); }, s.ctl);
+    EXPECT_TRUE(r.complete());
+    EXPECT_EQ(r.rows, data.size());
+    EXPECT_EQ(rows, v.scan(kmp));
+    EXPECT_EQ(s.reports, (std::vector<size_t>{1024, 2048, 3000}));
+}
+
+TEST(RunControlTest, ScanStopsAtBlockBoundary) {
+    const auto data = make_user_strings(5000);
+    const auto col  = make_column(data);
+    const auto v    = col.view();
+    search::PrefixAutomaton pre("user_", v.dictionary());
+
+    StopAfter s(1500, 512);
+    std::vector<size_t> rows;
+    const auto r = v.scan(pre, [&](size_t i) { rows.push_back(i); }, s.ctl);
+    EXPECT_EQ(r.status, op::RunStatus::Cancelled);
+    EXPECT_EQ(r.rows, 1536u);
+    ASSERT_EQ(rows.size(), 1536u);
+    EXPECT_EQ(rows.back(), 1535u);
+}
+
+TEST(RunControlTest, ScanAlreadyStopped) {
+    const auto col = make_column(make_user_strings(100));
+    std::stop_source src;
+    src.request_stop();
+    search::PrefixAutomaton pre("user_", col.view().dictionary());
+    size_t calls = 0;
+    const auto r = col.view().scan(pre, [&](size_t) { ++calls; },
+                                   op::RunControl{src.get_token()});
+    EXPECT_FALSE(r.complete());
+    EXPECT_EQ(r.rows, 0u);
+    EXPECT_EQ(calls, 0u);
+}
+
+TEST(RunControlTest, ScanSkipsNullAndDeletedRows) {
+    const auto data = make_user_strings(1000);
+    auto raw = make_raw(data);
+    std::vector<uint8_t> validity((data.size() + 7) / 8, 0xFF);
+    validity[10] = 0xF0;                                  // rows 80..83 null
+    auto col = op::OnPairColumn::compress(
+        reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        data.size(), validity.data(), make_config());
+    col.erase(std::vector<size_t>{0, 63, 64, 999});
+
+    const auto v = col.view();
+    search::PrefixAutomaton pre("user_", v.dictionary());
+    op::RunControl ctl;
+    ctl.block_rows = 100;
+    std::vector<size_t> rows;
+    EXPECT_TRUE(v.scan(pre, [&](size_t i) { rows.push_back(i); }, ctl).complete());
+    EXPECT_EQ(rows, v.scan(pre));
+    EXPECT_EQ(rows.size(), 1000u - 8);
+}
+
+// ── decompress_all ────────────────────────────────────────────────────────────
+
+TEST(RunControlTest, DecompressAllMatchesPlainOverload) {
+    const auto data = make_mixed_length_strings(2000, 200, 9);
+    auto col = make_column(data, 12);
+    col.erase(std::vector<size_t>{1, 500, 1999});
+    const auto v = col.view();
+
+    const size_t cap = v.store().num_tokens() * op::MAX_TOKEN_SIZE
+                     + op::DECOMPRESS_BUFFER_PADDING;
+    std::vector<char> a(cap), b(cap);
+    std::vector<uint32_t> oa(data.size() + 1), ob(data.size() + 1);
+    const size_t len = v.decompress_all(a.data(), oa.data());
+
+    op::RunControl ctl;
+    ctl.block_rows = 300;
+    const auto r = v.decompress_all(b.data(), ob.data(), ctl);
+    EXPECT_TRUE(r.complete());
+    EXPECT_EQ(r.rows, data.size());
+    EXPECT_EQ(r.bytes, len);
+    EXPECT_EQ(oa, ob);
+    EXPECT_EQ(std::string(a.data(), len), std::string(b.data(), r.bytes));
+}
+
+TEST(RunControlTest, DecompressAllCancelledKeepsPrefix) {
+    const auto data = make_user_strings(1000);
+    const auto col  = make_column(data);
+    const auto v    = col.view();
+
+    std::vector<char> buf(v.store().num_tokens() * op::MAX_TOKEN_SIZE
+                          + op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offs(data.size() + 1);
+    StopAfter s(200, 128);
+    const auto r = v.decompress_all(buf.data(), offs.data(), s.ctl);
+    EXPECT_EQ(r.status, op::RunStatus::Cancelled);
+    ASSERT_EQ(r.rows, 256u);
+    EXPECT_EQ(offs[r.rows], r.bytes);
+    for (size_t i = 0; i < r.rows; ++i)
+        EXPECT_EQ(std::string(buf.data() + offs[i], offs[i + 1] - offs[i]), data[i]);
+}
+
+// ── compress ──────────────────────────────────────────────────────────────────
+
+TEST(RunControlTest, CompressToCompletionMatchesCompress) {
+    const auto data = make_random_strings(3000, 40, 4);
+    const auto raw  = make_raw(data);
+    StopAfter s(size_t(-1), 1000);
+    op::RunResult r;
+    const auto col = op::OnPairColumn::compress(
+        reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        data.size(), nullptr, make_config(), s.ctl, r);
+    EXPECT_TRUE(r.complete());
+    EXPECT_EQ(r.rows, data.size());
+    EXPECT_EQ(r.bytes, raw.data.size());
+    EXPECT_EQ(s.reports, (std::vector<size_t>{1024, 2048, 3000}));
+    EXPECT_EQ(decode_rows(col.view()), data);
+    EXPECT_EQ(col.view().store().num_tokens(),
+              make_column(data).view().store().num_tokens());
+}
+
+TEST(RunControlTest, CompressCancelledCanBeResumedByAppend) {
+    const auto data = make_user_strings(4000);
+    auto raw = make_raw(data);
+    std::vector<uint8_t> validity((data.size() + 7) / 8, 0xFF);
+    validity[1] = 0x00;                                   // rows 8..15 null
+    validity[300] = 0x00;                                 // rows 2400..2407 null
+
+    auto cfg = make_config();
+    cfg.collect_statistics = true;
+    StopAfter s(1000, 1000);
+    op::RunResult r;
+    auto col = op::OnPairColumn::compress(
+        reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        data.size(), validity.data(), cfg, s.ctl, r);
+    EXPECT_EQ(r.status, op::RunStatus::Cancelled);
+    ASSERT_EQ(r.rows, 1024u);
+    EXPECT_EQ(r.bytes, size_t(raw.offsets[1024]));
+    ASSERT_EQ(col.num_strings(), 1024u);
+    EXPECT_EQ(col.null_count(), 8u);
+    EXPECT_EQ(col.statistics()->num_strings, 1024u);
+
+    const size_t rest = data.size() - r.rows;
+    std::vector<uint32_t> tail(rest + 1);
+    for (size_t i = 0; i <= rest; ++i) tail[i] = raw.offsets[r.rows + i] - raw.offsets[r.rows];
+    col.append(reinterpret_cast<const char*>(raw.data.data()) + raw.offsets[r.rows],
+               tail.data(), rest, validity.data() + r.rows / 8);
+    EXPECT_EQ(col.num_strings(), data.size());
+    EXPECT_EQ(col.null_count(), 16u);
+    const auto rows = decode_rows(col.view());
+    for (size_t i = 0; i < data.size(); ++i)
+        EXPECT_EQ(rows[i], col.view().is_valid(i) ? data[i] : "") << i;
+}
+
+TEST(RunControlTest, CompressAlreadyStopped) {
+    const auto data = make_user_strings(100);
+    const auto raw  = make_raw(data);
+    std::stop_source src;
+    src.request_stop();
+    op::RunResult r;
+    const auto col = op::OnPairColumn::compress(
+        reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        data.size(), nullptr, make_config(), op::RunControl{src.get_token()}, r);
+    EXPECT_EQ(r.status, op::RunStatus::Cancelled);
+    EXPECT_EQ(r.rows, 0u);
+    EXPECT_EQ(col.num_strings(), 0u);
+}
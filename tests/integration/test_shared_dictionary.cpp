@@ -0,0 +1,165 @@
+#include <onpair/api.h>
+#include <onpair/analytics/row_hash.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace analytics = onpair::analytics;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::encoding::TrainingConfig make_config(op::BitWidth bits = 14) {
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return cfg;
+}
+
+static std::vector<std::string> decode_rows(const op::OnPairColumnView& v) {
+    std::vector<std::string> out;
+    std::vector<char> buf(4096 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < v.num_strings(); ++i)
+        out.emplace_back(buf.data(), v.decompress(i, buf.data()));
+    return out;
+}
+
+// src/dst URL pairs: every third dst value is also a src value.
+static std::vector<std::vector<std::string>> url_columns(int n) {
+    std::vector<std::string> src, dst;
+    for (int i = 0; i < n; ++i) {
+        src.push_back("https://example.com/page/" + std::to_string(i));
+        dst.push_back(i % 3 == 0 ? src.back()
+                                 : "https://example.org/item/" + std::to_string(i * 7));
+    }
+    return {src, dst};
+}
+
+// ── compress_shared ───────────────────────────────────────────────────────────
+
+TEST(SharedDictionaryTest, ColumnsShareOneDictionary) {
+    const auto input = url_columns(3000);
+    const auto cols  = op::OnPairColumn::compress_shared(input, make_config());
+    ASSERT_EQ(cols.size(), 2u);
+    EXPECT_TRUE(cols[0].shares_dictionary_with(cols[1]));
+    EXPECT_EQ(cols[0].shared_dictionary().get(), cols[1].shared_dictionary().get());
+    EXPECT_EQ(decode_rows(cols[0].view()), input[0]);
+    EXPECT_EQ(decode_rows(cols[1].view()), input[1]);
+}
+
+TEST(SharedDictionaryTest, IndependentColumnsDoNotShare) {
+    const auto input = url_columns(200);
+    const auto a = op::OnPairColumn::compress(input[0], make_config());
+    const auto b = op::OnPairColumn::compress(input[1], make_config());
+    EXPECT_FALSE(a.shares_dictionary_with(b));
+    EXPECT_FALSE(op::OnPairColumn().shares_dictionary_with(op::OnPairColumn()));
+}
+
+TEST(SharedDictionaryTest, EqualValuesHaveEqualTokensAcrossColumns) {
+    const auto input = url_columns(3000);
+    const auto cols  = op::OnPairColumn::compress_shared(input, make_config());
+    const auto a = cols[0].view(), b = cols[1].view();
+
+    std::vector<uint64_t> ha(a.num_strings()), hb(b.num_strings());
+    analytics::hash_rows(a, ha.data());
+    analytics::hash_rows(b, hb.data());
+    for (size_t i = 0; i < input[0].size(); ++i) {
+        const bool same = input[0][i] == input[1][i];
+        EXPECT_EQ(analytics::rows_equal(a, i, b, i), same) << i;
+        if (same) EXPECT_EQ(ha[i], hb[i]) << i;
+    }
+}
+
+TEST(SharedDictionaryTest, EmptyAndUnevenColumns) {
+    const std::vector<std::vector<std::string>> input = {
+        make_user_strings(500), {}, make_random_strings(20, 30, 3)};
+    const auto cols = op::OnPairColumn::compress_shared(input, make_config());
+    ASSERT_EQ(cols.size(), 3u);
+    for (size_t k = 0; k < input.size(); ++k) {
+        EXPECT_EQ(decode_rows(cols[k].view()), input[k]);
+        EXPECT_TRUE(cols[k].shares_dictionary_with(cols[0]));
+    }
+}
+
+TEST(SharedDictionaryTest, StatisticsAndDriftArePerColumn) {
+    auto cfg = make_config();
+    cfg.collect_statistics = true;
+    const auto input = url_columns(1000);
+    const auto cols  = op::OnPairColumn::compress_shared(input, cfg);
+    for (size_t k = 0; k < 2; ++k) {
+        ASSERT_NE(cols[k].statistics(), nullptr);
+        EXPECT_EQ(cols[k].statistics()->num_strings, input[k].size());
+        EXPECT_DOUBLE_EQ(cols[k].drift().baseline().rows, double(input[k].size()));
+        EXPECT_DOUBLE_EQ(cols[k].drift().baseline().tokens,
+                         double(cols[k].view().store().num_tokens()));
+    }
+}
+
+// ── compress_with ─────────────────────────────────────────────────────────────
+
+TEST(SharedDictionaryTest, CompressWithReusesDictionary) {
+    const auto input = url_columns(2000);
+    const auto ref   = op::OnPairColumn::compress(input[0], make_config());
+    const auto other = op::OnPairColumn::compress_with(ref, input[1]);
+    EXPECT_TRUE(other.shares_dictionary_with(ref));
+    EXPECT_EQ(other.bits(), ref.bits());
+    EXPECT_EQ(decode_rows(other.view()), input[1]);
+    EXPECT_TRUE(analytics::rows_equal(ref.view(), 3, other.view(), 3));
+
+    const auto raw = make_raw(input[1]);
+    const auto arrow = op::OnPairColumn::compress_with(
+        ref, reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        input[1].size());
+    EXPECT_TRUE(arrow.shares_dictionary_with(ref));
+    EXPECT_EQ(decode_rows(arrow.view()), input[1]);
+}
+
+TEST(SharedDictionaryTest, CompressWithDefaultColumnThrows) {
+    EXPECT_THROW(op::OnPairColumn::compress_with(op::OnPairColumn(),
+                                                 std::vector<std::string>{"a"}),
+                 std::logic_error);
+}
+
+TEST(SharedDictionaryTest, AppendAndRetrainKeepOrDropSharing) {
+    const auto input = url_columns(1000);
+    auto cols = op::OnPairColumn::compress_shared(input, make_config());
+    cols[1].append(std::vector<std::string>{input[0][7]});
+    EXPECT_TRUE(cols[1].shares_dictionary_with(cols[0]));
+    EXPECT_TRUE(analytics::rows_equal(cols[0].view(), 7, cols[1].view(), 1000));
+
+    const auto fresh = cols[1].retrain(make_config());
+    EXPECT_FALSE(fresh.shares_dictionary_with(cols[0]));
+    EXPECT_EQ(decode_rows(fresh.view()), decode_rows(cols[1].view()));
+}
+
+// ── Serialisation ─────────────────────────────────────────────────────────────
+
+TEST(SharedDictionaryTest, ReadFromRestoresSharing) {
+    const auto input = url_columns(1000);
+    const auto cols  = op::OnPairColumn::compress_shared(input, make_config());
+    std::stringstream a, b;
+    cols[0].write_to(a);
+    cols[1].write_to(b);
+
+    const auto la = op::OnPairColumn::read_from(a);
+    const auto lb = op::OnPairColumn::read_from(b, la.shared_dictionary());
+    EXPECT_TRUE(lb.shares_dictionary_with(la));
+    EXPECT_EQ(decode_rows(la.view()), input[0]);
+    EXPECT_EQ(decode_rows(lb.view()), input[1]);
+}
+
+TEST(SharedDictionaryTest, ReadFromLoadsOwnCopyWhenDifferent) {
+    const auto input = url_columns(500);
+    const auto a = op::OnPairColumn::compress(input[0], make_config());
+    const auto b = op::OnPairColumn::compress(input[1], make_config(12));
+    std::stringstream ss;
+    b.write_to(ss);
+    const auto lb = op::OnPairColumn::read_from(ss, a.shared_dictionary());
+    EXPECT_FALSE(lb.shares_dictionary_with(a));
+    EXPECT_EQ(decode_rows(lb.view()), input[1]);
+}
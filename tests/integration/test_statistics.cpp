@@ -0,0 +1,207 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    bool stats = true, op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    cfg.collect_statistics = stats;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::string decode_tokens(op::DictionaryView dv, const std::vector<op::Token>& t) {
+    std::string s;
+    for (auto tok : t)
+        s.append(reinterpret_cast<const char*>(dv.data(tok)), dv.token_size(tok));
+    return s;
+}
+
+static op::OnPairColumn roundtrip(const op::OnPairColumn& col) {
+    std::stringstream ss;
+    col.write_to(ss);
+    return op::OnPairColumn::read_from(ss);
+}
+
+// ── Presence ──────────────────────────────────────────────────────────────────
+
+TEST(StatisticsTest, AbsentByDefault) {
+    auto col = make_column(make_user_strings(50), false);
+    EXPECT_EQ(col.statistics(), nullptr);
+    EXPECT_EQ(col.view().statistics(), nullptr);
+}
+
+TEST(StatisticsTest, ExposedOnColumnAndView) {
+    auto col = make_column(make_user_strings(50));
+    ASSERT_NE(col.statistics(), nullptr);
+    EXPECT_EQ(col.view().statistics(), col.statistics());
+}
+
+// ── Contents ──────────────────────────────────────────────────────────────────
+
+class StatisticsBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, StatisticsBitsTest,
+    testing::Values(9, 12, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(StatisticsBitsTest, MatchesDirectComputation) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto data = make_mixed_length_strings(1500, 200, 21);
+    auto bin = make_binary_strings(300, 40, 4);
+    data.insert(data.end(), bin.begin(), bin.end());
+    data.push_back("");
+    data.push_back("");
+
+    auto col = make_column(data, true, bits);
+    auto v = col.view();
+    const auto& s = *v.statistics();
+
+    // Lengths
+    uint64_t total = 0, empty = 0;
+    size_t lo = SIZE_MAX, hi = 0;
+    for (const auto& d : data) {
+        total += d.size();
+        empty += d.empty();
+        lo = std::min(lo, d.size());
+        hi = std::max(hi, d.size());
+    }
+    EXPECT_EQ(s.num_strings, data.size());
+    EXPECT_EQ(s.total_bytes, total);
+    EXPECT_EQ(s.empty_count, empty);
+    EXPECT_EQ(s.min_length, lo);
+    EXPECT_EQ(s.max_length, hi);
+    EXPECT_DOUBLE_EQ(s.mean_length(), double(total) / double(data.size()));
+
+    // Min / max as token prefixes
+    const auto [mn, mx] = std::minmax_element(data.begin(), data.end());
+    const auto dv = v.dictionary();
+    const std::string min_pfx = decode_tokens(dv, s.min_prefix);
+    const std::string max_pfx = decode_tokens(dv, s.max_prefix);
+    EXPECT_TRUE(std::string_view(*mn).starts_with(min_pfx));
+    EXPECT_TRUE(std::string_view(*mx).starts_with(max_pfx));
+    EXPECT_EQ(s.min_exact, min_pfx == *mn);
+    EXPECT_EQ(s.max_exact, max_pfx == *mx);
+    EXPECT_LE(s.max_prefix.size(), op::STATS_PREFIX_TOKENS);
+
+    // Token-count histogram and per-token frequency
+    const auto sv = v.store();
+    std::vector<uint64_t> hist(op::STATS_HISTOGRAM_BUCKETS, 0);
+    for (size_t i = 0; i < sv.num_strings(); ++i) {
+        const auto span = sv.string_span(i);
+        ++hist[std::min<size_t>(span.end - span.begin, op::STATS_HISTOGRAM_BUCKETS - 1)];
+    }
+    EXPECT_EQ(s.token_count_histogram, hist);
+
+    ASSERT_EQ(s.token_frequency.size(), dv.num_tokens());
+    EXPECT_EQ(std::accumulate(s.token_frequency.begin(), s.token_frequency.end(), uint64_t(0)),
+              sv.num_tokens());
+    std::vector<uint32_t> freq(dv.num_tokens(), 0);
+    op::dispatch_bits(sv.bits(), [&](auto b) {
+        op::decoding::TokenCursor<b.value> cur(sv.packed_data(),
+                                               op::StreamSpan{0, uint32_t(sv.num_tokens())});
+        while (cur.has_more()) ++freq[cur.next()];
+    });
+    EXPECT_EQ(s.token_frequency, freq);
+
+    // Distinct estimate agrees with a sketch built after the fact.
+    const auto post = op::analytics::build_hll(v, op::STATS_HLL_PRECISION);
+    EXPECT_TRUE(std::ranges::equal(s.distinct.registers(), post.registers()));
+    const double distinct = double(std::unordered_set<std::string>(data.begin(), data.end()).size());
+    EXPECT_NEAR(s.distinct_estimate(), distinct, 0.08 * distinct);
+}
+
+TEST(StatisticsTest, EmptyColumn) {
+    std::vector<std::string> data;
+    auto col = make_column(data);
+    const auto& s = *col.statistics();
+    EXPECT_EQ(s.num_strings, 0u);
+    EXPECT_EQ(s.mean_length(), 0.0);
+    EXPECT_TRUE(s.min_prefix.empty());
+    EXPECT_EQ(s.distinct_estimate(), 0.0);
+}
+
+TEST(StatisticsTest, LongValuesGetTruncatedPrefix) {
+    std::vector<std::string> data = {std::string(500, 'z'), "a"};
+    auto col = make_column(data);
+    const auto& s = *col.statistics();
+    EXPECT_TRUE(s.min_exact);
+    EXPECT_FALSE(s.max_exact);
+    EXPECT_EQ(s.max_prefix.size(), op::STATS_PREFIX_TOKENS);
+}
+
+// ── Persistence ───────────────────────────────────────────────────────────────
+
+TEST(StatisticsTest, SurvivesSerialization) {
+    auto data = make_user_strings(2000);
+    auto col = make_column(data);
+    auto back = roundtrip(col);
+    ASSERT_NE(back.statistics(), nullptr);
+    const auto& a = *col.statistics();
+    const auto& b = *back.statistics();
+    EXPECT_EQ(a.num_strings, b.num_strings);
+    EXPECT_EQ(a.total_bytes, b.total_bytes);
+    EXPECT_EQ(a.min_length, b.min_length);
+    EXPECT_EQ(a.max_length, b.max_length);
+    EXPECT_EQ(a.empty_count, b.empty_count);
+    EXPECT_EQ(a.min_prefix, b.min_prefix);
+    EXPECT_EQ(a.max_prefix, b.max_prefix);
+    EXPECT_EQ(a.min_exact, b.min_exact);
+    EXPECT_EQ(a.max_exact, b.max_exact);
+    EXPECT_EQ(a.token_count_histogram, b.token_count_histogram);
+    EXPECT_EQ(a.token_frequency, b.token_frequency);
+    EXPECT_EQ(a.distinct_estimate(), b.distinct_estimate());
+    EXPECT_EQ(back.view().equals("user_000123"), col.view().equals("user_000123"));
+}
+
+TEST(StatisticsTest, FormatVersionDependsOnSections) {
+    auto data = make_user_strings(10);
+    std::stringstream plain, with_stats;
+    make_column(data, false).write_to(plain);
+    make_column(data, true).write_to(with_stats);
+    EXPECT_EQ(plain.str().substr(0, 8), "ONPAIR01");
+    EXPECT_EQ(with_stats.str().substr(0, 8), "ONPAIR02");
+    EXPECT_EQ(roundtrip(make_column(data, false)).statistics(), nullptr);
+}
+
+TEST(StatisticsTest, UnknownSectionsAreSkipped) {
+    auto data = make_user_strings(10);
+    std::stringstream ss;
+    make_column(data).write_to(ss);
+    std::string blob = ss.str();
+
+    // Replace the end marker with an unknown section followed by a new one.
+    blob.resize(blob.size() - 4);
+    const uint32_t tag = 0xBEEF, end = 0;
+    const uint64_t len = 3;
+    blob.append(reinterpret_cast<const char*>(&tag), 4);
+    blob.append(reinterpret_cast<const char*>(&len), 8);
+    blob.append("xyz");
+    blob.append(reinterpret_cast<const char*>(&end), 4);
+
+    std::stringstream in(blob);
+    auto col = op::OnPairColumn::read_from(in);
+    ASSERT_NE(col.statistics(), nullptr);
+    EXPECT_EQ(col.num_strings(), 10u);
+}
+
+TEST(StatisticsTest, TruncatedSectionThrows) {
+    auto data = make_user_strings(10);
+    std::stringstream ss;
+    make_column(data).write_to(ss);
+    std::string blob = ss.str();
+    blob.resize(blob.size() - 100);
+    std::stringstream in(blob);
+    EXPECT_THROW(op::OnPairColumn::read_from(in), std::runtime_error);
+}
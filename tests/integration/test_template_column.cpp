@@ -0,0 +1,148 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+using namespace test_helpers;
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+static op::TemplateColumn::Config make_config(op::BitWidth bits = 12) {
+    op::TemplateColumn::Config cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return cfg;
+}
+
+// Order ids, user ids, and some free text that fits no template.
+static std::vector<std::string> make_ids(int n) {
+    std::vector<std::string> out;
+    const auto text = make_random_strings(n / 10 + 1, 20, 5);
+    for (int i = 0; i < n; ++i) {
+        char buf[40];
+        switch (i % 10) {
+        case 0:  out.push_back(text[size_t(i / 10)]); break;
+        case 1: case 2: case 3:
+            std::snprintf(buf, sizeof buf, "ORD-%d-%07d", 2021 + i % 3, (i * 7919) % 10000000);
+            out.push_back(buf);
+            break;
+        default:
+            std::snprintf(buf, sizeof buf, "user_%06d", (i * 31) % 1000000);
+            out.push_back(buf);
+        }
+    }
+    return out;
+}
+
+template<typename Pred>
+static std::vector<size_t> brute(const std::vector<std::string>& rows, Pred pred) {
+    std::vector<size_t> out;
+    for (size_t i = 0; i < rows.size(); ++i)
+        if (pred(rows[i])) out.push_back(i);
+    return out;
+}
+
+// ── Round trip ────────────────────────────────────────────────────────────────
+
+TEST(TemplateColumnTest, RoundTrip) {
+    const auto rows = make_ids(5000);
+    const auto col  = op::TemplateColumn::compress(rows, make_config());
+    ASSERT_EQ(col.num_strings(), rows.size());
+    EXPECT_GE(col.num_templates(), 2u);
+    EXPECT_EQ(col.fallback().num_strings(), 500u);
+
+    std::vector<char> buf(256 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < rows.size(); ++i)
+        ASSERT_EQ(std::string(buf.data(), col.decompress(i, buf.data())), rows[i]) << i;
+
+    size_t total = 0;
+    for (const auto& r : rows) total += r.size();
+    std::vector<char>     all(total + op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offs(rows.size() + 1);
+    EXPECT_EQ(col.decompress_all(all.data(), offs.data()), total);
+    for (size_t i = 0; i < rows.size(); ++i)
+        ASSERT_EQ(std::string(all.data() + offs[i], offs[i + 1] - offs[i]), rows[i]);
+}
+
+TEST(TemplateColumnTest, SmallerThanTokensForIds) {
+    std::vector<std::string> rows;
+    for (int i = 0; i < 50000; ++i) {
+        char buf[32];
+        std::snprintf(buf, sizeof buf, "user_%06d", (i * 7919) % 1000000);
+        rows.push_back(buf);
+    }
+    const auto tc = op::TemplateColumn::compress(rows, make_config());
+    const auto oc = op::OnPairColumn::compress(rows, make_config());
+    EXPECT_EQ(tc.num_templates(), 1u);
+    EXPECT_EQ(tc.fallback().num_strings(), 0u);
+    EXPECT_LT(tc.bytes_used() * 2, oc.bytes_used());
+}
+
+TEST(TemplateColumnTest, NoTemplates) {
+    const auto rows = make_random_strings(300, 30, 9);
+    op::encoding::TemplateConfig tcfg;
+    tcfg.max_templates = 0;
+    const auto col = op::TemplateColumn::compress(rows, make_config(), tcfg);
+    EXPECT_EQ(col.num_templates(), 0u);
+    std::vector<char> buf(64 + op::DECOMPRESS_BUFFER_PADDING);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(col.template_of(i), op::TemplateColumn::NO_TEMPLATE);
+        ASSERT_EQ(std::string(buf.data(), col.decompress(i, buf.data())), rows[i]);
+    }
+    EXPECT_EQ(col.equals(rows[7]), brute(rows, [&](const std::string& s) { return s == rows[7]; }));
+}
+
+// ── Predicates ────────────────────────────────────────────────────────────────
+
+TEST(TemplateColumnTest, EqualsMatchesBruteForce) {
+    const auto rows = make_ids(4000);
+    const auto col  = op::TemplateColumn::compress(rows, make_config());
+    for (size_t i : {0u, 1u, 4u, 1234u, 3999u}) {
+        const std::string& q = rows[i];
+        EXPECT_EQ(col.equals(q), brute(rows, [&](const std::string& s) { return s == q; })) << q;
+    }
+    EXPECT_TRUE(col.equals("user_999999x").empty());
+    EXPECT_TRUE(col.equals("user_9999999").empty());
+    EXPECT_TRUE(col.equals("ORD-1999-0000001").empty());
+}
+
+TEST(TemplateColumnTest, StartsWithMatchesBruteForce) {
+    const auto rows = make_ids(4000);
+    const auto col  = op::TemplateColumn::compress(rows, make_config());
+    for (std::string_view p : {"", "u", "user_", "user_0", "user_00", "user_0012",
+                               "user_001240", "user_0012400", "ORD-", "ORD-2022",
+                               "ORD-2022-", "ORD-2022-00", "ORD-20", "ORD-2022x",
+                               "x", rows[0].substr(0, 3).c_str()}) {
+        EXPECT_EQ(col.starts_with(p),
+                  brute(rows, [&](const std::string& s) { return s.starts_with(p); }))
+            << "prefix '" << p << "'";
+    }
+}
+
+TEST(TemplateColumnTest, VariableWidthPrefixAndRange) {
+    std::vector<std::string> rows;
+    for (int i = 0; i < 3000; ++i) rows.push_back("item_" + std::to_string(i * 7));
+    const auto col = op::TemplateColumn::compress(rows, make_config());
+    ASSERT_EQ(col.num_templates(), 1u);
+    EXPECT_EQ(col.templates()[0].pattern(), "item_{}");
+
+    for (std::string_view p : {"item_1", "item_0", "item_20", "item_700", "item_1x"})
+        EXPECT_EQ(col.starts_with(p),
+                  brute(rows, [&](const std::string& s) { return s.starts_with(p); }))
+            << p;
+
+    EXPECT_EQ(col.field_between(0, 0, 100, 200),
+              brute(rows, [](const std::string& s) {
+                  const auto v = std::stoull(s.substr(5));
+                  return v >= 100 && v <= 200;
+              }));
+    EXPECT_TRUE(col.field_between(0, 0, 5, 4).empty());
+    EXPECT_THROW(col.field_between(1, 0, 0, 1), std::out_of_range);
+    EXPECT_THROW(col.field_between(0, 1, 0, 1), std::out_of_range);
+}
@@ -0,0 +1,159 @@
+#include <onpair/api.h>
+#include <onpair/search/byte_scan.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::vector<size_t> brute_force(const std::vector<std::string>& data,
+                                       std::string_view needle)
+{
+    std::vector<size_t> r;
+    for (size_t i = 0; i < data.size(); ++i)
+        if (data[i].find(needle) != std::string::npos) r.push_back(i);
+    return r;
+}
+
+static size_t find(std::string_view hay, std::string_view needle) {
+    return search::detail::find_bytes(
+        reinterpret_cast<const uint8_t*>(hay.data()), hay.size(),
+        reinterpret_cast<const uint8_t*>(needle.data()), needle.size());
+}
+
+// ── find_bytes ────────────────────────────────────────────────────────────────
+
+TEST(FindBytesTest, SingleByte) {
+    EXPECT_EQ(find("hello", "l"), 2u);
+    EXPECT_EQ(find("hello", "z"), search::detail::NPOS);
+}
+
+TEST(FindBytesTest, NeedleLongerThanHaystack) {
+    EXPECT_EQ(find("ab", "abc"), search::detail::NPOS);
+}
+
+TEST(FindBytesTest, AgreesWithStringFindAcrossVectorWidths) {
+    // Lengths straddle the 32-byte vector step and the scalar tail.
+    std::string hay;
+    for (int i = 0; i < 200; ++i) hay.push_back(char('a' + i % 7));
+    for (std::string_view needle : {"ab", "gab", "fgabcdefg", "abcdefgabcdefgabcdefgabcdefgabcdefg",
+                                    "xyz", "gg"}) {
+        for (size_t len = 0; len <= hay.size(); len += 13) {
+            std::string_view h(hay.data(), len);
+            const size_t expect = h.find(needle);
+            EXPECT_EQ(find(h, needle),
+                      expect == std::string_view::npos ? search::detail::NPOS : expect)
+                << needle << " len=" << len;
+        }
+    }
+}
+
+TEST(FindBytesTest, MatchAtVeryEnd) {
+    std::string hay(100, 'a');
+    hay += "needle";
+    EXPECT_EQ(find(hay, "needle"), 100u);
+}
+
+// ── Equivalence with the token engine ─────────────────────────────────────────
+
+class ByteScanBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, ByteScanBitsTest,
+    testing::Values(9, 10, 11, 12, 13, 14, 15, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(ByteScanBitsTest, MatchesKmpScan) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto data = make_mixed_length_strings(1500, 80, 11);
+    auto users = make_user_strings(700);
+    data.insert(data.end(), users.begin(), users.end());
+
+    auto col = make_column(data, bits);
+    auto v = col.view();
+
+    for (std::string_view p : {"a", "~", "ab", "00", "user_0004", "user_", "@example", "zzzzzzzz"}) {
+        search::KmpAutomaton kmp(p, v.dictionary());
+        EXPECT_EQ(v.contains_bytes(p), v.scan(kmp)) << p;
+        EXPECT_EQ(v.contains_bytes(p), brute_force(data, p)) << p;
+    }
+}
+
+// ── Row boundaries ────────────────────────────────────────────────────────────
+
+TEST(ByteScanTest, HitsStraddlingRowsAreDiscarded) {
+    std::vector<std::string> data = {"xxab", "cdyy", "abcd", "ab", "cd"};
+    auto col = make_column(data);
+    auto v = col.view();
+    EXPECT_EQ(v.contains_bytes("abcd"), (std::vector<size_t>{2}));
+    EXPECT_EQ(v.contains_bytes("bc"),   (std::vector<size_t>{2}));
+}
+
+TEST(ByteScanTest, EmptyRowsAndEmptyNeedle) {
+    std::vector<std::string> data = {"", "x", "", "xx", ""};
+    auto col = make_column(data);
+    auto v = col.view();
+    EXPECT_EQ(v.contains_bytes("x"), (std::vector<size_t>{1, 3}));
+    EXPECT_EQ(v.contains_bytes(""),  (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(ByteScanTest, RowLongerThanBlock) {
+    std::vector<std::string> data = {"short", std::string(200000, 'q') + "tail", "q", "tail"};
+    data[1][123456] = '!';
+    auto col = make_column(data);
+    auto v = col.view();
+    EXPECT_GT(v.store().num_tokens(), search::detail::SCAN_BLOCK_TOKENS);
+    EXPECT_EQ(v.contains_bytes("!"),    (std::vector<size_t>{1}));
+    EXPECT_EQ(v.contains_bytes("tail"), (std::vector<size_t>{1, 3}));
+    EXPECT_EQ(v.contains_bytes("q"),    (std::vector<size_t>{1, 2}));
+}
+
+TEST(ByteScanTest, ManyBlocks) {
+    auto data = make_user_strings(5000);   // > SCAN_BLOCK_ROWS rows
+    auto col = make_column(data);
+    auto v = col.view();
+    EXPECT_EQ(v.contains_bytes("user_00042"), brute_force(data, "user_00042"));
+    EXPECT_EQ(v.contains_bytes("9"), brute_force(data, "9"));
+}
+
+TEST(ByteScanTest, EmptyColumn) {
+    std::vector<std::string> data;
+    auto col = make_column(data);
+    EXPECT_TRUE(col.view().contains_bytes("a").empty());
+}
+
+// ── contains() dispatch ───────────────────────────────────────────────────────
+
+TEST(ByteScanTest, ContainsAgreesWithBothEngines) {
+    auto data = make_random_strings(3000, 40, 5);
+    auto col = make_column(data, 12);
+    auto v = col.view();
+    for (std::string_view p : {"", "a", "ab", "abc", "random"}) {
+        search::KmpAutomaton kmp(p, v.dictionary());
+        EXPECT_EQ(v.contains(p), v.scan(kmp)) << p;
+        EXPECT_EQ(v.contains(p), v.contains_bytes(p)) << p;
+    }
+}
+
+TEST(ByteScanTest, ShortNeedlesStayOnTokenEngine) {
+    auto data = make_user_strings(200);
+    auto col = make_column(data);
+    auto dv = col.view().dictionary();
+    for (std::string_view p : {"", "u", "_0"}) {
+        search::KmpAutomaton kmp(p, dv);
+        EXPECT_EQ(search::choose_contains_engine(p, dv, kmp),
+                  search::ContainsEngine::tokens) << p;
+    }
+}
@@ -0,0 +1,168 @@
+#include <onpair/api.h>
+#include <onpair/search/conjunction.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::vector<size_t> intersect(const std::vector<size_t>& a,
+                                     const std::vector<size_t>& b)
+{
+    std::vector<size_t> out;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(out));
+    return out;
+}
+
+// Paired columns: a = random text, b = one of a few categories.
+struct Table {
+    std::vector<std::string> a, b;
+};
+
+static Table make_table(int n) {
+    Table t;
+    t.a = make_random_strings(n, 24, 17);
+    const char* cats[] = {"red", "green", "blue", "cyan"};
+    for (int i = 0; i < n; ++i) t.b.push_back(cats[(i * 7) % 4]);
+    return t;
+}
+
+// Forwards to `inner` and counts the rows it is driven over.
+template<typename A>
+struct Counting {
+    A&     inner;
+    size_t rows = 0;
+    void reset()              { inner.reset(); ++rows; }
+    void step(op::Token t)    { inner.step(t); }
+    bool is_accepted() const  { return inner.is_accepted(); }
+};
+
+// ─── Results ──────────────────────────────────────────────────────────────────
+
+TEST(Conjunction, MatchesIntersectionOfScans) {
+    const auto t = make_table(3000);
+    const auto ca = make_column(t.a), cb = make_column(t.b, 9);
+    const auto va = ca.view(), vb = cb.view();
+
+    search::KmpAutomaton kmp("a", va.dictionary());
+    search::EqAutomaton  eq("blue", vb.dictionary());
+    const auto expected = intersect(va.scan(kmp), vb.scan(eq));
+    ASSERT_FALSE(expected.empty());
+
+    search::Conjunction q(search::ColumnPredicate{va, kmp},
+                          search::ColumnPredicate{vb, eq});
+    EXPECT_EQ(q.scan(), expected);
+    q.set_order({1, 0});
+    EXPECT_EQ(q.scan(), expected);
+}
+
+TEST(Conjunction, ThreeColumnsEveryOrder) {
+    const auto t = make_table(1000);
+    const auto c = make_random_strings(1000, 10, 5);
+    const auto ca = make_column(t.a), cb = make_column(t.b), cc = make_column(c, 12);
+    const auto va = ca.view(), vb = cb.view(), vc = cc.view();
+
+    search::KmpAutomaton    kmp("e", va.dictionary());
+    search::EqAutomaton     eq("red", vb.dictionary());
+    search::PrefixAutomaton pre("!", vc.dictionary());
+    const auto expected =
+        intersect(intersect(va.scan(kmp), vb.scan(eq)), vc.scan(!pre));
+
+    // The negated prefix is a temporary, moved into its predicate.
+    search::Conjunction q(search::ColumnPredicate{va, kmp},
+                          search::ColumnPredicate{vb, eq},
+                          search::ColumnPredicate{vc, !pre});
+    std::vector<size_t> order = {0, 1, 2};
+    do {
+        q.set_order(order);
+        EXPECT_EQ(q.scan(), expected);
+    } while (std::next_permutation(order.begin(), order.end()));
+}
+
+TEST(Conjunction, SingleColumnEqualsScan) {
+    const auto data = make_user_strings(500);
+    const auto col  = make_column(data);
+    search::PrefixAutomaton pre("user_0001", col.view().dictionary());
+    search::Conjunction q(search::ColumnPredicate{col.view(), pre});
+    EXPECT_EQ(q.scan(), col.view().scan(pre));
+}
+
+TEST(Conjunction, ShortCircuitsInOrder) {
+    const auto t = make_table(200);
+    const auto ca = make_column(t.a), cb = make_column(t.b);
+    const auto va = ca.view(), vb = cb.view();
+
+    // "red" holds for a quarter of the rows; the counter sees only those.
+    search::EqAutomaton red("red", vb.dictionary());
+    search::KmpAutomaton any("", va.dictionary());
+    Counting<search::KmpAutomaton> counted{any};
+    search::Conjunction q(search::ColumnPredicate{vb, red},
+                          search::ColumnPredicate{va, counted});
+    const auto rows = q.scan();
+    EXPECT_EQ(rows, vb.scan(red));
+    EXPECT_EQ(counted.rows, rows.size());
+
+    // The other order drives the counter on every row.
+    counted.rows = 0;
+    q.set_order({1, 0});
+    EXPECT_EQ(q.scan(), rows);
+    EXPECT_EQ(counted.rows, 200u);
+}
+
+// ─── Nulls and deletions ──────────────────────────────────────────────────────
+
+TEST(Conjunction, SkipsRowsNullOrDeletedInAnyColumn) {
+    const auto t = make_table(300);
+    auto raw = make_raw(t.b);
+    std::vector<uint8_t> validity((t.b.size() + 7) / 8, 0xFF);
+    validity[0] = 0xFE;                                  // row 0 null in b
+    auto ca = make_column(t.a);
+    auto cb = op::OnPairColumn::compress(
+        reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        t.b.size(), validity.data());
+    ca.erase(std::vector<size_t>{4, 130});
+
+    const auto va = ca.view(), vb = cb.view();
+    search::KmpAutomaton all("", va.dictionary());      // accepts every row
+    search::KmpAutomaton all_b("", vb.dictionary());
+    search::Conjunction q(search::ColumnPredicate{va, all},
+                          search::ColumnPredicate{vb, all_b});
+    const auto rows = q.scan();
+    EXPECT_EQ(rows.size(), 300u - 3);
+    for (size_t r : {0, 4, 130})
+        EXPECT_FALSE(std::binary_search(rows.begin(), rows.end(), size_t(r))) << r;
+}
+
+// ─── Errors ───────────────────────────────────────────────────────────────────
+
+TEST(Conjunction, RejectsMismatchedColumnsAndBadOrder) {
+    const auto ca = make_column(make_user_strings(10));
+    const auto cb = make_column(make_user_strings(11));
+    search::EqAutomaton ea("user_000001", ca.view().dictionary());
+    search::EqAutomaton eb("user_000001", cb.view().dictionary());
+    EXPECT_THROW(search::Conjunction(search::ColumnPredicate{ca.view(), ea},
+                                     search::ColumnPredicate{cb.view(), eb}),
+                 std::invalid_argument);
+
+    search::Conjunction q(search::ColumnPredicate{ca.view(), ea},
+                          search::ColumnPredicate{ca.view(), ea});
+    EXPECT_THROW(q.set_order({0, 0}), std::invalid_argument);
+    EXPECT_THROW(q.set_order({0}), std::invalid_argument);
+    EXPECT_THROW(q.set_order({0, 2}), std::invalid_argument);
+}
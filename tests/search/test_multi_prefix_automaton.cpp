@@ -0,0 +1,137 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static std::vector<size_t> brute_force(const std::vector<std::string>& data,
+                                       const std::vector<std::string_view>& prefixes)
+{
+    std::vector<size_t> r;
+    for (size_t i = 0; i < data.size(); ++i)
+        for (auto p : prefixes)
+            if (std::string_view(data[i]).starts_with(p)) { r.push_back(i); break; }
+    return r;
+}
+
+// ── Concept satisfaction ──────────────────────────────────────────────────────
+
+TEST(MultiPrefixAutomatonTest, SatisfiesConcepts) {
+    static_assert(search::TokenAutomaton<search::MultiPrefixAutomaton>);
+    static_assert(search::DeadDetectable<search::MultiPrefixAutomaton>);
+    static_assert(search::Replicable<search::MultiPrefixAutomaton>);
+}
+
+// ── Equivalence with ORed PrefixAutomata ──────────────────────────────────────
+
+class MultiPrefixBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, MultiPrefixBitsTest,
+    testing::Values(9, 10, 11, 12, 13, 14, 15, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(MultiPrefixBitsTest, MatchesBruteForce) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto data = make_user_strings(2000);
+    auto mixed = make_mixed_length_strings(800, 60, 5);
+    data.insert(data.end(), mixed.begin(), mixed.end());
+    auto col = make_column(data, bits);
+    auto v = col.view();
+
+    std::vector<std::string_view> prefixes = {
+        "user_0001", "user_00199", "user_0015", "user_001", "a", "zz",
+        "user_000000", "nomatch_at_all", "user_0019"
+    };
+    EXPECT_EQ(v.starts_with_any(prefixes), brute_force(data, prefixes));
+
+    for (auto p : prefixes) {
+        std::vector<std::string_view> one = {p};
+        EXPECT_EQ(v.starts_with_any(one), v.starts_with(p)) << p;
+    }
+}
+
+TEST(MultiPrefixAutomatonTest, ManyPrefixes) {
+    auto data = make_user_strings(5000);
+    auto col = make_column(data);
+    auto v = col.view();
+
+    std::vector<std::string> owned;
+    for (int i = 0; i < 3000; i += 7) owned.push_back(data[i].substr(0, 6 + i % 6));
+    std::vector<std::string_view> prefixes(owned.begin(), owned.end());
+    EXPECT_EQ(v.starts_with_any(prefixes), brute_force(data, prefixes));
+}
+
+// ── Edge cases ────────────────────────────────────────────────────────────────
+
+TEST(MultiPrefixAutomatonTest, EmptyPrefixMatchesEverything) {
+    std::vector<std::string> data = {"", "a", "bc"};
+    auto col = make_column(data);
+    std::vector<std::string_view> prefixes = {"zz", ""};
+    EXPECT_EQ(col.view().starts_with_any(prefixes), (std::vector<size_t>{0, 1, 2}));
+}
+
+TEST(MultiPrefixAutomatonTest, NoPrefixesMatchesNothing) {
+    auto data = make_user_strings(10);
+    auto col = make_column(data);
+    std::vector<std::string_view> prefixes;
+    EXPECT_TRUE(col.view().starts_with_any(prefixes).empty());
+}
+
+TEST(MultiPrefixAutomatonTest, RowShorterThanPrefix) {
+    std::vector<std::string> data = {"ab", "abc", "abcd", "a"};
+    auto col = make_column(data);
+    std::vector<std::string_view> prefixes = {"abc", "abcde"};
+    EXPECT_EQ(col.view().starts_with_any(prefixes), (std::vector<size_t>{1, 2}));
+}
+
+TEST(MultiPrefixAutomatonTest, DuplicateAndNestedPrefixes) {
+    auto data = make_user_strings(300);
+    auto col = make_column(data);
+    std::vector<std::string_view> prefixes = {"user_0002", "user_0002", "user_00021"};
+    EXPECT_EQ(col.view().starts_with_any(prefixes), brute_force(data, prefixes));
+}
+
+// ── Matched-prefix reporting ──────────────────────────────────────────────────
+
+TEST(MultiPrefixAutomatonTest, ReportsAMatchingPrefix) {
+    auto data = make_user_strings(500);
+    auto mixed = make_random_strings(300, 20, 1);
+    data.insert(data.end(), mixed.begin(), mixed.end());
+    auto col = make_column(data);
+    std::vector<std::string_view> prefixes = {"user_0001", "user_00042", "a", "b", "user_0003"};
+
+    std::vector<size_t> rows;
+    col.view().starts_with_any(prefixes, [&](size_t row, uint32_t id) {
+        ASSERT_LT(id, prefixes.size());
+        EXPECT_TRUE(std::string_view(data[row]).starts_with(prefixes[id]))
+            << data[row] << " / " << prefixes[id];
+        rows.push_back(row);
+    });
+    EXPECT_EQ(rows, brute_force(data, prefixes));
+}
+
+TEST(MultiPrefixAutomatonTest, MatchedPrefixResetsPerRow) {
+    std::vector<std::string> data = {"foo", "bar"};
+    auto col = make_column(data);
+    std::vector<std::string_view> prefixes = {"fo"};
+    search::MultiPrefixAutomaton mpa(prefixes, col.view().dictionary());
+    EXPECT_EQ(mpa.matched_prefix(), search::MultiPrefixAutomaton::NO_MATCH);
+    EXPECT_EQ(col.view().scan(mpa), (std::vector<size_t>{0}));
+    mpa.reset();
+    EXPECT_EQ(mpa.matched_prefix(), search::MultiPrefixAutomaton::NO_MATCH);
+    EXPECT_EQ(mpa.num_prefixes(), 1u);
+}
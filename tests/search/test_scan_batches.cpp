@@ -0,0 +1,139 @@
+#include <onpair/api.h>
+#include <onpair/search/scan_batches.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+template<typename T>
+static std::vector<size_t> drain(op::Generator<T>& gen, std::vector<size_t>* sizes = nullptr) {
+    std::vector<size_t> rows;
+    while (gen.next()) {
+        const auto batch = gen.value();
+        if (sizes) sizes->push_back(batch.size());
+        rows.insert(rows.end(), batch.begin(), batch.end());
+    }
+    return rows;
+}
+
+// ─── Results ──────────────────────────────────────────────────────────────────
+
+TEST(ScanBatches, SameRowsAsScan) {
+    const auto data = make_random_strings(5000, 30, 8);
+    for (op::BitWidth bits : {9, 12, 16}) {
+        const auto col = make_column(data, bits);
+        const auto v   = col.view();
+        search::KmpAutomaton kmp("a", v.dictionary());
+        auto gen = search::scan_batches(v, kmp, 100);
+        EXPECT_EQ(drain(gen), v.scan(kmp)) << int(bits);
+    }
+}
+
+TEST(ScanBatches, BatchesAreFullExceptTheLast) {
+    const auto data = make_user_strings(1000);
+    const auto col  = make_column(data);
+    search::PrefixAutomaton pre("user_", col.view().dictionary());
+
+    std::vector<size_t> sizes;
+    auto gen = search::scan_batches(col.view(), pre, 64);
+    const auto rows = drain(gen, &sizes);
+    ASSERT_EQ(rows.size(), 1000u);
+    ASSERT_EQ(sizes.size(), 16u);
+    for (size_t k = 0; k + 1 < sizes.size(); ++k) EXPECT_EQ(sizes[k], 64u);
+    EXPECT_EQ(sizes.back(), 1000u - 15 * 64);
+    EXPECT_FALSE(gen.next());   // stays finished
+}
+
+TEST(ScanBatches, RangeForAndNoMatch) {
+    const auto data = make_user_strings(300);
+    const auto col  = make_column(data);
+    const auto v    = col.view();
+
+    // The combinator refers to `pre`, which outlives the loop.
+    search::PrefixAutomaton pre("user_0001", v.dictionary());
+    std::vector<size_t> rows;
+    for (auto batch : search::scan_batches(v, !pre, 32))
+        rows.insert(rows.end(), batch.begin(), batch.end());
+    EXPECT_EQ(rows, v.scan(!pre));
+    EXPECT_EQ(rows.size(), 300u - 100);
+
+    auto none = search::scan_batches(v, search::EqAutomaton("nobody", v.dictionary()));
+    EXPECT_FALSE(none.next());
+}
+
+// Two generators over one column advance independently.
+TEST(ScanBatches, InterleavedConsumers) {
+    const auto data = make_random_strings(4000, 20, 2);
+    const auto col  = make_column(data);
+    const auto v    = col.view();
+    search::KmpAutomaton ka("a", v.dictionary()), kb("b", v.dictionary());
+    auto ga = search::scan_batches(v, ka, 7);
+    auto gb = search::scan_batches(v, kb, 13);
+
+    std::vector<size_t> ra, rb;
+    bool more_a = true, more_b = true;
+    while (more_a || more_b) {
+        if (more_a && (more_a = ga.next())) ra.insert(ra.end(), ga.value().begin(), ga.value().end());
+        if (more_b && (more_b = gb.next())) rb.insert(rb.end(), gb.value().begin(), gb.value().end());
+    }
+    EXPECT_EQ(ra, v.scan(ka));
+    EXPECT_EQ(rb, v.scan(kb));
+}
+
+// A consumer may stop early; destroying the generator frees the frame.
+TEST(ScanBatches, AbandonedEarly) {
+    const auto data = make_user_strings(10000);
+    const auto col  = make_column(data);
+    search::PrefixAutomaton pre("user_", col.view().dictionary());
+    {
+        auto gen = search::scan_batches(col.view(), pre, 10);
+        ASSERT_TRUE(gen.next());
+        EXPECT_EQ(gen.value().front(), 0u);
+        ASSERT_TRUE(gen.next());
+        EXPECT_EQ(gen.value().front(), 10u);
+    }
+    auto moved = search::scan_batches(col.view(), pre, 10);
+    auto target = std::move(moved);
+    EXPECT_TRUE(target.next());
+    EXPECT_FALSE(moved.next());
+}
+
+TEST(ScanBatches, SkipsNullAndDeletedRows) {
+    const auto data = make_user_strings(300);
+    auto raw = make_raw(data);
+    std::vector<uint8_t> validity((data.size() + 7) / 8, 0xFF);
+    validity[2] = 0x0F;                                   // rows 20..23 null
+    auto col = op::OnPairColumn::compress(
+        reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        data.size(), validity.data());
+    col.erase(std::vector<size_t>{1, 299});
+
+    search::PrefixAutomaton pre("user_", col.view().dictionary());
+    auto gen = search::scan_batches(col.view(), pre, 50);
+    const auto rows = drain(gen);
+    EXPECT_EQ(rows.size(), 300u - 4 - 2);
+    EXPECT_EQ(rows, col.view().scan(pre));
+}
+
+TEST(ScanBatches, EmptyColumnAndBadBatch) {
+    const auto col = make_column({});
+    search::KmpAutomaton kmp("a", col.view().dictionary());
+    auto gen = search::scan_batches(col.view(), kmp);
+    EXPECT_FALSE(gen.next());
+    EXPECT_THROW(search::scan_batches(col.view(), kmp, 0), std::invalid_argument);
+}
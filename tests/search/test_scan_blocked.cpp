@@ -0,0 +1,118 @@
+#include <onpair/api.h>
+#include <onpair/search/automata/aho_corasick_lazy_automaton.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <string_view>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+// ── TokenSpanStream ───────────────────────────────────────────────────────────
+
+TEST(TokenSpanStreamTest, SatisfiesTokenStream) {
+    static_assert(search::TokenStream<search::TokenSpanStream>);
+}
+
+TEST(TokenSpanStreamTest, YieldsRangeInOrder) {
+    const op::Token toks[] = {5, 7, 9};
+    search::TokenSpanStream s{toks, toks + 3};
+    EXPECT_EQ(s.next(), 5);
+    EXPECT_EQ(s.next(), 7);
+    EXPECT_TRUE(s.has_more());
+    EXPECT_EQ(s.next(), 9);
+    EXPECT_FALSE(s.has_more());
+}
+
+// ── Equivalence with the sequential scan ──────────────────────────────────────
+
+class ScanBlockedBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, ScanBlockedBitsTest,
+    testing::Values(9, 10, 11, 12, 13, 14, 15, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(ScanBlockedBitsTest, MatchesScan) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto data = make_mixed_length_strings(3000, 80, 11);
+    auto users = make_user_strings(700);
+    data.insert(data.end(), users.begin(), users.end());
+
+    auto col = make_column(data, bits);
+    auto v = col.view();
+    auto dv = v.dictionary();
+
+    search::KmpAutomaton    kmp("user_0003", dv);
+    search::PrefixAutomaton pa("user_", dv);
+    search::EqAutomaton     eq(data[42], dv);
+    std::vector<std::string_view> pats = {"ab", "user_0006", "~~"};
+    search::AhoCorasickAutomaton     ac(pats, dv);
+    search::AhoCorasickLazyAutomaton lazy(pats, dv);
+
+    EXPECT_EQ(v.scan_blocked(kmp),  v.scan(kmp));
+    EXPECT_EQ(v.scan_blocked(pa),   v.scan(pa));
+    EXPECT_EQ(v.scan_blocked(eq),   v.scan(eq));
+    EXPECT_EQ(v.scan_blocked(ac),   v.scan(ac));
+    EXPECT_EQ(v.scan_blocked(lazy), v.scan(lazy));
+}
+
+TEST(ScanBlockedTest, AcceptsCombinatorTemporaries) {
+    auto data = make_user_strings(300);
+    auto col = make_column(data);
+    auto v = col.view();
+    search::KmpAutomaton a("user_0001", v.dictionary());
+    search::KmpAutomaton b("5", v.dictionary());
+    EXPECT_EQ(v.scan_blocked(a && !b), v.scan(a && !b));
+}
+
+// ── Block boundaries ──────────────────────────────────────────────────────────
+
+// Rows longer than one block fall back to the packed-stream cursor; rows
+// around them must still be unpacked correctly.
+TEST(ScanBlockedTest, RowsLongerThanBlock) {
+    std::vector<std::string> data;
+    for (int i = 0; i < 50; ++i) data.push_back("short_" + std::to_string(i));
+    std::string huge;
+    for (int i = 0; i < 20000; ++i) huge += char('a' + (i * 7919) % 26);
+    data.push_back(huge + "needle");
+    data.push_back("needle");
+    data.push_back(huge);
+    for (int i = 0; i < 50; ++i) data.push_back("tail_" + std::to_string(i));
+
+    auto col = make_column(data, 9);   // 9 bits → many tokens per huge row
+    auto v = col.view();
+    search::KmpAutomaton kmp("needle", v.dictionary());
+    EXPECT_EQ(v.scan_blocked(kmp), v.scan(kmp));
+    EXPECT_EQ(v.scan_blocked(kmp), (std::vector<size_t>{50, 51}));
+}
+
+TEST(ScanBlockedTest, ManyBlocks) {
+    auto data = make_random_strings(20000, 30, 5);
+    auto col = make_column(data, 12);
+    auto v = col.view();
+    search::KmpAutomaton kmp("ab", v.dictionary());
+    EXPECT_EQ(v.scan_blocked(kmp), v.scan(kmp));
+}
+
+TEST(ScanBlockedTest, EmptyRowsAndEmptyColumn) {
+    std::vector<std::string> data = {"", "", "x", ""};
+    auto col = make_column(data);
+    auto v = col.view();
+    search::EqAutomaton eq("", v.dictionary());
+    EXPECT_EQ(v.scan_blocked(eq), (std::vector<size_t>{0, 1, 3}));
+
+    std::vector<std::string> none;
+    auto empty = make_column(none);
+    search::EqAutomaton eq2("", empty.view().dictionary());
+    EXPECT_TRUE(empty.view().scan_blocked(eq2).empty());
+}
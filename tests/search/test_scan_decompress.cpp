@@ -0,0 +1,112 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <string>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+static size_t total_bytes(const std::vector<std::string>& data) {
+    size_t n = 0;
+    for (const auto& s : data) n += s.size();
+    return n;
+}
+
+struct Fused {
+    std::vector<std::string> rows;
+    std::vector<size_t>      ids;
+};
+
+template<typename A>
+static Fused run_fused(const op::OnPairColumnView& v, A&& aut, size_t bytes) {
+    std::vector<char>     buf(bytes + op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offs(v.num_strings() + 1);
+    std::vector<size_t>   ids(v.num_strings());
+    const size_t m = v.scan_decompress(aut, buf.data(), offs.data(), ids.data());
+    Fused f;
+    EXPECT_EQ(offs[0], 0u);
+    for (size_t k = 0; k < m; ++k)
+        f.rows.emplace_back(buf.data() + offs[k], offs[k + 1] - offs[k]);
+    f.ids.assign(ids.begin(), ids.begin() + m);
+    return f;
+}
+
+static std::vector<std::string> pick(const std::vector<std::string>& data,
+                                     const std::vector<size_t>& ids)
+{
+    std::vector<std::string> out;
+    for (size_t i : ids) out.push_back(data[i]);
+    return out;
+}
+
+// ─── Results ──────────────────────────────────────────────────────────────────
+
+TEST(ScanDecompress, MatchesScanThenDecompress) {
+    const auto data = make_random_strings(3000, 40, 3);
+    for (op::BitWidth bits : {9, 12, 16}) {
+        const auto col = make_column(data, bits);
+        const auto v   = col.view();
+        search::KmpAutomaton kmp("a", v.dictionary());
+        const auto f = run_fused(v, kmp, total_bytes(data));
+        EXPECT_EQ(f.ids, v.scan(kmp)) << int(bits);
+        EXPECT_EQ(f.rows, pick(data, f.ids)) << int(bits);
+    }
+}
+
+// KMP dies at the first occurrence; the row must still come out whole.
+TEST(ScanDecompress, EarlyExitRowsAreComplete) {
+    std::vector<std::string> data;
+    for (int i = 0; i < 500; ++i)
+        data.push_back("needle" + std::string(size_t(i % 90), 'x') + std::to_string(i));
+    const auto col = make_column(data);
+    const auto v   = col.view();
+    search::KmpAutomaton kmp("needle", v.dictionary());
+    const auto f = run_fused(v, kmp, total_bytes(data));
+    EXPECT_EQ(f.rows, data);
+}
+
+TEST(ScanDecompress, CombinatorsAndNoMatch) {
+    const auto data = make_user_strings(1000);
+    const auto col  = make_column(data);
+    const auto v    = col.view();
+    search::PrefixAutomaton pre("user_0005", v.dictionary());
+    const auto f = run_fused(v, !pre, total_bytes(data));
+    EXPECT_EQ(f.ids, v.scan(!pre));
+    EXPECT_EQ(f.rows, pick(data, f.ids));
+
+    search::EqAutomaton none("nobody", v.dictionary());
+    std::vector<char>     buf(op::DECOMPRESS_BUFFER_PADDING);
+    std::vector<uint32_t> offs(1, 123);
+    EXPECT_EQ(v.scan_decompress(none, buf.data(), offs.data()), 0u);
+    EXPECT_EQ(offs[0], 0u);
+}
+
+TEST(ScanDecompress, SkipsNullAndDeletedRows) {
+    const auto data = make_user_strings(200);
+    auto raw = make_raw(data);
+    std::vector<uint8_t> validity((data.size() + 7) / 8, 0xFF);
+    validity[1] = 0x00;                                   // rows 8..15 null
+    auto col = op::OnPairColumn::compress(
+        reinterpret_cast<const char*>(raw.data.data()), raw.offsets.data(),
+        data.size(), validity.data());
+    col.erase(std::vector<size_t>{0, 100});
+
+    const auto v = col.view();
+    search::PrefixAutomaton pre("user_", v.dictionary());
+    const auto f = run_fused(v, pre, total_bytes(data));
+    EXPECT_EQ(f.ids.size(), 200u - 8 - 2);
+    EXPECT_EQ(f.ids, v.scan(pre));
+    EXPECT_EQ(f.rows, pick(data, f.ids));
+}
@@ -0,0 +1,138 @@
+#include <onpair/api.h>
+#include <onpair/search/automata/aho_corasick_lazy_automaton.h>
+#include <onpair/search/automata/aho_corasick_online_automaton.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <string_view>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+// ── Concept satisfaction ──────────────────────────────────────────────────────
+
+TEST(ScanInterleavedTest, AutomataAreReplicable) {
+    static_assert(search::Replicable<search::KmpAutomaton>);
+    static_assert(search::Replicable<search::PrefixAutomaton>);
+    static_assert(search::Replicable<search::EqAutomaton>);
+    static_assert(search::Replicable<search::AhoCorasickAutomaton>);
+    static_assert(search::Replicable<search::AhoCorasickLazyAutomaton>);
+    static_assert(search::Replicable<search::AhoCorasickOnlineAutomaton>);
+}
+
+TEST(ScanInterleavedTest, CombinatorsAreNotReplicable) {
+    using K = search::KmpAutomaton;
+    static_assert(!search::Replicable<search::NegatedAutomaton<K>>);
+    static_assert(!search::Replicable<search::AndAutomaton<K, K>>);
+    static_assert(!search::Replicable<search::OrAutomaton<K, K>>);
+}
+
+// ── Equivalence with the sequential scan ──────────────────────────────────────
+
+class ScanInterleavedBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, ScanInterleavedBitsTest,
+    testing::Values(9, 10, 11, 12, 13, 14, 15, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(ScanInterleavedBitsTest, MatchesScanForEveryAutomatonType) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto data = make_mixed_length_strings(1003, 60, 7);
+    auto users = make_user_strings(500);
+    data.insert(data.end(), users.begin(), users.end());
+
+    auto col = make_column(data, bits);
+    auto v = col.view();
+    auto dv = v.dictionary();
+
+    search::KmpAutomaton    kmp("user_0001", dv);
+    search::PrefixAutomaton pa("user_00", dv);
+    search::EqAutomaton     eq(data[17], dv);
+    std::vector<std::string_view> pats = {"ab", "user_0004", "~"};
+    search::AhoCorasickAutomaton       ac(pats, dv);
+    search::AhoCorasickLazyAutomaton   lazy(pats, dv);
+    search::AhoCorasickOnlineAutomaton online(pats, dv);
+
+    EXPECT_EQ(v.scan_interleaved(kmp),    v.scan(kmp));
+    EXPECT_EQ(v.scan_interleaved(pa),     v.scan(pa));
+    EXPECT_EQ(v.scan_interleaved(eq),     v.scan(eq));
+    EXPECT_EQ(v.scan_interleaved(ac),     v.scan(ac));
+    EXPECT_EQ(v.scan_interleaved(lazy),   v.scan(lazy));
+    EXPECT_EQ(v.scan_interleaved(online), v.scan(online));
+}
+
+// ── Lane counts and batch tails ───────────────────────────────────────────────
+
+TEST(ScanInterleavedTest, LaneCountsAgree) {
+    auto data = make_user_strings(203);   // not a multiple of any K below
+    auto col = make_column(data);
+    auto v = col.view();
+    search::KmpAutomaton kmp("00", v.dictionary());
+
+    const auto expected = v.scan(kmp);
+    EXPECT_EQ(v.scan_interleaved<1>(kmp),  expected);
+    EXPECT_EQ(v.scan_interleaved<3>(kmp),  expected);
+    EXPECT_EQ(v.scan_interleaved<4>(kmp),  expected);
+    EXPECT_EQ(v.scan_interleaved<16>(kmp), expected);
+    EXPECT_EQ(v.scan_interleaved<32>(kmp), expected);
+}
+
+TEST(ScanInterleavedTest, FewerRowsThanLanes) {
+    std::vector<std::string> data = {"alpha", "beta", "alphabet"};
+    auto col = make_column(data);
+    auto v = col.view();
+    search::KmpAutomaton kmp("alpha", v.dictionary());
+    EXPECT_EQ(v.scan_interleaved(kmp), (std::vector<size_t>{0, 2}));
+}
+
+TEST(ScanInterleavedTest, EmptyRowsInsideBatch) {
+    std::vector<std::string> data = {"", "x", "", "", "xx", "", "y", "", "x", ""};
+    auto col = make_column(data);
+    auto v = col.view();
+
+    search::EqAutomaton empty_eq("", v.dictionary());
+    EXPECT_EQ(v.scan_interleaved(empty_eq), v.scan(empty_eq));
+
+    search::KmpAutomaton kmp("x", v.dictionary());
+    EXPECT_EQ(v.scan_interleaved(kmp), (std::vector<size_t>{1, 4, 8}));
+}
+
+TEST(ScanInterleavedTest, EmptyColumn) {
+    std::vector<std::string> data;
+    auto col = make_column(data);
+    auto v = col.view();
+    search::KmpAutomaton kmp("a", v.dictionary());
+    EXPECT_TRUE(v.scan_interleaved(kmp).empty());
+}
+
+TEST(ScanInterleavedTest, PrototypeIsNotMutated) {
+    std::vector<std::string> data = {"abc", "xabc", "zzz"};
+    auto col = make_column(data);
+    auto v = col.view();
+    search::KmpAutomaton kmp("abc", v.dictionary());
+    kmp.reset();
+    v.scan_interleaved(kmp);
+    EXPECT_FALSE(kmp.is_accepted());
+}
+
+TEST(ScanInterleavedTest, CallbackOrderIsAscending) {
+    auto data = make_random_strings(777, 12, 3);
+    auto col = make_column(data);
+    auto v = col.view();
+    search::KmpAutomaton kmp("a", v.dictionary());
+
+    std::vector<size_t> seen;
+    v.scan_interleaved(kmp, [&](size_t i) { seen.push_back(i); });
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+    EXPECT_EQ(seen, v.scan(kmp));
+}
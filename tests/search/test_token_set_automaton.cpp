@@ -0,0 +1,192 @@
+#include <onpair/api.h>
+#include <gtest/gtest.h>
+#include "corpus.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace op = onpair;
+namespace search = onpair::search;
+using namespace test_helpers;
+
+static op::OnPairColumn make_column(const std::vector<std::string>& strings,
+                                    op::BitWidth bits = 14)
+{
+    op::encoding::TrainingConfig cfg;
+    cfg.bits = bits;
+    cfg.seed = 42;
+    return op::OnPairColumn::compress(strings, cfg);
+}
+
+template<typename P>
+static std::vector<size_t> brute_force(const std::vector<std::string>& data, P pred) {
+    std::vector<size_t> r;
+    for (size_t i = 0; i < data.size(); ++i)
+        for (char c : data[i])
+            if (pred(static_cast<uint8_t>(c))) { r.push_back(i); break; }
+    return r;
+}
+
+static bool is_digit(uint8_t b)     { return b >= '0' && b <= '9'; }
+static bool is_non_ascii(uint8_t b) { return b >= 0x80; }
+
+// ── Concept satisfaction ──────────────────────────────────────────────────────
+
+TEST(TokenSetAutomatonTest, SatisfiesConcepts) {
+    static_assert(search::TokenAutomaton<search::TokenSetAutomaton>);
+    static_assert(search::DeadDetectable<search::TokenSetAutomaton>);
+    static_assert(search::Replicable<search::TokenSetAutomaton>);
+}
+
+// ── Membership bitmap ─────────────────────────────────────────────────────────
+
+TEST(TokenSetAutomatonTest, MembershipFollowsTokenBytes) {
+    auto col = make_column(make_user_strings(300));
+    auto dv = col.view().dictionary();
+    search::TokenSetAutomaton set(is_digit, dv);
+
+    size_t members = 0;
+    for (size_t t = 0; t < dv.num_tokens(); ++t) {
+        const auto tok = static_cast<op::Token>(t);
+        bool expect = false;
+        for (size_t k = 0; k < dv.token_size(tok); ++k)
+            expect |= is_digit(dv.data(tok)[k]);
+        EXPECT_EQ(set.contains(tok), expect) << t;
+        members += expect;
+    }
+    EXPECT_EQ(set.member_count(), members);
+}
+
+TEST(TokenSetAutomatonTest, EmptyClassHasNoMembers) {
+    auto col = make_column(make_user_strings(50));
+    auto set = search::TokenSetAutomaton::any_of("", col.view().dictionary());
+    EXPECT_EQ(set.member_count(), 0u);
+    EXPECT_TRUE(col.view().scan_token_set(set).empty());
+}
+
+TEST(TokenSetAutomatonTest, StepStopsAtFirstMember) {
+    auto col = make_column(make_user_strings(50));
+    auto dv = col.view().dictionary();
+    auto set = search::TokenSetAutomaton::any_of("_", dv);
+    set.reset();
+    EXPECT_FALSE(set.is_dead());
+    set.step(search::detail::tokenize("a", dv)[0]);
+    EXPECT_FALSE(set.is_accepted());
+    set.step(search::detail::tokenize("_", dv)[0]);
+    EXPECT_TRUE(set.is_accepted());
+    EXPECT_TRUE(set.is_dead());
+    set.reset();
+    EXPECT_FALSE(set.is_accepted());
+}
+
+TEST(TokenSetAutomatonTest, FindFirstAcrossVectorWidths) {
+    auto col = make_column(make_user_strings(50));
+    auto dv = col.view().dictionary();
+    auto set = search::TokenSetAutomaton::any_of("#", dv);
+    const op::Token a    = search::detail::tokenize("a", dv)[0];
+    const op::Token hash = search::detail::tokenize("#", dv)[0];
+    std::vector<op::Token> toks(67, a);
+    EXPECT_EQ(set.find_first(toks.data(), toks.size()), toks.size());
+    for (size_t at : {0u, 3u, 4u, 7u, 8u, 31u, 64u, 66u}) {
+        auto t = toks;
+        t[at] = hash;
+        EXPECT_EQ(set.find_first(t.data(), t.size()), at);
+    }
+    EXPECT_EQ(set.find_first(toks.data(), 0), 0u);
+}
+
+// ── Column scans ──────────────────────────────────────────────────────────────
+
+class TokenSetBitsTest : public testing::TestWithParam<int> {};
+INSTANTIATE_TEST_SUITE_P(AllBitWidths, TokenSetBitsTest,
+    testing::Values(9, 10, 11, 12, 13, 14, 15, 16),
+    [](const auto& info) { return "bits" + std::to_string(info.param); });
+
+TEST_P(TokenSetBitsTest, AllScanPathsAgreeWithBruteForce) {
+    const auto bits = static_cast<op::BitWidth>(GetParam());
+    auto data = make_mixed_length_strings(1200, 80, 3);
+    auto bin = make_binary_strings(400, 30, 9);
+    auto users = make_user_strings(600);
+    data.insert(data.end(), bin.begin(), bin.end());
+    data.insert(data.end(), users.begin(), users.end());
+
+    auto col = make_column(data, bits);
+    auto v = col.view();
+    auto dv = v.dictionary();
+
+    search::TokenSetAutomaton digits(is_digit, dv);
+    search::TokenSetAutomaton high(is_non_ascii, dv);
+    auto at = search::TokenSetAutomaton::any_of("@", dv);
+
+    for (auto* set : {&digits, &high, &at}) {
+        const auto expected = v.scan(*set);
+        EXPECT_EQ(v.scan_token_set(*set), expected);
+        EXPECT_EQ(v.scan_blocked(*set),   expected);
+    }
+    EXPECT_EQ(v.scan(digits), brute_force(data, is_digit));
+    EXPECT_EQ(v.scan(high),   brute_force(data, is_non_ascii));
+    EXPECT_EQ(v.contains_byte_if(is_digit), brute_force(data, is_digit));
+}
+
+TEST(TokenSetAutomatonTest, SingleByteContainsMatchesKmp) {
+    auto data = make_random_strings(2000, 40, 17);
+    auto col = make_column(data, 12);
+    auto v = col.view();
+    for (std::string_view p : {"a", "z", "~", "\x01"}) {
+        search::KmpAutomaton kmp(p, v.dictionary());
+        EXPECT_EQ(v.contains(p), v.scan(kmp)) << p;
+    }
+}
+
+TEST(TokenSetAutomatonTest, RowLongerThanBlock) {
+    std::string big(100000, 'x');
+    std::vector<std::string> data = {"a1", big, big + "7", "", "9"};
+    auto col = make_column(data);
+    auto v = col.view();
+    EXPECT_GT(v.store().num_tokens(), search::detail::SCAN_BLOCK_TOKENS);
+    EXPECT_EQ(v.contains_byte_if(is_digit), (std::vector<size_t>{0, 2, 4}));
+}
+
+TEST(TokenSetAutomatonTest, EmptyRowsAndColumn) {
+    std::vector<std::string> data = {"", "", "x1", ""};
+    auto col = make_column(data);
+    EXPECT_EQ(col.view().contains_byte_if(is_digit), (std::vector<size_t>{2}));
+
+    std::vector<std::string> none;
+    auto empty = make_column(none);
+    EXPECT_TRUE(empty.view().contains_byte_if(is_digit).empty());
+}
+
+TEST(TokenSetAutomatonTest, EveryRowMatches) {
+    auto data = make_user_strings(3000);   // every row contains '_'
+    auto col = make_column(data);
+    auto hits = col.view().contains("_");
+    ASSERT_EQ(hits.size(), data.size());
+    for (size_t i = 0; i < hits.size(); ++i) EXPECT_EQ(hits[i], i);
+}
+
+// ── Engine selection ──────────────────────────────────────────────────────────
+
+TEST(TokenSetAutomatonTest, EngineFollowsMemberShare) {
+    auto col = make_column(make_user_strings(2000));
+    auto dv = col.view().dictionary();
+    EXPECT_EQ(search::choose_token_set_engine(search::TokenSetAutomaton::any_of("~", dv), dv),
+              search::TokenSetEngine::blocks);
+    EXPECT_EQ(search::choose_token_set_engine(search::TokenSetAutomaton(is_digit, dv), dv),
+              search::TokenSetEngine::rows);
+}
+
+TEST(TokenSetAutomatonTest, BothEnginesAgree) {
+    auto data = make_user_strings(2000);
+    auto more = make_random_strings(2000, 30, 5);
+    data.insert(data.end(), more.begin(), more.end());
+    auto col = make_column(data, 12);
+    auto v = col.view();
+    for (auto pred : {is_digit, is_non_ascii}) {
+        search::TokenSetAutomaton set(pred, v.dictionary());
+        EXPECT_EQ(v.contains_byte_if(pred), v.scan_token_set(set));
+        EXPECT_EQ(v.contains_byte_if(pred), v.scan(set));
+        EXPECT_EQ(v.contains_byte_if(pred), brute_force(data, pred));
+    }
+}